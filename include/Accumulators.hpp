@@ -0,0 +1,275 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <omp.h>
+
+// Shared double accumulators for code that adds from arbitrary call stacks
+// inside a parallel region, where a reduction clause cannot be used. add()
+// finds the caller's slot from omp_get_thread_num(), so an accumulator must be
+// built for at least as many threads as the team that uses it. total() is only
+// meaningful once every add() has returned (e.g. after the region's barrier).
+
+constexpr std::size_t cacheLineSize = 64;
+
+// a += value with a compare-and-swap loop (std::atomic<double> has no fetch_add before C++20).
+inline void atomicAddDouble(std::atomic<double>& target, double value) {
+    double expected = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(expected, expected + value, std::memory_order_relaxed, std::memory_order_relaxed)) {
+    }
+}
+
+// a = max(a, value); only stores when value is larger.
+inline void atomicMaxDouble(std::atomic<double>& target, double value) {
+    double expected = target.load(std::memory_order_relaxed);
+    while (value > expected && !target.compare_exchange_weak(expected, value, std::memory_order_relaxed, std::memory_order_relaxed)) {
+    }
+}
+
+// One slot per thread, each on its own cache line. A slot has a single writer,
+// so a relaxed load and store replace the read-modify-write.
+class PaddedSlotAccumulator {
+public:
+    explicit PaddedSlotAccumulator(int threadCount)
+        : slots(static_cast<std::size_t>(threadCount)) {
+    }
+
+    void add(double value) {
+        std::atomic<double>& slot = slots[static_cast<std::size_t>(omp_get_thread_num())].value;
+        slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    double total() const {
+        double sum = 0.0;
+        for (const PaddedSlot& slot : slots)
+            sum += slot.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+private:
+    struct alignas(cacheLineSize) PaddedSlot {
+        std::atomic<double> value { 0.0 };
+    };
+
+    std::vector<PaddedSlot> slots;
+};
+
+// The same per-thread slots packed next to each other: eight threads share a
+// cache line, which ping-pongs between their cores on every update.
+class FalseSharingAccumulator {
+public:
+    explicit FalseSharingAccumulator(int threadCount)
+        : slots(new std::atomic<double>[static_cast<std::size_t>(threadCount)]), slotCount(static_cast<std::size_t>(threadCount)) {
+        for (std::size_t i = 0; i < slotCount; ++i)
+            slots[i].store(0.0, std::memory_order_relaxed);
+    }
+
+    void add(double value) {
+        std::atomic<double>& slot = slots[static_cast<std::size_t>(omp_get_thread_num())];
+        slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    double total() const {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < slotCount; ++i)
+            sum += slots[i].load(std::memory_order_relaxed);
+        return sum;
+    }
+
+private:
+    std::unique_ptr<std::atomic<double>[]> slots;
+    std::size_t slotCount;
+};
+
+// A single shared value updated with a CAS loop.
+class CasAccumulator {
+public:
+    void add(double value) {
+        atomicAddDouble(sum, value);
+    }
+
+    double total() const {
+        return sum.load(std::memory_order_relaxed);
+    }
+
+private:
+    alignas(cacheLineSize) std::atomic<double> sum { 0.0 };
+};
+
+// stripeCount padded CAS cells; thread t updates stripe t % stripeCount, so
+// contention on each cell drops with the stripe count.
+class ShardedAccumulator {
+public:
+    explicit ShardedAccumulator(int stripeCount)
+        : stripes(static_cast<std::size_t>(stripeCount < 1 ? 1 : stripeCount)) {
+    }
+
+    void add(double value) {
+        atomicAddDouble(stripes[static_cast<std::size_t>(omp_get_thread_num()) % stripes.size()].value, value);
+    }
+
+    double total() const {
+        double sum = 0.0;
+        for (const Stripe& stripe : stripes)
+            sum += stripe.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+    std::size_t stripeCount() const {
+        return stripes.size();
+    }
+
+private:
+    struct alignas(cacheLineSize) Stripe {
+        std::atomic<double> value { 0.0 };
+    };
+
+    std::vector<Stripe> stripes;
+};
+
+// Software combining tree (Herlihy & Shavit, "The Art of Multiprocessor
+// Programming", ch. 12) with fetch-and-add of a double. The tree has width / 2
+// leaves for the next power of two width >= threadCount, and threads 2k and
+// 2k+1 share leaf k. When two updates meet at a node, the second one hands its
+// value to the first, which carries the combined value towards the root and
+// returns the second one's result on the way back down. Only one thread per
+// combined batch touches the root.
+class CombiningTreeAccumulator {
+public:
+    explicit CombiningTreeAccumulator(int threadCount) {
+        std::size_t width = 2;
+        while (width < static_cast<std::size_t>(threadCount))
+            width *= 2;
+        nodeCount = width - 1;
+        nodes.reset(new Node[nodeCount]);
+        nodes[0].status = Node::Status::root;
+        for (std::size_t i = 1; i < nodeCount; ++i)
+            nodes[i].parent = &nodes[(i - 1) / 2];
+    }
+
+    // Returns the total before this update was applied.
+    double add(double value) {
+        Node* leaf = &nodes[nodeCount - 1 - static_cast<std::size_t>(omp_get_thread_num()) / 2];
+
+        // Precombining: climb while this thread is the first to reach a node.
+        Node* node = leaf;
+        while (node->precombine())
+            node = node->parent;
+        Node* stop = node;
+
+        // Combining: collect the values of partners on the way up.
+        Node* path[64];
+        std::size_t depth = 0;
+        double combined = value;
+        for (node = leaf; node != stop; node = node->parent) {
+            combined = node->combine(combined);
+            path[depth++] = node;
+        }
+
+        const double prior = stop->operate(combined);
+
+        // Distribution: hand partners their results on the way down.
+        while (depth > 0)
+            path[--depth]->distribute(prior);
+        return prior;
+    }
+
+    double total() const {
+        return nodes[0].result;
+    }
+
+private:
+    struct alignas(cacheLineSize) Node {
+        enum class Status { idle, first, second, result, root };
+
+        bool precombine() {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return !locked; });
+            switch (status) {
+            case Status::idle:
+                status = Status::first;
+                return true;
+            case Status::first:
+                locked = true;
+                status = Status::second;
+                return false;
+            case Status::root:
+                return false;
+            default:
+                std::abort();
+            }
+        }
+
+        double combine(double combined) {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return !locked; });
+            locked = true;
+            firstValue = combined;
+            switch (status) {
+            case Status::first:
+                return firstValue;
+            case Status::second:
+                return firstValue + secondValue;
+            default:
+                std::abort();
+            }
+        }
+
+        double operate(double combined) {
+            std::unique_lock<std::mutex> lock(mutex);
+            switch (status) {
+            case Status::root: {
+                const double prior = result;
+                result += combined;
+                return prior;
+            }
+            case Status::second: {
+                secondValue = combined;
+                locked = false;
+                changed.notify_all();
+                changed.wait(lock, [this] { return status == Status::result; });
+                locked = false;
+                changed.notify_all();
+                status = Status::idle;
+                return result;
+            }
+            default:
+                std::abort();
+            }
+        }
+
+        void distribute(double prior) {
+            std::unique_lock<std::mutex> lock(mutex);
+            switch (status) {
+            case Status::first:
+                status = Status::idle;
+                locked = false;
+                break;
+            case Status::second:
+                result = prior + firstValue;
+                status = Status::result;
+                break;
+            default:
+                std::abort();
+            }
+            changed.notify_all();
+        }
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        Status status = Status::idle;
+        bool locked = false;
+        double firstValue = 0.0;
+        double secondValue = 0.0;
+        double result = 0.0;
+        Node* parent = nullptr;
+    };
+
+    std::unique_ptr<Node[]> nodes;
+    std::size_t nodeCount = 0;
+};
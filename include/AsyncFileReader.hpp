@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PT_HAS_PREAD 1
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define PT_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+// Positional file reads with several requests in flight, for streaming a
+// file faster than one blocking read() at a time. Backends:
+//   uring   - io_uring through raw syscalls (no liburing). The caller's
+//             buffer pool is registered once and read with READ_FIXED, so
+//             the kernel does not pin and unpin pages per request; READV
+//             if registration is refused (e.g. RLIMIT_MEMLOCK).
+//   threads - a pool of queueDepth threads (at most 64) doing blocking
+//             pread(); used where io_uring is missing or blocked (old
+//             kernels, seccomp), with a warning when uring was asked for.
+// With direct, the file is opened O_DIRECT, bypassing the page cache;
+// buffers, offsets and lengths must then be multiples of asyncIoAlignment.
+// A file system that refuses O_DIRECT (tmpfs) is read buffered instead.
+// Windows has neither backend: open() fails.
+//
+// IO_BACKEND (env): uring | threads (default uring)
+// IO_QUEUE_DEPTH (env): reads in flight (default 32)
+// IO_BLOCK_KIB (env): size of one read, rounded up to whole asyncIoAlignment
+//                     units (default 1024)
+// IO_DIRECT (env): 1 to open with O_DIRECT (default 0)
+
+constexpr std::size_t asyncIoAlignment = 4096;
+
+enum class IoBackend {
+    uring,
+    threads
+};
+
+inline const char* ioBackendName(IoBackend backend) {
+    return (backend == IoBackend::threads) ? "threads" : "uring";
+}
+
+inline bool parseIoBackend(const std::string& name, IoBackend& backend) {
+    if (name == "uring")
+        backend = IoBackend::uring;
+    else if (name == "threads")
+        backend = IoBackend::threads;
+    else
+        return false;
+    return true;
+}
+
+struct AsyncIoConfig {
+    IoBackend backend = IoBackend::uring;
+    std::size_t queueDepth = 32;
+    std::size_t blockBytes = 1024 * 1024;
+    bool direct = false;
+};
+
+inline AsyncIoConfig asyncIoConfigFromEnv() {
+    AsyncIoConfig config;
+    const char* backend = std::getenv("IO_BACKEND");
+    if (backend != nullptr && !parseIoBackend(backend, config.backend))
+        std::cerr << "Unknown IO_BACKEND '" << backend << "' (use uring|threads), using uring\n";
+    const char* depth = std::getenv("IO_QUEUE_DEPTH");
+    if (depth != nullptr && std::atoi(depth) > 0)
+        config.queueDepth = static_cast<std::size_t>(std::atoi(depth));
+    const char* blockKiB = std::getenv("IO_BLOCK_KIB");
+    if (blockKiB != nullptr && std::atoi(blockKiB) > 0)
+        config.blockBytes = static_cast<std::size_t>(std::atoi(blockKiB)) * 1024;
+    config.blockBytes = (config.blockBytes + asyncIoAlignment - 1) / asyncIoAlignment * asyncIoAlignment;
+    const char* direct = std::getenv("IO_DIRECT");
+    config.direct = (direct != nullptr && std::atoi(direct) != 0);
+    return config;
+}
+
+struct IoCompletion {
+    std::uint64_t tag;
+    long long result; // bytes read, or -errno
+};
+
+class AsyncFileReader {
+public:
+    AsyncFileReader() = default;
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    ~AsyncFileReader() {
+        close();
+    }
+
+    // Every read must target [bufferBase, bufferBase + bufferBytes).
+    bool open(const std::string& path, const AsyncIoConfig& config, void* bufferBase, std::size_t bufferBytes) {
+#if defined(PT_HAS_PREAD)
+        close();
+        queueDepth = std::max<std::size_t>(config.queueDepth, 1);
+        directIo = false;
+#if defined(O_DIRECT)
+        if (config.direct) {
+            fileDescriptor = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+            if (fileDescriptor >= 0) {
+                directIo = true;
+            }
+            else {
+                std::cerr << "open(O_DIRECT) failed for " << path << ": " << std::strerror(errno) << "; reading through the page cache\n";
+            }
+        }
+#else
+        if (config.direct)
+            std::cerr << "O_DIRECT is not available; reading through the page cache\n";
+#endif
+        if (fileDescriptor < 0)
+            fileDescriptor = ::open(path.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+            return false;
+
+        requests.assign(queueDepth, IoRequest {});
+        freeRequests.clear();
+        for (std::size_t i = queueDepth; i > 0; --i)
+            freeRequests.push_back(i - 1);
+
+        activeBackend = IoBackend::threads;
+#if defined(PT_HAS_IO_URING)
+        if (config.backend == IoBackend::uring) {
+            if (setupUring(bufferBase, bufferBytes))
+                activeBackend = IoBackend::uring;
+            else
+                std::cerr << "io_uring unavailable: " << std::strerror(errno) << "; using the thread pool\n";
+        }
+#else
+        (void)bufferBase;
+        (void)bufferBytes;
+        if (config.backend == IoBackend::uring)
+            std::cerr << "io_uring unavailable on this platform; using the thread pool\n";
+#endif
+        if (activeBackend == IoBackend::threads)
+            startThreads();
+        return true;
+#else
+        (void)path;
+        (void)config;
+        (void)bufferBase;
+        (void)bufferBytes;
+        return false;
+#endif
+    }
+
+    void close() {
+        stopThreads();
+#if defined(PT_HAS_IO_URING)
+        closeUring();
+#endif
+#if defined(PT_HAS_PREAD)
+        if (fileDescriptor >= 0)
+            ::close(fileDescriptor);
+#endif
+        fileDescriptor = -1;
+    }
+
+    IoBackend backend() const {
+        return activeBackend;
+    }
+
+    bool direct() const {
+        return directIo;
+    }
+
+    // Whether another read can be submitted (fewer than queueDepth outstanding).
+    bool canSubmit() const {
+        return !freeRequests.empty();
+    }
+
+    // Queues a read; it starts by the next waitOne() at the latest.
+    bool submit(void* buffer, std::size_t length, std::uint64_t offset, std::uint64_t tag) {
+        if (freeRequests.empty())
+            return false;
+        const std::size_t index = freeRequests.back();
+        freeRequests.pop_back();
+        requests[index] = IoRequest { buffer, length, offset, tag, 0 };
+#if defined(PT_HAS_IO_URING)
+        if (activeBackend == IoBackend::uring) {
+            queueSqe(index);
+            return true;
+        }
+#endif
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            pendingJobs.push_back(index);
+        }
+        jobReady.notify_one();
+        return true;
+    }
+
+    // Waits for any outstanding read to finish; false if the ring itself
+    // failed, after which no completion will arrive.
+    bool waitOne(IoCompletion& completion) {
+        std::size_t index = 0;
+#if defined(PT_HAS_IO_URING)
+        if (activeBackend == IoBackend::uring) {
+            if (!reapCqe(index))
+                return false;
+        }
+        else
+#endif
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            jobDone.wait(lock, [&]() { return !finishedJobs.empty(); });
+            index = finishedJobs.front();
+            finishedJobs.pop_front();
+        }
+        freeRequests.push_back(index);
+        completion = IoCompletion { requests[index].tag, requests[index].result };
+        return true;
+    }
+
+private:
+    struct IoRequest {
+        void* buffer;
+        std::size_t length;
+        std::uint64_t offset;
+        std::uint64_t tag;
+        long long result;
+    };
+
+    // Thread pool backend.
+    void startThreads() {
+        stopping = false;
+        const std::size_t threadCount = std::min<std::size_t>(queueDepth, 64);
+        for (std::size_t t = 0; t < threadCount; ++t)
+            poolThreads.emplace_back([this]() { poolLoop(); });
+    }
+
+    void stopThreads() {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            stopping = true;
+        }
+        jobReady.notify_all();
+        for (std::thread& thread : poolThreads)
+            thread.join();
+        poolThreads.clear();
+        pendingJobs.clear();
+        finishedJobs.clear();
+    }
+
+    void poolLoop() {
+        while (true) {
+            std::size_t index = 0;
+            {
+                std::unique_lock<std::mutex> lock(poolMutex);
+                jobReady.wait(lock, [&]() { return stopping || !pendingJobs.empty(); });
+                if (stopping)
+                    return;
+                index = pendingJobs.front();
+                pendingJobs.pop_front();
+            }
+            IoRequest& request = requests[index];
+            request.result = readFully(request);
+            {
+                std::lock_guard<std::mutex> lock(poolMutex);
+                finishedJobs.push_back(index);
+            }
+            jobDone.notify_one();
+        }
+    }
+
+    // pread until length bytes, end of file or an error.
+    long long readFully(const IoRequest& request) const {
+#if defined(PT_HAS_PREAD)
+        std::size_t done = 0;
+        while (done < request.length) {
+            const ssize_t got = ::pread(fileDescriptor, static_cast<char*>(request.buffer) + done, request.length - done,
+                static_cast<off_t>(request.offset + done));
+            if (got < 0) {
+                if (errno == EINTR)
+                    continue;
+                return -static_cast<long long>(errno);
+            }
+            if (got == 0)
+                break;
+            done += static_cast<std::size_t>(got);
+        }
+        return static_cast<long long>(done);
+#else
+        (void)request;
+        return -1;
+#endif
+    }
+
+#if defined(PT_HAS_IO_URING)
+    // io_uring backend: one submission and one completion ring, mapped from
+    // the ring file descriptor; this thread is the only producer of
+    // submissions and the only consumer of completions.
+    bool setupUring(void* bufferBase, std::size_t bufferBytes) {
+        io_uring_params params {};
+        const long ringFd = ::syscall(__NR_io_uring_setup, static_cast<unsigned>(queueDepth), &params);
+        if (ringFd < 0)
+            return false;
+        uringFd = static_cast<int>(ringFd);
+
+        sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap)
+            sqRingBytes = cqRingBytes = std::max(sqRingBytes, cqRingBytes);
+        sqRing = ::mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uringFd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            sqRing = nullptr;
+            closeUring();
+            return false;
+        }
+        cqRing = singleMap ? sqRing : ::mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uringFd, IORING_OFF_CQ_RING);
+        sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqeMap = ::mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uringFd, IORING_OFF_SQES);
+        if (cqRing == MAP_FAILED || sqeMap == MAP_FAILED) {
+            if (cqRing == MAP_FAILED)
+                cqRing = nullptr;
+            sqes = (sqeMap == MAP_FAILED) ? nullptr : static_cast<io_uring_sqe*>(sqeMap);
+            closeUring();
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqeMap);
+
+        unsigned char* sq = static_cast<unsigned char*>(sqRing);
+        unsigned char* cq = static_cast<unsigned char*>(cqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        iovec registered { bufferBase, bufferBytes };
+        fixedBuffers = (bufferBase != nullptr && bufferBytes > 0
+            && ::syscall(__NR_io_uring_register, uringFd, IORING_REGISTER_BUFFERS, &registered, 1) == 0);
+        iovecs.assign(queueDepth, iovec {});
+        pendingSubmits = 0;
+        return true;
+    }
+
+    void closeUring() {
+        if (sqes != nullptr)
+            ::munmap(sqes, sqesBytes);
+        if (cqRing != nullptr && cqRing != sqRing)
+            ::munmap(cqRing, cqRingBytes);
+        if (sqRing != nullptr)
+            ::munmap(sqRing, sqRingBytes);
+        if (uringFd >= 0)
+            ::close(uringFd);
+        sqes = nullptr;
+        sqRing = nullptr;
+        cqRing = nullptr;
+        uringFd = -1;
+    }
+
+    void queueSqe(std::size_t index) {
+        const IoRequest& request = requests[index];
+        const unsigned tail = *sqTail;
+        const unsigned slot = tail & sqMask;
+        io_uring_sqe& sqe = sqes[slot];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.fd = fileDescriptor;
+        sqe.off = request.offset;
+        sqe.user_data = index;
+        if (fixedBuffers) {
+            sqe.opcode = IORING_OP_READ_FIXED;
+            sqe.addr = reinterpret_cast<std::uint64_t>(request.buffer);
+            sqe.len = static_cast<std::uint32_t>(request.length);
+            sqe.buf_index = 0;
+        }
+        else {
+            iovecs[index] = iovec { request.buffer, request.length };
+            sqe.opcode = IORING_OP_READV;
+            sqe.addr = reinterpret_cast<std::uint64_t>(&iovecs[index]);
+            sqe.len = 1;
+        }
+        sqArray[slot] = slot;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++pendingSubmits;
+    }
+
+    bool reapCqe(std::size_t& index) {
+        while (true) {
+            const unsigned head = *cqHead;
+            if (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE) && pendingSubmits == 0) {
+                const io_uring_cqe& cqe = cqes[head & cqMask];
+                index = static_cast<std::size_t>(cqe.user_data);
+                requests[index].result = cqe.res;
+                __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            // Hands over queued submissions and, if none is complete yet, sleeps for one.
+            const unsigned waitFor = (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) ? 0u : 1u;
+            const long entered = ::syscall(__NR_io_uring_enter, uringFd, pendingSubmits, waitFor,
+                waitFor != 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (entered >= 0)
+                pendingSubmits -= static_cast<unsigned>(entered);
+            else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                std::cerr << "io_uring_enter failed: " << std::strerror(errno) << "\n";
+                return false;
+            }
+        }
+    }
+
+    int uringFd = -1;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    std::size_t sqRingBytes = 0;
+    std::size_t cqRingBytes = 0;
+    std::size_t sqesBytes = 0;
+    io_uring_sqe* sqes = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    bool fixedBuffers = false;
+    std::vector<iovec> iovecs;
+    unsigned pendingSubmits = 0;
+#endif
+
+    int fileDescriptor = -1;
+    std::size_t queueDepth = 1;
+    bool directIo = false;
+    IoBackend activeBackend = IoBackend::threads;
+    std::vector<IoRequest> requests;
+    std::vector<std::size_t> freeRequests;
+
+    std::vector<std::thread> poolThreads;
+    std::mutex poolMutex;
+    std::condition_variable jobReady;
+    std::condition_variable jobDone;
+    std::deque<std::size_t> pendingJobs;
+    std::deque<std::size_t> finishedJobs;
+    bool stopping = false;
+};
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "PerfCounters.hpp"
+
+// Repeated measurement of one benchmark region. A target hands the harness a
+// function that runs the region once and returns its elapsed seconds; the
+// harness runs it until the estimate is stable and summarizes the runs.
+// Configured per launch from the environment:
+//   BENCH_WARMUP      untimed runs before measuring (default 1)
+//   BENCH_MIN_RUNS    measured runs before the stop rule applies (default 5)
+//   BENCH_MAX_RUNS    upper bound on measured runs (default 30)
+//   BENCH_TARGET_CI   stop once the 95% confidence half-width of the mean is
+//                     at most this fraction of the mean (default 0.02)
+//   BENCH_MAX_SECONDS stop once the measured runs add up to this (default 60)
+//   BENCH_OUTLIERS    mad: drop runs more than 3 scaled MADs from the median (default) | none
+//   BENCH_FORMAT      csv (default) | json
+//   BENCH_PERF        on: hardware counters around the measured runs (default) | off,
+//                     see PerfCounters.hpp
+// Every target prints one row per launch. In it, timeSeconds is the median of
+// the kept runs, and the BenchStats columns come last, so existing positional
+// CSV parsers keep working.
+
+struct BenchConfig {
+    int warmUpRuns = 1;
+    int minRuns = 5;
+    int maxRuns = 30;
+    double targetCi = 0.02;
+    double maxSeconds = 60.0;
+    bool rejectOutliers = true;
+    bool json = false;
+    bool perfCounters = true;
+};
+
+inline int benchEnvInt(const char* name, int fallback, int minimum) {
+    const char* value = std::getenv(name);
+    return (value != nullptr && *value != '\0') ? std::max(minimum, std::atoi(value)) : fallback;
+}
+
+inline double benchEnvDouble(const char* name, double fallback) {
+    const char* value = std::getenv(name);
+    return (value != nullptr && *value != '\0') ? std::atof(value) : fallback;
+}
+
+inline BenchConfig benchConfigFromEnv() {
+    BenchConfig config;
+    config.warmUpRuns = benchEnvInt("BENCH_WARMUP", config.warmUpRuns, 0);
+    config.minRuns = benchEnvInt("BENCH_MIN_RUNS", config.minRuns, 1);
+    config.maxRuns = std::max(config.minRuns, benchEnvInt("BENCH_MAX_RUNS", config.maxRuns, 1));
+    config.targetCi = benchEnvDouble("BENCH_TARGET_CI", config.targetCi);
+    config.maxSeconds = benchEnvDouble("BENCH_MAX_SECONDS", config.maxSeconds);
+
+    const char* outliers = std::getenv("BENCH_OUTLIERS");
+    if (outliers != nullptr) {
+        const std::string outlierRule = outliers;
+        if (outlierRule == "none")
+            config.rejectOutliers = false;
+        else if (outlierRule != "mad")
+            std::cerr << "Unknown BENCH_OUTLIERS '" << outlierRule << "' (use mad|none), using mad\n";
+    }
+
+    const char* format = std::getenv("BENCH_FORMAT");
+    if (format != nullptr) {
+        const std::string formatName = format;
+        if (formatName == "json")
+            config.json = true;
+        else if (formatName != "csv")
+            std::cerr << "Unknown BENCH_FORMAT '" << formatName << "' (use csv|json), using csv\n";
+    }
+
+    const char* perf = std::getenv("BENCH_PERF");
+    if (perf != nullptr) {
+        const std::string perfSetting = perf;
+        if (perfSetting == "off")
+            config.perfCounters = false;
+        else if (perfSetting != "on")
+            std::cerr << "Unknown BENCH_PERF '" << perfSetting << "' (use on|off), using on\n";
+    }
+    return config;
+}
+
+struct BenchStats {
+    int runs = 0;
+    int outliers = 0;
+    double median = 0.0;
+    double mean = 0.0;
+    double min = 0.0;
+    double p5 = 0.0;
+    double p95 = 0.0;
+    double stddev = 0.0;
+    double ciRelative = 0.0;
+    PerfSummary perf;
+};
+
+// Linear interpolation between closest ranks of an ascending sample.
+inline double benchPercentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty())
+        return 0.0;
+    const double position = fraction * static_cast<double>(sorted.size() - 1);
+    const std::size_t lower = static_cast<std::size_t>(position);
+    const std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (position - static_cast<double>(lower)) * (sorted[upper] - sorted[lower]);
+}
+
+// Two-sided 95% Student t quantile.
+inline double studentT95(int degrees) {
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (degrees < 1)
+        return 0.0;
+    return (degrees <= 30) ? table[degrees - 1] : 1.960 + 2.4 / static_cast<double>(degrees);
+}
+
+inline BenchStats summarizeBenchSamples(const std::vector<double>& samples, bool rejectOutliers) {
+    BenchStats stats;
+    if (samples.empty())
+        return stats;
+
+    std::vector<double> kept(samples);
+    std::sort(kept.begin(), kept.end());
+    if (rejectOutliers && kept.size() >= 3) {
+        const double median = benchPercentile(kept, 0.5);
+        std::vector<double> deviations;
+        deviations.reserve(kept.size());
+        for (double sample : kept)
+            deviations.push_back(std::abs(sample - median));
+        std::sort(deviations.begin(), deviations.end());
+        const double limit = 3.0 * 1.4826 * benchPercentile(deviations, 0.5);
+        if (limit > 0.0) {
+            kept.erase(std::remove_if(kept.begin(), kept.end(),
+                [&](double sample) { return std::abs(sample - median) > limit; }), kept.end());
+        }
+    }
+
+    stats.runs = static_cast<int>(samples.size());
+    stats.outliers = static_cast<int>(samples.size() - kept.size());
+    stats.median = benchPercentile(kept, 0.5);
+    stats.min = kept.front();
+    stats.p5 = benchPercentile(kept, 0.05);
+    stats.p95 = benchPercentile(kept, 0.95);
+
+    double sum = 0.0;
+    for (double sample : kept)
+        sum += sample;
+    stats.mean = sum / static_cast<double>(kept.size());
+
+    if (kept.size() > 1) {
+        double squares = 0.0;
+        for (double sample : kept)
+            squares += (sample - stats.mean) * (sample - stats.mean);
+        stats.stddev = std::sqrt(squares / static_cast<double>(kept.size() - 1));
+        const double halfWidth = studentT95(static_cast<int>(kept.size()) - 1) * stats.stddev / std::sqrt(static_cast<double>(kept.size()));
+        stats.ciRelative = (stats.mean > 0.0) ? halfWidth / stats.mean : 0.0;
+    }
+    return stats;
+}
+
+inline bool benchShouldStop(const BenchConfig& config, const std::vector<double>& samples, double measuredSeconds) {
+    const int runs = static_cast<int>(samples.size());
+    if (runs >= config.maxRuns)
+        return true;
+    if (runs < config.minRuns)
+        return false;
+    if (measuredSeconds >= config.maxSeconds)
+        return true;
+    return summarizeBenchSamples(samples, config.rejectOutliers).ciRelative <= config.targetCi;
+}
+
+// Per-thread seconds of the measured runs, for targets that time each
+// thread's share of a region. A run hands its times to record() (one entry
+// per thread of the team that ran, so the length may vary between runs);
+// runBenchmark keeps them for measured runs and drops them for warm-up runs.
+class PerThreadSeconds {
+public:
+    void record(std::vector<double> seconds) {
+        pending = std::move(seconds);
+    }
+
+    // Called by runBenchmark after every run.
+    void keepRun() {
+        if (pending.size() > sums.size()) {
+            sums.resize(pending.size(), 0.0);
+            runs.resize(pending.size(), 0);
+        }
+        for (std::size_t t = 0; t < pending.size(); ++t) {
+            sums[t] += pending[t];
+            ++runs[t];
+        }
+        pending.clear();
+    }
+
+    void dropRun() {
+        pending.clear();
+    }
+
+    // Mean per thread over the measured runs whose team included it.
+    std::vector<double> means() const {
+        std::vector<double> result(sums.size(), 0.0);
+        for (std::size_t t = 0; t < sums.size(); ++t)
+            result[t] = sums[t] / static_cast<double>(std::max<std::size_t>(runs[t], 1));
+        return result;
+    }
+
+    // Means joined with ';', one CSV field.
+    std::string joined() const {
+        std::string list;
+        const std::vector<double> threadMeans = means();
+        for (std::size_t t = 0; t < threadMeans.size(); ++t) {
+            std::ostringstream text;
+            text << threadMeans[t];
+            list += (t > 0 ? ";" : "") + text.str();
+        }
+        return list;
+    }
+
+    // Slowest thread's mean over the mean of all threads (1 when balanced).
+    double imbalance() const {
+        const std::vector<double> threadMeans = means();
+        double slowest = 0.0;
+        double sum = 0.0;
+        for (double seconds : threadMeans) {
+            slowest = std::max(slowest, seconds);
+            sum += seconds;
+        }
+        return (sum > 0.0) ? slowest / (sum / static_cast<double>(threadMeans.size())) : 1.0;
+    }
+
+private:
+    std::vector<double> pending;
+    std::vector<double> sums;
+    std::vector<std::size_t> runs;
+};
+
+// runOnce() executes the measured region once and returns its elapsed seconds.
+// With perThreadSeconds, what each run record()s is kept for measured runs only.
+template <typename RunOnce>
+BenchStats runBenchmark(const BenchConfig& config, RunOnce runOnce, PerThreadSeconds* perThreadSeconds = nullptr) {
+    for (int run = 0; run < config.warmUpRuns; ++run) {
+        runOnce();
+        if (perThreadSeconds != nullptr)
+            perThreadSeconds->dropRun();
+    }
+
+    PerfCounters counters;
+    if (config.perfCounters)
+        counters.open(true);
+
+    std::vector<double> samples;
+    double measuredSeconds = 0.0;
+    do {
+        counters.start();
+        const double elapsed = runOnce();
+        counters.stop();
+        if (perThreadSeconds != nullptr)
+            perThreadSeconds->keepRun();
+        samples.push_back(elapsed);
+        measuredSeconds += elapsed;
+    } while (!benchShouldStop(config, samples, measuredSeconds));
+
+    BenchStats stats = summarizeBenchSamples(samples, config.rejectOutliers);
+    stats.perf = summarizePerf(counters.totals(), measuredSeconds);
+    return stats;
+}
+
+// One output row: named values printed as a CSV line or a JSON object.
+class BenchRow {
+public:
+    template <typename T>
+    BenchRow& add(const std::string& name, const T& value) {
+        std::ostringstream text;
+        text << value;
+        return append(name, text.str(), !isNumeric<T>());
+    }
+
+    // Floating-point value with the given number of significant digits.
+    BenchRow& add(const std::string& name, double value, int precision) {
+        std::ostringstream text;
+        text << std::setprecision(precision) << value;
+        return append(name, text.str(), false);
+    }
+
+    // Floating-point value with a fixed number of decimals.
+    BenchRow& addFixed(const std::string& name, double value, int decimals) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(decimals) << value;
+        return append(name, text.str(), false);
+    }
+
+    // Targets that time several regions pass a prefix per region ("custom" -> customRuns, ...).
+    BenchRow& addStats(const BenchStats& stats, const std::string& prefix = "") {
+        add(statName(prefix, "runs"), stats.runs);
+        add(statName(prefix, "outliers"), stats.outliers);
+        add(statName(prefix, "meanSeconds"), stats.mean);
+        add(statName(prefix, "minSeconds"), stats.min);
+        add(statName(prefix, "p5Seconds"), stats.p5);
+        add(statName(prefix, "p95Seconds"), stats.p95);
+        add(statName(prefix, "stddevSeconds"), stats.stddev);
+        add(statName(prefix, "ciRelative"), stats.ciRelative);
+        add(statName(prefix, "ipc"), stats.perf.ipc);
+        add(statName(prefix, "llcMissRate"), stats.perf.llcMissRate);
+        add(statName(prefix, "branchMissRate"), stats.perf.branchMissRate);
+        add(statName(prefix, "llcMissGBs"), stats.perf.llcMissGBs);
+        add(statName(prefix, "dramGBs"), stats.perf.dramGBs);
+        return add(statName(prefix, "dtlbMpki"), stats.perf.dtlbMpki);
+    }
+
+    void print(std::ostream& out, const BenchConfig& config) const {
+        std::string line;
+        if (config.json) {
+            line = "{";
+            for (std::size_t i = 0; i < fields.size(); ++i) {
+                line += (i > 0 ? ",\"" : "\"") + fields[i].name + "\":";
+                line += fields[i].text ? quoted(fields[i].value) : jsonNumber(fields[i].value);
+            }
+            line += "}";
+        }
+        else {
+            for (std::size_t i = 0; i < fields.size(); ++i)
+                line += (i > 0 ? "," : "") + fields[i].value;
+        }
+        out << line << std::endl;
+    }
+
+private:
+    struct Field {
+        std::string name;
+        std::string value;
+        bool text;
+    };
+
+    template <typename T>
+    static constexpr bool isNumeric() {
+        return std::is_arithmetic<T>::value && !std::is_same<T, char>::value && !std::is_same<T, bool>::value;
+    }
+
+    BenchRow& append(const std::string& name, const std::string& value, bool text) {
+        fields.push_back(Field { name, value, text });
+        return *this;
+    }
+
+    static std::string statName(const std::string& prefix, std::string name) {
+        if (prefix.empty())
+            return name;
+        name[0] = static_cast<char>(name[0] - 'a' + 'A');
+        return prefix + name;
+    }
+
+    static std::string quoted(const std::string& value) {
+        std::string result = "\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\')
+                result += '\\';
+            result += c;
+        }
+        return result + "\"";
+    }
+
+    // inf and nan have no JSON spelling.
+    static std::string jsonNumber(const std::string& value) {
+        return (value.find("inf") != std::string::npos || value.find("nan") != std::string::npos) ? "null" : value;
+    }
+
+    std::vector<Field> fields;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <mpi.h>
+#include <vector>
+
+#include "BenchHarness.hpp"
+
+// runBenchmark for MPI targets. Every rank runs the region, the sample of a
+// run is the slowest rank's time, and rank 0 alone decides when to stop and
+// broadcasts the decision, so all ranks leave the loop after the same run.
+// The returned statistics are only filled in on rank 0.
+// Hardware counters are summed over all ranks; the memory controller
+// counters are opened by the first rank on each node only, since they count
+// the whole node.
+inline PerfTotals reducePerfTotals(const PerfTotals& local, bool nodeLeader, MPI_Comm comm) {
+    double values[perfEventCount + 5];
+    for (int event = 0; event < perfEventCount; ++event)
+        values[event] = local.counts[event];
+    values[perfEventCount] = local.dramBytes;
+    values[perfEventCount + 1] = local.coreAvailable ? 0.0 : 1.0;           // ranks without counters
+    values[perfEventCount + 2] = nodeLeader ? 1.0 : 0.0;                     // nodes
+    values[perfEventCount + 3] = (nodeLeader && local.dramAvailable) ? 1.0 : 0.0; // nodes with DRAM counters
+    values[perfEventCount + 4] = local.dtlbAvailable ? 0.0 : 1.0;           // ranks without the dTLB counter
+
+    double sums[perfEventCount + 5];
+    MPI_Reduce(values, sums, perfEventCount + 5, MPI_DOUBLE, MPI_SUM, 0, comm);
+
+    PerfTotals total;
+    for (int event = 0; event < perfEventCount; ++event)
+        total.counts[event] = sums[event];
+    total.dramBytes = sums[perfEventCount];
+    total.coreAvailable = (sums[perfEventCount + 1] == 0.0);
+    total.dtlbAvailable = (sums[perfEventCount + 4] == 0.0);
+    total.dramAvailable = (sums[perfEventCount + 3] == sums[perfEventCount + 2]);
+    return total;
+}
+
+template <typename RunOnce>
+BenchStats runBenchmarkMpi(const BenchConfig& config, MPI_Comm comm, RunOnce runOnce) {
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+
+    int warmUpRuns = config.warmUpRuns;
+    MPI_Bcast(&warmUpRuns, 1, MPI_INT, 0, comm);
+    for (int run = 0; run < warmUpRuns; ++run)
+        runOnce();
+
+    MPI_Comm nodeComm = MPI_COMM_NULL;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodeComm);
+    int nodeRank = 0;
+    MPI_Comm_rank(nodeComm, &nodeRank);
+    MPI_Comm_free(&nodeComm);
+
+    int perfCounters = config.perfCounters ? 1 : 0;
+    MPI_Bcast(&perfCounters, 1, MPI_INT, 0, comm);
+    PerfCounters counters;
+    if (perfCounters != 0)
+        counters.open(nodeRank == 0);
+
+    std::vector<double> samples;
+    double measuredSeconds = 0.0;
+    int stop = 0;
+    while (stop == 0) {
+        counters.start();
+        const double elapsed = runOnce();
+        counters.stop();
+        double slowest = 0.0;
+        MPI_Reduce(&elapsed, &slowest, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
+        if (rank == 0) {
+            samples.push_back(slowest);
+            measuredSeconds += slowest;
+            stop = benchShouldStop(config, samples, measuredSeconds) ? 1 : 0;
+        }
+        MPI_Bcast(&stop, 1, MPI_INT, 0, comm);
+    }
+
+    const PerfTotals perfTotals = reducePerfTotals(counters.totals(), nodeRank == 0, comm);
+    if (rank != 0)
+        return BenchStats {};
+    BenchStats stats = summarizeBenchSamples(samples, config.rejectOutliers);
+    stats.perf = summarizePerf(perfTotals, measuredSeconds);
+    return stats;
+}
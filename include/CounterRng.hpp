@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "Partition.hpp"
+
+// Counter-based random data generation (Philox4x32-10, Salmon et al., SC'11).
+// The value at index i of a stream is a pure function of (seed, stream, i),
+// so any index range can be generated independently and the data is
+// byte-identical for a given seed no matter how the range is split across
+// threads or ranks. Use distinct stream ids for distinct arrays of one run.
+
+struct PhiloxBlock {
+    std::uint32_t word[4];
+};
+
+static inline std::uint32_t philoxMulHi(std::uint32_t a, std::uint32_t b, std::uint32_t& low) {
+    const std::uint64_t product = static_cast<std::uint64_t>(a) * b;
+    low = static_cast<std::uint32_t>(product);
+    return static_cast<std::uint32_t>(product >> 32);
+}
+
+inline PhiloxBlock philox4x32(std::uint64_t blockIndex, std::uint32_t stream, std::uint64_t seed) {
+    std::uint32_t c0 = static_cast<std::uint32_t>(blockIndex);
+    std::uint32_t c1 = static_cast<std::uint32_t>(blockIndex >> 32);
+    std::uint32_t c2 = stream;
+    std::uint32_t c3 = 0;
+    std::uint32_t k0 = static_cast<std::uint32_t>(seed);
+    std::uint32_t k1 = static_cast<std::uint32_t>(seed >> 32);
+
+    for (int round = 0; round < 10; ++round) {
+        std::uint32_t low0 = 0, low1 = 0;
+        const std::uint32_t high0 = philoxMulHi(0xD2511F53u, c0, low0);
+        const std::uint32_t high1 = philoxMulHi(0xCD9E8D57u, c2, low1);
+        const std::uint32_t n0 = high1 ^ c1 ^ k0;
+        const std::uint32_t n1 = low1;
+        const std::uint32_t n2 = high0 ^ c3 ^ k1;
+        const std::uint32_t n3 = low0;
+        c0 = n0;
+        c1 = n1;
+        c2 = n2;
+        c3 = n3;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    return PhiloxBlock { { c0, c1, c2, c3 } };
+}
+
+// Uniform double in [lo, hi) from 53 random bits; two values per Philox block.
+inline void fillUniformReal(double* out, std::size_t begin, std::size_t count,
+    std::uint64_t seed, std::uint32_t stream, double lo, double hi) {
+    const double scale = (hi - lo) * (1.0 / 9007199254740992.0);
+    for (std::size_t k = 0; k < count;) {
+        const std::size_t index = begin + k;
+        const PhiloxBlock block = philox4x32(index / 2, stream, seed);
+        for (std::size_t lane = index % 2; lane < 2 && k < count; ++lane, ++k) {
+            const std::uint64_t bits = (static_cast<std::uint64_t>(block.word[2 * lane]) << 32) | block.word[2 * lane + 1];
+            out[k] = lo + static_cast<double>(bits >> 11) * scale;
+        }
+    }
+}
+
+// Uniform int in [lo, hi] by 32-bit multiply-shift; four values per Philox block.
+// The bias is below 2^-32 * (hi - lo + 1), which is irrelevant for benchmark inputs.
+inline void fillUniformInt(int* out, std::size_t begin, std::size_t count,
+    std::uint64_t seed, std::uint32_t stream, int lo, int hi) {
+    const std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(hi) - lo) + 1;
+    for (std::size_t k = 0; k < count;) {
+        const std::size_t index = begin + k;
+        const PhiloxBlock block = philox4x32(index / 4, stream, seed);
+        for (std::size_t lane = index % 4; lane < 4 && k < count; ++lane, ++k) {
+            const std::uint64_t offset = (static_cast<std::uint64_t>(block.word[lane]) * range) >> 32;
+            out[k] = static_cast<int>(static_cast<std::int64_t>(lo) + static_cast<std::int64_t>(offset));
+        }
+    }
+}
+
+// Parallel variants: one contiguous block per thread of the calling team,
+// split like a static loop over the same range. Without OpenMP they run
+// serially and produce the same bytes.
+template <typename T, typename FillRange>
+void parallelFillRange(T* out, std::size_t count, FillRange fillRange) {
+#if defined(_OPENMP)
+    #pragma omp parallel
+    {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        staticBlockRange(count, static_cast<std::size_t>(omp_get_thread_num()),
+            static_cast<std::size_t>(omp_get_num_threads()), begin, end);
+        fillRange(out + begin, begin, end - begin);
+    }
+#else
+    fillRange(out, 0, count);
+#endif
+}
+
+inline void parallelFillUniformReal(double* out, std::size_t begin, std::size_t count,
+    std::uint64_t seed, std::uint32_t stream, double lo, double hi) {
+    parallelFillRange(out, count, [&](double* chunk, std::size_t offset, std::size_t chunkCount) {
+        fillUniformReal(chunk, begin + offset, chunkCount, seed, stream, lo, hi);
+    });
+}
+
+inline void parallelFillUniformInt(int* out, std::size_t begin, std::size_t count,
+    std::uint64_t seed, std::uint32_t stream, int lo, int hi) {
+    parallelFillRange(out, count, [&](int* chunk, std::size_t offset, std::size_t chunkCount) {
+        fillUniformInt(chunk, begin + offset, chunkCount, seed, stream, lo, hi);
+    });
+}
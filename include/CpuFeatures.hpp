@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PT_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+// Per-function ISA selection. GCC/Clang need the target attribute to emit
+// AVX2/AVX-512 code in a translation unit built without -march flags;
+// MSVC accepts the intrinsics unconditionally.
+#if defined(PT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PT_TARGET(isa)
+#endif
+
+enum class SimdLevel {
+    scalar = 0,
+    sse41 = 1,
+    avx2 = 2,
+    avx512 = 3
+};
+
+struct CpuFeatures {
+    bool sse41 = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+};
+
+#if defined(PT_X86)
+static inline void cpuidQuery(unsigned int leaf, unsigned int subLeaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subLeaf));
+    for (int i = 0; i < 4; ++i)
+        regs[i] = static_cast<unsigned int>(info[i]);
+#else
+    __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static inline std::uint64_t readXcr0() {
+#if defined(_MSC_VER)
+    return static_cast<std::uint64_t>(_xgetbv(0));
+#else
+    unsigned int eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<std::uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+// CPUID feature bits, masked by what the OS actually saves on context switch (XCR0).
+inline const CpuFeatures& detectCpuFeatures() {
+    static const CpuFeatures features = [] {
+        CpuFeatures result;
+#if defined(PT_X86)
+        unsigned int regs[4] = { 0, 0, 0, 0 };
+        cpuidQuery(0, 0, regs);
+        const unsigned int maxLeaf = regs[0];
+        if (maxLeaf < 1)
+            return result;
+
+        cpuidQuery(1, 0, regs);
+        const bool osxsave = (regs[2] & (1u << 27)) != 0;
+        result.sse41 = (regs[2] & (1u << 19)) != 0;
+        const bool fmaBit = (regs[2] & (1u << 12)) != 0;
+
+        std::uint64_t xcr0 = 0;
+        if (osxsave)
+            xcr0 = readXcr0();
+        const bool osAvx = (xcr0 & 0x6u) == 0x6u;
+        const bool osAvx512 = (xcr0 & 0xE6u) == 0xE6u;
+
+        if (maxLeaf >= 7) {
+            cpuidQuery(7, 0, regs);
+            result.avx2 = osAvx && (regs[1] & (1u << 5)) != 0;
+            result.avx512f = osAvx512 && (regs[1] & (1u << 16)) != 0;
+        }
+        result.fma = osAvx && fmaBit;
+#endif
+        return result;
+    }();
+    return features;
+}
+
+inline SimdLevel detectSimdLevel() {
+    const CpuFeatures& features = detectCpuFeatures();
+    if (features.avx512f)
+        return SimdLevel::avx512;
+    if (features.avx2)
+        return SimdLevel::avx2;
+    if (features.sse41)
+        return SimdLevel::sse41;
+    return SimdLevel::scalar;
+}
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::avx512: return "avx512";
+    case SimdLevel::avx2: return "avx2";
+    case SimdLevel::sse41: return "sse41";
+    default: return "scalar";
+    }
+}
+
+// Best supported level, optionally capped by the SIMD_ISA environment variable
+// (scalar | sse41 | avx2 | avx512) to compare code paths on the same machine.
+inline SimdLevel selectSimdLevel() {
+    SimdLevel level = detectSimdLevel();
+    const char* requested = std::getenv("SIMD_ISA");
+    if (requested == nullptr)
+        return level;
+
+    const std::string name = requested;
+    SimdLevel cap = level;
+    if (name == "scalar")
+        cap = SimdLevel::scalar;
+    else if (name == "sse41")
+        cap = SimdLevel::sse41;
+    else if (name == "avx2")
+        cap = SimdLevel::avx2;
+    else if (name == "avx512")
+        cap = SimdLevel::avx512;
+
+    return (static_cast<int>(cap) < static_cast<int>(level)) ? cap : level;
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PT_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Partition.hpp"
+
+// On-disk datasets for out-of-core runs. A file holds arrayCount arrays of
+// elementCount elements each. The header occupies the first datasetAlignment
+// bytes and every array starts on a datasetAlignment boundary, which is a
+// multiple of any common page size, so page-aligned thread ranges in element
+// space are also page-aligned in the mapping.
+
+constexpr std::size_t datasetAlignment = 64 * 1024;
+constexpr std::size_t datasetWindowBytes = 16 * 1024 * 1024;
+
+struct DatasetHeader {
+    char magic[8];
+    std::uint64_t elementCount;
+    std::uint64_t elementSize;
+    std::uint64_t arrayCount;
+    std::uint64_t seed;
+    std::uint64_t arrayStride;
+};
+
+inline std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+inline DatasetHeader makeDatasetHeader(std::size_t elementCount, std::size_t elementSize, std::size_t arrayCount, std::uint64_t seed) {
+    DatasetHeader header {};
+    std::memcpy(header.magic, "PTDATA1", 8);
+    header.elementCount = elementCount;
+    header.elementSize = elementSize;
+    header.arrayCount = arrayCount;
+    header.seed = seed;
+    header.arrayStride = alignUp(static_cast<std::uint64_t>(elementCount) * elementSize, datasetAlignment);
+    return header;
+}
+
+inline bool datasetHeaderMatches(const DatasetHeader& a, const DatasetHeader& b) {
+    return std::memcmp(a.magic, b.magic, sizeof(a.magic)) == 0
+        && a.elementCount == b.elementCount
+        && a.elementSize == b.elementSize
+        && a.arrayCount == b.arrayCount
+        && a.seed == b.seed
+        && a.arrayStride == b.arrayStride;
+}
+
+inline std::uint64_t datasetArrayOffset(const DatasetHeader& header, std::size_t arrayIndex) {
+    return datasetAlignment + header.arrayStride * arrayIndex;
+}
+
+// Writes the dataset unless a file with an identical header already exists.
+// fillChunk(begin, count, chunks) must fill chunks[a][0..count) for every array a
+// with the elements [begin, begin + count); it is called with increasing begin.
+template <typename T, std::size_t ArrayCount, typename FillChunk>
+bool ensureDatasetFile(const std::string& path, std::size_t elementCount, std::uint64_t seed, FillChunk fillChunk) {
+    const DatasetHeader expected = makeDatasetHeader(elementCount, sizeof(T), ArrayCount, seed);
+    {
+        std::ifstream inFile(path, std::ios::binary);
+        DatasetHeader existing {};
+        if (inFile && inFile.read(reinterpret_cast<char*>(&existing), sizeof(existing))) {
+            inFile.seekg(0, std::ios::end);
+            const std::uint64_t fileSize = static_cast<std::uint64_t>(inFile.tellg());
+            if (datasetHeaderMatches(existing, expected) && fileSize >= datasetArrayOffset(expected, ArrayCount))
+                return true;
+        }
+    }
+
+    std::ofstream outFile(path, std::ios::binary | std::ios::trunc);
+    if (!outFile)
+        return false;
+    outFile.write(reinterpret_cast<const char*>(&expected), sizeof(expected));
+
+    const std::size_t chunkElements = std::max<std::size_t>(1, datasetWindowBytes / sizeof(T));
+    std::array<std::vector<T>, ArrayCount> chunkBuffers;
+    std::array<T*, ArrayCount> chunkPointers;
+    for (std::size_t a = 0; a < ArrayCount; ++a) {
+        chunkBuffers[a].resize(std::min(chunkElements, elementCount));
+        chunkPointers[a] = chunkBuffers[a].data();
+    }
+
+    for (std::size_t begin = 0; begin < elementCount; begin += chunkElements) {
+        const std::size_t count = std::min(chunkElements, elementCount - begin);
+        fillChunk(begin, count, chunkPointers);
+        for (std::size_t a = 0; a < ArrayCount; ++a) {
+            outFile.seekp(static_cast<std::streamoff>(datasetArrayOffset(expected, a) + begin * sizeof(T)));
+            outFile.write(reinterpret_cast<const char*>(chunkPointers[a]), static_cast<std::streamsize>(count * sizeof(T)));
+        }
+    }
+
+    // Pad the last array so the file covers every aligned stride.
+    outFile.seekp(static_cast<std::streamoff>(datasetArrayOffset(expected, ArrayCount) - 1));
+    outFile.put('\0');
+    return static_cast<bool>(outFile);
+}
+
+// Read-only mapping of a whole file with access-pattern hints.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    // populate pre-faults the whole mapping (MAP_POPULATE, Linux), reading
+    // the file in if it is not cached.
+    bool open(const std::string& path, bool populate = false) {
+#if defined(PT_HAS_MMAP)
+        close();
+        fileDescriptor = ::open(path.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+            return false;
+        struct stat fileStat {};
+        if (::fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size <= 0) {
+            close();
+            return false;
+        }
+        mappedSize = static_cast<std::size_t>(fileStat.st_size);
+        int flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+        if (populate)
+            flags |= MAP_POPULATE;
+#endif
+        void* address = ::mmap(nullptr, mappedSize, PROT_READ, flags, fileDescriptor, 0);
+        if (address == MAP_FAILED) {
+            mappedSize = 0;
+            close();
+            return false;
+        }
+        mappedData = static_cast<const unsigned char*>(address);
+        return true;
+#else
+        (void)path;
+        (void)populate;
+        return false;
+#endif
+    }
+
+    void close() {
+#if defined(PT_HAS_MMAP)
+        if (mappedData != nullptr)
+            ::munmap(const_cast<unsigned char*>(mappedData), mappedSize);
+        if (fileDescriptor >= 0)
+            ::close(fileDescriptor);
+#endif
+        mappedData = nullptr;
+        mappedSize = 0;
+        fileDescriptor = -1;
+    }
+
+    const unsigned char* data() const {
+        return mappedData;
+    }
+
+    std::size_t size() const {
+        return mappedSize;
+    }
+
+    void adviseSequential() const {
+#if defined(PT_HAS_MMAP)
+        if (mappedData != nullptr)
+            ::madvise(const_cast<unsigned char*>(mappedData), mappedSize, MADV_SEQUENTIAL);
+#endif
+    }
+
+    // Starts readahead for [address, address + length); address must be page-aligned.
+    static void prefetch(const void* address, std::size_t length) {
+#if defined(PT_HAS_MMAP)
+        if (length > 0)
+            ::madvise(const_cast<void*>(address), length, MADV_WILLNEED);
+#else
+        (void)address;
+        (void)length;
+#endif
+    }
+
+    // Drops the pages of a consumed window from this mapping; the page cache keeps them.
+    static void release(const void* address, std::size_t length) {
+#if defined(PT_HAS_MMAP)
+        if (length > 0)
+            ::madvise(const_cast<void*>(address), length, MADV_DONTNEED);
+#else
+        (void)address;
+        (void)length;
+#endif
+    }
+
+private:
+    const unsigned char* mappedData = nullptr;
+    std::size_t mappedSize = 0;
+    int fileDescriptor = -1;
+};
+
+// Static split of [0, count) into threadCount contiguous ranges whose
+// boundaries fall on multiples of granularity elements.
+inline void alignedThreadRange(std::size_t count, std::size_t granularity, std::size_t threadId, std::size_t threadCount,
+    std::size_t& begin, std::size_t& end) {
+    const std::size_t units = (count + granularity - 1) / granularity;
+    std::size_t unitBegin = 0;
+    std::size_t unitEnd = 0;
+    staticBlockRange(units, threadId, threadCount, unitBegin, unitEnd);
+    begin = std::min(count, unitBegin * granularity);
+    end = std::min(count, unitEnd * granularity);
+}
+
+// Walks [begin, end) of every array in windows of datasetWindowBytes, asking
+// the kernel to read the next window ahead while the current one is consumed.
+// begin must be aligned to datasetAlignment / sizeof(T) elements.
+template <typename T, std::size_t ArrayCount, typename WindowFn>
+void streamMappedWindows(const std::array<const T*, ArrayCount>& arrays, std::size_t begin, std::size_t end, WindowFn windowFn) {
+    const std::size_t windowElements = datasetWindowBytes / sizeof(T);
+    for (std::size_t a = 0; a < ArrayCount && begin < end; ++a)
+        MappedFile::prefetch(arrays[a] + begin, std::min(windowElements, end - begin) * sizeof(T));
+
+    for (std::size_t windowBegin = begin; windowBegin < end; windowBegin += windowElements) {
+        const std::size_t windowEnd = std::min(end, windowBegin + windowElements);
+        if (windowEnd < end) {
+            const std::size_t nextCount = std::min(windowElements, end - windowEnd);
+            for (std::size_t a = 0; a < ArrayCount; ++a)
+                MappedFile::prefetch(arrays[a] + windowEnd, nextCount * sizeof(T));
+        }
+        windowFn(windowBegin, windowEnd);
+        for (std::size_t a = 0; a < ArrayCount; ++a)
+            MappedFile::release(arrays[a] + windowBegin, (windowEnd - windowBegin) * sizeof(T));
+    }
+}
+
+// Drops a file's pages from the page cache (after writing back dirty ones),
+// so that the next read comes from the device. Pages still mapped by any
+// process stay. Returns false where posix_fadvise is missing.
+inline bool evictFileCache(const std::string& path) {
+#if defined(PT_HAS_MMAP) && defined(POSIX_FADV_DONTNEED)
+    const int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+        return false;
+    ::fdatasync(fileDescriptor);
+    const bool evicted = (::posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_DONTNEED) == 0);
+    ::close(fileDescriptor);
+    return evicted;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+// Share of a file's pages that are in the page cache (mincore), or -1 when
+// it cannot be measured.
+inline double fileCacheResidency(const std::string& path) {
+#if defined(PT_HAS_MMAP)
+    MappedFile mapped;
+    if (!mapped.open(path))
+        return -1.0;
+    const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t pages = (mapped.size() + pageSize - 1) / pageSize;
+#if defined(__APPLE__)
+    std::vector<char> resident(pages);
+#else
+    std::vector<unsigned char> resident(pages);
+#endif
+    if (::mincore(const_cast<unsigned char*>(mapped.data()), mapped.size(), resident.data()) != 0)
+        return -1.0;
+    std::size_t residentPages = 0;
+    for (std::size_t page = 0; page < pages; ++page)
+        residentPages += static_cast<std::size_t>(resident[page] & 1);
+    return static_cast<double>(residentPages) / static_cast<double>(pages);
+#else
+    (void)path;
+    return -1.0;
+#endif
+}
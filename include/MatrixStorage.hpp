@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "CounterRng.hpp"
+#include "NumaAllocator.hpp"
+
+// Storage formats for structured n x n matrices. Every format hands out row i
+// as a RowView over the in-shape cells of that row, stored contiguously, so a
+// row kernel is the same loop whatever the format. Cell (i, j) always holds
+// the counter-based value of its dense linear index i * n + j, so all formats
+// of one shape and seed hold the same matrix. Rows are first touched in the
+// NumaPolicy's static blocks, like the dense matrices elsewhere, on the pages
+// HugePages asks for.
+
+enum class MatrixShapeKind {
+    full,
+    banded,         // |i - j| <= bandwidth
+    lowerTriangular // j <= i
+};
+
+struct MatrixShape {
+    MatrixShapeKind kind = MatrixShapeKind::full;
+    std::size_t size = 0;
+    std::size_t bandwidth = 0;
+
+    std::size_t firstColumn(std::size_t row) const {
+        return (kind == MatrixShapeKind::banded && row > bandwidth) ? row - bandwidth : 0;
+    }
+
+    // Inclusive.
+    std::size_t lastColumn(std::size_t row) const {
+        if (kind == MatrixShapeKind::banded)
+            return std::min(size - 1, row + bandwidth);
+        return (kind == MatrixShapeKind::lowerTriangular) ? row : size - 1;
+    }
+
+    std::size_t rowLength(std::size_t row) const {
+        return lastColumn(row) - firstColumn(row) + 1;
+    }
+};
+
+struct RowView {
+    const double* first;
+    const double* last;
+
+    const double* begin() const {
+        return first;
+    }
+
+    const double* end() const {
+        return last;
+    }
+
+    std::size_t size() const {
+        return static_cast<std::size_t>(last - first);
+    }
+};
+
+inline void fillMatrixRow(double* out, const MatrixShape& shape, std::size_t row, std::uint64_t seed) {
+    const std::size_t firstColumn = shape.firstColumn(row);
+    fillUniformReal(out, row * shape.size + firstColumn, shape.rowLength(row), seed, 0, 0.0, 1.0e6);
+}
+
+// Row-major n x n array; cells outside the shape hold infinity. By default
+// the row views cover only the in-shape cells, so a scan touches the band of
+// an N-wide layout. With paddedRows they cover all n cells of the row,
+// infinity padding included: the row minima are the same, but every scan
+// reads (and first faults) the whole N-wide row.
+class DenseStorage {
+public:
+    DenseStorage(const MatrixShape& shape, std::uint64_t seed, NumaPolicy policy, int bindNode, HugePages pages, bool paddedRows = false)
+        : shape(shape), paddedRows(paddedRows), values(NumaAllocator<double>(policy, bindNode, pages)) {
+        const std::size_t n = shape.size;
+        values.resize(n * n);
+        initializeWithPolicy(policy, n, [&](std::size_t rowBegin, std::size_t rowEnd) {
+            for (std::size_t i = rowBegin; i < rowEnd; ++i) {
+                double* rowData = values.data() + i * n;
+                const std::size_t firstColumn = shape.firstColumn(i);
+                const std::size_t lastColumn = shape.lastColumn(i);
+                std::fill(rowData, rowData + firstColumn, std::numeric_limits<double>::infinity());
+                fillMatrixRow(rowData + firstColumn, shape, i, seed);
+                std::fill(rowData + lastColumn + 1, rowData + n, std::numeric_limits<double>::infinity());
+            }
+        });
+    }
+
+    RowView row(std::size_t i) const {
+        const double* rowData = values.data() + i * shape.size;
+        if (paddedRows)
+            return RowView { rowData, rowData + shape.size };
+        return RowView { rowData + shape.firstColumn(i), rowData + shape.lastColumn(i) + 1 };
+    }
+
+    std::size_t storedValues() const {
+        return values.size();
+    }
+
+private:
+    MatrixShape shape;
+    bool paddedRows;
+    NumaVector<double> values;
+};
+
+// LAPACK general band layout (xGBSV, ldab = kl + ku + 1) with the roles of rows
+// and columns swapped: row i owns the ldab slots starting at i * ldab, and
+// A(i, j) sits in slot bandwidth + j - i, so every matrix row is one
+// contiguous run. The slots that would fall outside the matrix in the first
+// and last bandwidth rows hold infinity.
+class BandStorage {
+public:
+    BandStorage(const MatrixShape& shape, std::uint64_t seed, NumaPolicy policy, int bindNode, HugePages pages)
+        : shape(shape), leadingDimension(2 * shape.bandwidth + 1), values(NumaAllocator<double>(policy, bindNode, pages)) {
+        values.resize(shape.size * leadingDimension);
+        initializeWithPolicy(policy, shape.size, [&](std::size_t rowBegin, std::size_t rowEnd) {
+            for (std::size_t i = rowBegin; i < rowEnd; ++i) {
+                double* slots = values.data() + i * leadingDimension;
+                double* rowData = slots + slot(i, shape.firstColumn(i));
+                double* rowEndData = rowData + shape.rowLength(i);
+                std::fill(slots, rowData, std::numeric_limits<double>::infinity());
+                fillMatrixRow(rowData, shape, i, seed);
+                std::fill(rowEndData, slots + leadingDimension, std::numeric_limits<double>::infinity());
+            }
+        });
+    }
+
+    RowView row(std::size_t i) const {
+        const double* rowData = values.data() + i * leadingDimension + slot(i, shape.firstColumn(i));
+        return RowView { rowData, rowData + shape.rowLength(i) };
+    }
+
+    std::size_t storedValues() const {
+        return values.size();
+    }
+
+private:
+    std::size_t slot(std::size_t i, std::size_t j) const {
+        return shape.bandwidth + j - i;
+    }
+
+    MatrixShape shape;
+    std::size_t leadingDimension;
+    NumaVector<double> values;
+};
+
+// Row-packed lower triangle: row i holds columns 0..i and starts at
+// i * (i + 1) / 2 (the transpose of LAPACK's column-packed upper triangle).
+class PackedLowerStorage {
+public:
+    PackedLowerStorage(const MatrixShape& shape, std::uint64_t seed, NumaPolicy policy, int bindNode, HugePages pages)
+        : values(NumaAllocator<double>(policy, bindNode, pages)) {
+        values.resize(rowStart(shape.size));
+        initializeWithPolicy(policy, shape.size, [&](std::size_t rowBegin, std::size_t rowEnd) {
+            for (std::size_t i = rowBegin; i < rowEnd; ++i)
+                fillMatrixRow(values.data() + rowStart(i), shape, i, seed);
+        });
+    }
+
+    RowView row(std::size_t i) const {
+        const double* rowData = values.data() + rowStart(i);
+        return RowView { rowData, rowData + i + 1 };
+    }
+
+    std::size_t storedValues() const {
+        return values.size();
+    }
+
+private:
+    static std::size_t rowStart(std::size_t i) {
+        return i * (i + 1) / 2;
+    }
+
+    NumaVector<double> values;
+};
+
+// Compressed sparse rows: the values of row i are values[rowOffsets[i] ..
+// rowOffsets[i + 1]) with their column indices alongside. It is built here
+// from a shape, but nothing in the row access depends on one.
+class CsrStorage {
+public:
+    CsrStorage(const MatrixShape& shape, std::uint64_t seed, NumaPolicy policy, int bindNode, HugePages pages)
+        : rowOffsets(shape.size + 1), columns(NumaAllocator<std::uint32_t>(policy, bindNode, pages)),
+          values(NumaAllocator<double>(policy, bindNode, pages)) {
+        rowOffsets[0] = 0;
+        for (std::size_t i = 0; i < shape.size; ++i)
+            rowOffsets[i + 1] = rowOffsets[i] + shape.rowLength(i);
+        columns.resize(rowOffsets[shape.size]);
+        values.resize(rowOffsets[shape.size]);
+        initializeWithPolicy(policy, shape.size, [&](std::size_t rowBegin, std::size_t rowEnd) {
+            for (std::size_t i = rowBegin; i < rowEnd; ++i) {
+                const std::size_t firstColumn = shape.firstColumn(i);
+                for (std::size_t k = rowOffsets[i]; k < rowOffsets[i + 1]; ++k)
+                    columns[k] = static_cast<std::uint32_t>(firstColumn + (k - rowOffsets[i]));
+                fillMatrixRow(values.data() + rowOffsets[i], shape, i, seed);
+            }
+        });
+    }
+
+    RowView row(std::size_t i) const {
+        return RowView { values.data() + rowOffsets[i], values.data() + rowOffsets[i + 1] };
+    }
+
+    const std::uint32_t* rowColumns(std::size_t i) const {
+        return columns.data() + rowOffsets[i];
+    }
+
+    std::size_t storedValues() const {
+        return values.size();
+    }
+
+private:
+    std::vector<std::size_t> rowOffsets;
+    NumaVector<std::uint32_t> columns;
+    NumaVector<double> values;
+};
@@ -0,0 +1,404 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Partition.hpp"
+
+// Page placement for the OpenMP targets, selected per run by NUMA_POLICY:
+//   master      - pages are first touched by the master thread (old behaviour)
+//   first_touch - each thread touches the block a static loop will give it (default)
+//   interleave  - pages round-robin over all online nodes (mbind MPOL_INTERLEAVE)
+//   bind        - pages restricted to node NUMA_BIND_NODE, default 0 (mbind MPOL_BIND)
+// NumaAllocator never value-initializes elements, so no page is touched
+// before the policy-aware initialisation runs.
+//
+// Page size of the mapping, selected per run by HUGE_PAGES:
+//   off - base pages (default)
+//   thp - 2 MB aligned mapping with madvise(MADV_HUGEPAGE), so transparent huge
+//         pages are used even when the system setting is "madvise"
+//   2m  - MAP_HUGETLB 2 MB pages from the hugetlbfs pool (vm.nr_hugepages)
+//   1g  - MAP_HUGETLB 1 GB pages
+// When the hugetlbfs pool cannot back a mapping, the allocation warns once
+// and falls back to thp. pageBacking() reports what the kernel actually used.
+
+enum class NumaPolicy {
+    master,
+    firstTouch,
+    interleave,
+    bind
+};
+
+inline const char* numaPolicyName(NumaPolicy policy) {
+    switch (policy) {
+    case NumaPolicy::master: return "master";
+    case NumaPolicy::interleave: return "interleave";
+    case NumaPolicy::bind: return "bind";
+    default: return "first_touch";
+    }
+}
+
+inline bool parseNumaPolicy(const std::string& name, NumaPolicy& policy) {
+    if (name == "master")
+        policy = NumaPolicy::master;
+    else if (name == "first_touch")
+        policy = NumaPolicy::firstTouch;
+    else if (name == "interleave")
+        policy = NumaPolicy::interleave;
+    else if (name == "bind")
+        policy = NumaPolicy::bind;
+    else
+        return false;
+    return true;
+}
+
+inline NumaPolicy numaPolicyFromEnv() {
+    NumaPolicy policy = NumaPolicy::firstTouch;
+    const char* requested = std::getenv("NUMA_POLICY");
+    if (requested != nullptr && !parseNumaPolicy(requested, policy))
+        std::cerr << "Unknown NUMA_POLICY '" << requested << "' (use master|first_touch|interleave|bind), using first_touch\n";
+    return policy;
+}
+
+inline int numaBindNodeFromEnv() {
+    const char* requested = std::getenv("NUMA_BIND_NODE");
+    return (requested != nullptr) ? std::atoi(requested) : 0;
+}
+
+enum class HugePages {
+    off,
+    thp,
+    huge2m,
+    huge1g
+};
+
+inline const char* hugePagesName(HugePages pages) {
+    switch (pages) {
+    case HugePages::thp: return "thp";
+    case HugePages::huge2m: return "2m";
+    case HugePages::huge1g: return "1g";
+    default: return "off";
+    }
+}
+
+inline bool parseHugePages(const std::string& name, HugePages& pages) {
+    if (name == "off")
+        pages = HugePages::off;
+    else if (name == "thp")
+        pages = HugePages::thp;
+    else if (name == "2m")
+        pages = HugePages::huge2m;
+    else if (name == "1g")
+        pages = HugePages::huge1g;
+    else
+        return false;
+    return true;
+}
+
+inline HugePages hugePagesFromEnv() {
+    HugePages pages = HugePages::off;
+    const char* requested = std::getenv("HUGE_PAGES");
+    if (requested != nullptr && !parseHugePages(requested, pages))
+        std::cerr << "Unknown HUGE_PAGES '" << requested << "' (use off|thp|2m|1g), using off\n";
+    return pages;
+}
+
+constexpr std::size_t hugePageBytes2m = std::size_t(1) << 21;
+constexpr std::size_t hugePageBytes1g = std::size_t(1) << 30;
+
+// Length of the mapping behind a request of bytes; a function of the request
+// alone, so the free side recomputes it, whichever path backed the mapping.
+inline std::size_t mappedBytes(std::size_t bytes, HugePages pages) {
+    if (bytes == 0)
+        bytes = 1;
+    if (pages == HugePages::off)
+        return bytes;
+    const std::size_t unit = (pages == HugePages::huge1g) ? hugePageBytes1g : hugePageBytes2m;
+    return (bytes + unit - 1) / unit * unit;
+}
+
+#if defined(__linux__)
+constexpr std::size_t numaMaxNodes = 1024;
+constexpr std::size_t numaMaskBits = 8 * sizeof(unsigned long);
+
+// Parses /sys/devices/system/node/online ("0-1,3") into an mbind node mask.
+inline std::vector<unsigned long> onlineNodeMask() {
+    std::vector<unsigned long> mask(numaMaxNodes / numaMaskBits, 0ul);
+    std::ifstream onlineFile("/sys/devices/system/node/online");
+    std::string nodeList;
+    if (!onlineFile || !std::getline(onlineFile, nodeList) || nodeList.empty())
+        nodeList = "0";
+
+    std::size_t position = 0;
+    while (position < nodeList.size()) {
+        const std::size_t comma = nodeList.find(',', position);
+        const std::string range = nodeList.substr(position, comma == std::string::npos ? std::string::npos : comma - position);
+        const std::size_t dash = range.find('-');
+        const std::size_t first = static_cast<std::size_t>(std::stoul(range.substr(0, dash)));
+        const std::size_t last = (dash == std::string::npos) ? first : static_cast<std::size_t>(std::stoul(range.substr(dash + 1)));
+        for (std::size_t node = first; node <= last && node < numaMaxNodes; ++node)
+            mask[node / numaMaskBits] |= 1ul << (node % numaMaskBits);
+        if (comma == std::string::npos)
+            break;
+        position = comma + 1;
+    }
+    return mask;
+}
+
+inline void applyNumaPolicy(void* address, std::size_t bytes, NumaPolicy policy, int bindNode) {
+    if (policy != NumaPolicy::interleave && policy != NumaPolicy::bind)
+        return;
+
+    std::vector<unsigned long> mask(numaMaxNodes / numaMaskBits, 0ul);
+    int mode = MPOL_INTERLEAVE;
+    if (policy == NumaPolicy::interleave) {
+        mask = onlineNodeMask();
+    }
+    else {
+        mode = MPOL_BIND;
+        const std::size_t node = static_cast<std::size_t>(bindNode < 0 ? 0 : bindNode) % numaMaxNodes;
+        mask[node / numaMaskBits] |= 1ul << (node % numaMaskBits);
+    }
+
+    if (syscall(SYS_mbind, address, bytes, mode, mask.data(), numaMaxNodes + 1, 0) != 0) {
+        static bool warned = false;
+        if (!warned) {
+            warned = true;
+            std::cerr << "mbind(" << numaPolicyName(policy) << ") failed: " << std::strerror(errno)
+                << "; pages fall back to first-touch placement\n";
+        }
+    }
+}
+#endif
+
+#if defined(__linux__)
+// Anonymous mapping of length bytes aligned to 2 MB, over-allocated by one
+// huge page and trimmed, with MADV_HUGEPAGE set on it.
+inline void* mapTransparentHuge(std::size_t bytes) {
+    const std::size_t padded = bytes + hugePageBytes2m;
+    void* raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        return nullptr;
+    const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = (begin + hugePageBytes2m - 1) & ~(std::uintptr_t(hugePageBytes2m) - 1);
+    if (aligned > begin)
+        ::munmap(raw, aligned - begin);
+    const std::size_t tail = padded - (aligned - begin) - bytes;
+    if (tail > 0)
+        ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    void* address = reinterpret_cast<void*>(aligned);
+    if (::madvise(address, bytes, MADV_HUGEPAGE) != 0) {
+        static bool warned = false;
+        if (!warned) {
+            warned = true;
+            std::cerr << "madvise(MADV_HUGEPAGE) failed: " << std::strerror(errno) << "; using base pages\n";
+        }
+    }
+    return address;
+}
+
+inline void* mapHugetlb(std::size_t bytes, HugePages pages) {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    const int sizeLog2 = (pages == HugePages::huge1g) ? 30 : 21;
+    void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (sizeLog2 << MAP_HUGE_SHIFT), -1, 0);
+    if (address != MAP_FAILED)
+        return address;
+    static bool warned = false;
+    if (!warned) {
+        warned = true;
+        std::cerr << "mmap(MAP_HUGETLB, " << hugePagesName(pages) << ") failed: " << std::strerror(errno)
+            << "; falling back to thp\n";
+    }
+#else
+    (void)bytes;
+    (void)pages;
+#endif
+    return nullptr;
+}
+#endif
+
+inline void* numaAllocateBytes(std::size_t bytes, NumaPolicy policy, int bindNode, HugePages pages = HugePages::off) {
+    bytes = mappedBytes(bytes, pages);
+#if defined(__linux__)
+    void* address = nullptr;
+    if (pages == HugePages::huge2m || pages == HugePages::huge1g)
+        address = mapHugetlb(bytes, pages);
+    if (address == nullptr && pages != HugePages::off) {
+        address = mapTransparentHuge(bytes);
+    }
+    else if (address == nullptr) {
+        address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED)
+            address = nullptr;
+    }
+    if (address == nullptr)
+        throw std::bad_alloc();
+    applyNumaPolicy(address, bytes, policy, bindNode);
+    return address;
+#else
+    (void)policy;
+    (void)bindNode;
+    return ::operator new(bytes);
+#endif
+}
+
+inline void numaFreeBytes(void* address, std::size_t bytes, HugePages pages = HugePages::off) {
+    if (address == nullptr)
+        return;
+#if defined(__linux__)
+    ::munmap(address, mappedBytes(bytes, pages));
+#else
+    (void)bytes;
+    (void)pages;
+    ::operator delete(address);
+#endif
+}
+
+// Page backing of the mapping that holds address, from /proc/self/smaps:
+// pageKiB is the largest page size in use (the hugetlbfs page size, 2048 once
+// any transparent huge page is resident, else the base page size) and
+// hugeFraction the share of resident bytes on huge pages. The kernel may have
+// merged the mapping with adjacent anonymous ones; the figures then cover the
+// merged mapping. Both are 0 when smaps is not readable.
+struct PageBacking {
+    std::size_t pageKiB = 0;
+    double hugeFraction = 0.0;
+};
+
+inline PageBacking pageBacking(const void* address) {
+    PageBacking backing;
+#if defined(__linux__)
+    std::ifstream smaps("/proc/self/smaps");
+    const std::uintptr_t target = reinterpret_cast<std::uintptr_t>(address);
+    bool inMapping = false;
+    std::size_t kernelPageKiB = 0;
+    std::size_t rssKiB = 0;
+    std::size_t anonHugeKiB = 0;
+    std::size_t hugetlbKiB = 0;
+    std::string line;
+    while (std::getline(smaps, line)) {
+        unsigned long begin = 0;
+        unsigned long end = 0;
+        char name[64] = {};
+        unsigned long value = 0;
+        if (std::sscanf(line.c_str(), "%lx-%lx ", &begin, &end) == 2 && line.find(':') > line.find(' ')) {
+            if (inMapping)
+                break;
+            inMapping = (target >= begin && target < end);
+        }
+        else if (inMapping && std::sscanf(line.c_str(), "%63[^:]: %lu", name, &value) == 2) {
+            const std::string field = name;
+            if (field == "KernelPageSize")
+                kernelPageKiB = value;
+            else if (field == "Rss")
+                rssKiB = value;
+            else if (field == "AnonHugePages")
+                anonHugeKiB = value;
+            else if (field == "Private_Hugetlb" || field == "Shared_Hugetlb")
+                hugetlbKiB += value;
+        }
+    }
+    if (kernelPageKiB > 4) {
+        backing.pageKiB = kernelPageKiB;
+        backing.hugeFraction = (hugetlbKiB > 0) ? 1.0 : 0.0;
+    }
+    else if (kernelPageKiB > 0) {
+        backing.pageKiB = (anonHugeKiB > 0) ? hugePageBytes2m / 1024 : kernelPageKiB;
+        backing.hugeFraction = (rssKiB > 0) ? static_cast<double>(anonHugeKiB) / static_cast<double>(rssKiB) : 0.0;
+    }
+#else
+    (void)address;
+#endif
+    return backing;
+}
+
+template <typename T>
+class NumaAllocator {
+public:
+    using value_type = T;
+
+    NumaAllocator() = default;
+
+    explicit NumaAllocator(NumaPolicy policy, int bindNode = 0, HugePages pages = HugePages::off)
+        : policy(policy), bindNode(bindNode), pages(pages) {
+    }
+
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U>& other)
+        : policy(other.policy), bindNode(other.bindNode), pages(other.pages) {
+    }
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(numaAllocateBytes(count * sizeof(T), policy, bindNode, pages));
+    }
+
+    void deallocate(T* pointer, std::size_t count) {
+        numaFreeBytes(pointer, count * sizeof(T), pages);
+    }
+
+    // Default-initialisation leaves trivial elements untouched.
+    template <typename U>
+    void construct(U* pointer) {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args) {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+
+    NumaPolicy policy = NumaPolicy::firstTouch;
+    int bindNode = 0;
+    HugePages pages = HugePages::off;
+};
+
+template <typename T, typename U>
+bool operator==(const NumaAllocator<T>& a, const NumaAllocator<U>& b) {
+    return a.policy == b.policy && a.bindNode == b.bindNode && a.pages == b.pages;
+}
+
+template <typename T, typename U>
+bool operator!=(const NumaAllocator<T>& a, const NumaAllocator<U>& b) {
+    return !(a == b);
+}
+
+template <typename T>
+using NumaVector = std::vector<T, NumaAllocator<T>>;
+
+// Runs initRange(beginUnit, endUnit) over [0, units): on the master thread for
+// NumaPolicy::master, otherwise as the static block each thread of the team
+// will later own in a "schedule(static)" loop over the same units.
+template <typename InitRange>
+void initializeWithPolicy(NumaPolicy policy, std::size_t units, InitRange initRange) {
+    if (policy == NumaPolicy::master) {
+        initRange(static_cast<std::size_t>(0), units);
+        return;
+    }
+    #pragma omp parallel
+    {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        staticBlockRange(units, static_cast<std::size_t>(omp_get_thread_num()),
+            static_cast<std::size_t>(omp_get_num_threads()), begin, end);
+        initRange(begin, end);
+    }
+}
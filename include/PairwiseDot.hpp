@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+
+#include "CpuFeatures.hpp"
+
+// Deterministic dot product building blocks. The index space is cut into
+// blocks of dotBlockSize elements regardless of the thread count; every block
+// is summed by the same multi-accumulator kernel and the block partials are
+// folded by a fixed pairwise tree, so the result depends only on the data and
+// the ISA level, never on OMP_NUM_THREADS or the schedule.
+
+constexpr std::size_t dotBlockSize = 4096;
+
+using DotBlockKernel = double (*)(const double* a, const double* b, std::size_t count);
+
+inline double dotBlockScalar(const double* a, const double* b, std::size_t count) {
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc0 += a[i] * b[i];
+        acc1 += a[i + 1] * b[i + 1];
+        acc2 += a[i + 2] * b[i + 2];
+        acc3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < count; ++i)
+        acc0 += a[i] * b[i];
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+#if defined(PT_X86)
+PT_TARGET("avx2,fma")
+inline double dotBlockAvx2(const double* a, const double* b, std::size_t count) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+        acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), acc2);
+        acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), acc3);
+    }
+    const __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    pair = _mm_add_sd(pair, _mm_unpackhi_pd(pair, pair));
+    double result = _mm_cvtsd_f64(pair);
+    for (; i < count; ++i)
+        result += a[i] * b[i];
+    return result;
+}
+
+PT_TARGET("avx512f")
+inline double dotBlockAvx512(const double* a, const double* b, std::size_t count) {
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+        acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), acc2);
+        acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), acc3);
+    }
+    const __m512d acc = _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3));
+    double result = _mm512_reduce_add_pd(acc);
+    for (; i < count; ++i)
+        result += a[i] * b[i];
+    return result;
+}
+#endif
+
+inline DotBlockKernel selectDotBlockKernel(SimdLevel level) {
+#if defined(PT_X86)
+    const CpuFeatures& features = detectCpuFeatures();
+    if (level == SimdLevel::avx512)
+        return &dotBlockAvx512;
+    if (static_cast<int>(level) >= static_cast<int>(SimdLevel::avx2) && features.fma)
+        return &dotBlockAvx2;
+#else
+    (void)level;
+#endif
+    return &dotBlockScalar;
+}
+
+inline const char* dotBlockKernelName(DotBlockKernel kernel) {
+#if defined(PT_X86)
+    if (kernel == &dotBlockAvx512)
+        return "avx512";
+    if (kernel == &dotBlockAvx2)
+        return "avx2";
+#endif
+    (void)kernel;
+    return "scalar";
+}
+
+// Fixed-shape pairwise tree: the split point depends only on count.
+inline double pairwiseSum(const double* values, std::size_t count) {
+    if (count == 0)
+        return 0.0;
+    if (count == 1)
+        return values[0];
+    const std::size_t half = count / 2;
+    return pairwiseSum(values, half) + pairwiseSum(values + half, count - half);
+}
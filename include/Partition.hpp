@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Contiguous split of [0, units) over threadCount workers: the first
+// (units % threadCount) workers get one extra unit. This is the iteration
+// assignment of "#pragma omp for schedule(static)" without a chunk size in
+// both libgomp and libomp, so data touched through it lands where a static
+// loop over the same units will read it.
+inline void staticBlockRange(std::size_t units, std::size_t threadId, std::size_t threadCount,
+    std::size_t& begin, std::size_t& end) {
+    const std::size_t unitsPerThread = units / threadCount;
+    const std::size_t remainder = units % threadCount;
+    begin = threadId * unitsPerThread + std::min(threadId, remainder);
+    end = begin + unitsPerThread + (threadId < remainder ? 1 : 0);
+}
+
+// Contiguous split of [0, units) into threadCount ranges of nearly equal work.
+// workPrefix has units + 1 entries, workPrefix[u] being the work of units
+// [0, u). Worker t gets [bounds[t], bounds[t + 1]); each cut goes to the unit
+// boundary closest to t / threadCount of the total. Units are never split, so
+// a single heavy unit can still leave one worker above its share.
+inline std::vector<std::size_t> balancedBlockBounds(const std::vector<std::size_t>& workPrefix, std::size_t threadCount) {
+    const std::size_t units = workPrefix.size() - 1;
+    const std::size_t totalWork = workPrefix.back();
+    std::vector<std::size_t> bounds(threadCount + 1, units);
+    bounds[0] = 0;
+    for (std::size_t t = 1; t < threadCount; ++t) {
+        const std::size_t target = totalWork / threadCount * t + totalWork % threadCount * t / threadCount;
+        std::size_t cut = static_cast<std::size_t>(std::lower_bound(workPrefix.begin(), workPrefix.end(), target) - workPrefix.begin());
+        if (cut > 0 && target - workPrefix[cut - 1] < workPrefix[cut] - target)
+            --cut;
+        bounds[t] = std::min(units, std::max(bounds[t - 1], cut));
+    }
+    return bounds;
+}
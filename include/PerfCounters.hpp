@@ -0,0 +1,320 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters around the measured runs, read through perf_event_open:
+// cycles, instructions, last-level cache references and misses, branch
+// instructions and misses, and data-TLB load misses. They are counted for every thread of the process
+// in user space only, so the default perf_event_paranoid = 2 allows them.
+// DRAM traffic comes from the memory controllers' CAS counts (uncore_imc);
+// reading these needs system-wide counting (paranoid <= 0 or CAP_PERFMON).
+// Threads are enumerated when the counters are opened, which happens after
+// warm-up, so worker pools started by then are covered and threads started
+// later are not. If a counter cannot be opened (no PMU in a VM or container,
+// another OS, a stricter paranoid level), its columns are NaN and the run
+// still completes. The dTLB event is a generic cache event that not every PMU
+// maps; without it only dtlbMpki is NaN.
+
+enum PerfEventIndex {
+    perfCycles,
+    perfInstructions,
+    perfLlcReferences,
+    perfLlcMisses,
+    perfBranches,
+    perfBranchMisses,
+    perfDtlbLoadMisses,
+    perfEventCount
+};
+
+// Event counts are scaled for multiplexing; dramBytes sums all memory controllers.
+struct PerfTotals {
+    double counts[perfEventCount] = {};
+    double dramBytes = 0.0;
+    bool coreAvailable = false;
+    bool dtlbAvailable = false;
+    bool dramAvailable = false;
+};
+
+struct PerfSummary {
+    double ipc = std::numeric_limits<double>::quiet_NaN();
+    double llcMissRate = std::numeric_limits<double>::quiet_NaN();
+    double branchMissRate = std::numeric_limits<double>::quiet_NaN();
+    double llcMissGBs = std::numeric_limits<double>::quiet_NaN();  // LLC misses * 64 B / s
+    double dramGBs = std::numeric_limits<double>::quiet_NaN();     // memory controller reads + writes
+    double dtlbMpki = std::numeric_limits<double>::quiet_NaN();    // dTLB load misses per 1000 instructions
+};
+
+inline double perfRatio(double numerator, double denominator) {
+    return (denominator > 0.0) ? numerator / denominator : std::numeric_limits<double>::quiet_NaN();
+}
+
+// seconds is the time the counters were enabled for (the sum of the measured runs).
+inline PerfSummary summarizePerf(const PerfTotals& totals, double seconds) {
+    const double llcLineBytes = 64.0;
+    PerfSummary summary;
+    if (totals.coreAvailable) {
+        summary.ipc = perfRatio(totals.counts[perfInstructions], totals.counts[perfCycles]);
+        summary.llcMissRate = perfRatio(totals.counts[perfLlcMisses], totals.counts[perfLlcReferences]);
+        summary.branchMissRate = perfRatio(totals.counts[perfBranchMisses], totals.counts[perfBranches]);
+        summary.llcMissGBs = perfRatio(totals.counts[perfLlcMisses] * llcLineBytes * 1.0e-9, seconds);
+        if (totals.dtlbAvailable)
+            summary.dtlbMpki = perfRatio(totals.counts[perfDtlbLoadMisses] * 1000.0, totals.counts[perfInstructions]);
+    }
+    if (totals.dramAvailable)
+        summary.dramGBs = perfRatio(totals.dramBytes * 1.0e-9, seconds);
+    return summary;
+}
+
+#if defined(__linux__)
+inline int perfEventOpen(perf_event_attr& attr, pid_t tid, int cpu) {
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, cpu, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+inline std::string perfReadFirstLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+inline std::vector<std::string> perfListDirectory(const std::string& path) {
+    std::vector<std::string> names;
+    DIR* directory = opendir(path.c_str());
+    if (directory == nullptr)
+        return names;
+    while (const dirent* entry = readdir(directory)) {
+        const std::string name = entry->d_name;
+        if (name != "." && name != "..")
+            names.push_back(name);
+    }
+    closedir(directory);
+    return names;
+}
+
+// Translates an event spec such as "event=0x04,umask=0x03" into a config
+// value using the PMU's format files ("config:8-15" puts umask at bit 8).
+inline bool perfParseEventConfig(const std::string& pmuPath, const std::string& spec, std::uint64_t& config) {
+    config = 0;
+    std::stringstream terms(spec);
+    std::string term;
+    while (std::getline(terms, term, ',')) {
+        const std::size_t equals = term.find('=');
+        const std::string name = term.substr(0, equals);
+        const std::uint64_t value = (equals == std::string::npos) ? 1 : std::strtoull(term.c_str() + equals + 1, nullptr, 0);
+        const std::string format = perfReadFirstLine(pmuPath + "/format/" + name);
+        if (format.compare(0, 7, "config:") != 0)
+            return false;
+        config |= value << std::strtoul(format.c_str() + 7, nullptr, 10);
+    }
+    return true;
+}
+
+// Parses a cpumask list such as "0,18" or "0-1".
+inline std::vector<int> perfParseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream items(list);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        if (item.empty())
+            continue;
+        const std::size_t dash = item.find('-');
+        const int first = std::atoi(item.c_str());
+        const int last = (dash == std::string::npos) ? first : std::atoi(item.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+#endif
+
+class PerfCounters {
+public:
+    PerfCounters() = default;
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        closeCounters(coreCounters);
+        closeCounters(dramCounters);
+    }
+
+    // Opens the core counters for every thread that exists now and, with
+    // countDram, the memory controller counters (one process per node
+    // should ask for them, since they count the whole socket).
+    void open(bool countDram) {
+#if defined(__linux__)
+        openCore();
+        if (countDram)
+            openDram();
+#else
+        (void)countDram;
+#endif
+    }
+
+    // The counters start disabled. Enabling and disabling go through prctl,
+    // which switches every counter this thread opened with one system call.
+    void start() {
+#if defined(__linux__)
+        if (!coreCounters.empty() || !dramCounters.empty())
+            prctl(PR_TASK_PERF_EVENTS_ENABLE);
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        if (!coreCounters.empty() || !dramCounters.empty())
+            prctl(PR_TASK_PERF_EVENTS_DISABLE);
+#endif
+    }
+
+    PerfTotals totals() const {
+        PerfTotals result;
+        result.coreAvailable = !coreCounters.empty();
+        result.dramAvailable = !dramCounters.empty();
+        for (const Counter& counter : coreCounters) {
+            result.counts[counter.event] += readScaled(counter.fd);
+            if (counter.event == perfDtlbLoadMisses)
+                result.dtlbAvailable = true;
+        }
+        for (const Counter& counter : dramCounters)
+            result.dramBytes += readScaled(counter.fd) * counter.bytesPerCount;
+        return result;
+    }
+
+private:
+    struct Counter {
+        int fd;
+        int event;
+        double bytesPerCount;
+    };
+
+    static void closeCounters(std::vector<Counter>& counters) {
+#if defined(__linux__)
+        for (const Counter& counter : counters)
+            close(counter.fd);
+#endif
+        counters.clear();
+    }
+
+    static double readScaled(int fd) {
+#if defined(__linux__)
+        std::uint64_t values[3] = { 0, 0, 0 }; // value, time enabled, time running
+        if (read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0)
+            return 0.0;
+        return static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+#else
+        (void)fd;
+        return 0.0;
+#endif
+    }
+
+#if defined(__linux__)
+    static perf_event_attr makeAttr(std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return attr;
+    }
+
+    // Every event except the optional dTLB one has to open for the calling
+    // thread, or none are used. A worker thread that exits before its counters
+    // open is skipped; so is the dTLB event of every thread when the calling
+    // thread cannot open it.
+    void openCore() {
+        static const std::uint32_t eventTypes[perfEventCount] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE
+        };
+        static const std::uint64_t eventConfigs[perfEventCount] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+            PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+        };
+        const pid_t selfTid = static_cast<pid_t>(syscall(SYS_gettid));
+        std::vector<pid_t> threads { selfTid };
+        for (const std::string& name : perfListDirectory("/proc/self/task")) {
+            const pid_t tid = static_cast<pid_t>(std::atoi(name.c_str()));
+            if (tid > 0 && tid != selfTid)
+                threads.push_back(tid);
+        }
+
+        bool countDtlb = true;
+        for (pid_t tid : threads) {
+            for (int event = 0; event < perfEventCount; ++event) {
+                if (event == perfDtlbLoadMisses && !countDtlb)
+                    continue;
+                perf_event_attr attr = makeAttr(eventTypes[event], eventConfigs[event]);
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                const int fd = perfEventOpen(attr, tid, -1);
+                if (fd >= 0) {
+                    coreCounters.push_back(Counter { fd, event, 0.0 });
+                }
+                else if (tid == selfTid && event == perfDtlbLoadMisses) {
+                    countDtlb = false;
+                }
+                else if (tid == selfTid) {
+                    closeCounters(coreCounters);
+                    return;
+                }
+            }
+        }
+    }
+
+    // CAS read and write counts of every integrated memory controller, on
+    // the one CPU per socket that the PMU's cpumask names.
+    void openDram() {
+        const std::string devicesPath = "/sys/bus/event_source/devices";
+        for (const std::string& pmuName : perfListDirectory(devicesPath)) {
+            if (pmuName.compare(0, 10, "uncore_imc") != 0)
+                continue;
+            const std::string pmuPath = devicesPath + "/" + pmuName;
+            const std::uint32_t type = static_cast<std::uint32_t>(std::strtoul(perfReadFirstLine(pmuPath + "/type").c_str(), nullptr, 10));
+            const std::vector<int> cpus = perfParseCpuList(perfReadFirstLine(pmuPath + "/cpumask"));
+            for (const char* eventName : { "cas_count_read", "cas_count_write" }) {
+                const std::string eventPath = pmuPath + "/events/" + eventName;
+                std::uint64_t config = 0;
+                if (!perfParseEventConfig(pmuPath, perfReadFirstLine(eventPath), config))
+                    continue;
+                const std::string scaleText = perfReadFirstLine(eventPath + ".scale");
+                const double scale = scaleText.empty() ? 1.0 : std::atof(scaleText.c_str());
+                const double bytesPerCount = (perfReadFirstLine(eventPath + ".unit") == "MiB") ? scale * 1048576.0 : scale;
+                for (int cpu : cpus) {
+                    perf_event_attr attr = makeAttr(type, config);
+                    const int fd = perfEventOpen(attr, -1, cpu);
+                    if (fd < 0) {
+                        closeCounters(dramCounters);
+                        return;
+                    }
+                    dramCounters.push_back(Counter { fd, -1, bytesPerCount });
+                }
+            }
+        }
+    }
+#endif
+
+    std::vector<Counter> coreCounters;
+    std::vector<Counter> dramCounters;
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <omp.h>
+
+#include "Accumulators.hpp"
+#include "WakeSignal.hpp"
+
+// Read -> compute pipeline over a fixed pool of buffer slots, run on the
+// threads of one OpenMP team: the first readers threads read, the rest
+// compute. Readers claim items in order from a shared counter, take a free
+// slot, fill it and queue it; workers take filled slots in any order,
+// consume them and queue them back as free. Both queues are bounded MPMC
+// queues of slot indices, so buffers are never copied and the pool size
+// bounds the memory in flight. With enough workers the throughput is that
+// of the readers; reduction order is left to the caller (results indexed by
+// item are ordered, per-worker partials are not).
+
+// Bounded multi-producer multi-consumer queue of indices (Vyukov's array
+// queue): every cell carries a sequence number that tells producers and
+// consumers whose turn it is, so each operation is one CAS on the shared
+// position plus a store to its own cell. The blocking push/pop spin, then
+// sleep on a WakeSignal.
+class BoundedMpmcQueue {
+public:
+    // capacity is rounded up to a power of two.
+    explicit BoundedMpmcQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool tryPush(std::size_t value) {
+        std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) {
+                return false;
+            }
+            else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(std::size_t& value) {
+        std::size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (difference == 0) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(position + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) {
+                return false;
+            }
+            else {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Waits while the queue is full; adds the time waited to waitSeconds.
+    void push(std::size_t value, SpinBudget& budget, double& waitSeconds) {
+        if (!tryPush(value)) {
+            const auto waitStart = std::chrono::steady_clock::now();
+            notFull.wait(budget, [&]() { return tryPush(value); });
+            waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStart).count();
+        }
+        notEmpty.notifyAll();
+    }
+
+    // Waits while the queue is empty; false once it is closed and drained.
+    bool pop(std::size_t& value, SpinBudget& budget, double& waitSeconds) {
+        bool popped = tryPop(value);
+        if (!popped) {
+            const auto waitStart = std::chrono::steady_clock::now();
+            notEmpty.wait(budget, [&]() {
+                popped = tryPop(value);
+                return popped || closed.load(std::memory_order_acquire);
+            });
+            waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStart).count();
+            // Every push completed before close(), so an empty queue now stays empty.
+            if (!popped)
+                popped = tryPop(value);
+        }
+        if (popped)
+            notFull.notifyAll();
+        return popped;
+    }
+
+    // No push() may follow; wakes every waiting pop().
+    void close() {
+        closed.store(true, std::memory_order_release);
+        notEmpty.notifyAll();
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        std::size_t value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask = 0;
+    alignas(cacheLineSize) std::atomic<std::size_t> enqueuePosition { 0 };
+    alignas(cacheLineSize) std::atomic<std::size_t> dequeuePosition { 0 };
+    alignas(cacheLineSize) std::atomic<bool> closed { false };
+    WakeSignal notEmpty;
+    WakeSignal notFull;
+};
+
+struct PipelineStats {
+    std::size_t readers = 0;
+    std::size_t workers = 0;
+    double readerWaitSeconds = 0.0; // summed over readers, waiting for a free slot
+    double workerWaitSeconds = 0.0; // summed over workers, waiting for a filled slot
+    std::uint64_t sleeps = 0;       // waits on either side that ended asleep
+    bool failed = false;            // some read() returned false
+};
+
+// Runs read(item, slot, reader) and then compute(item, slot, worker) for
+// every item in [0, items) over slots buffers, inside its own parallel
+// region. read() returns false on failure, which stops all readers; the
+// items already read are still computed. With a team of one thread there is
+// no worker, so that thread reads and computes every item itself.
+template <typename Read, typename Compute>
+PipelineStats runPipeline(std::size_t items, std::size_t readers, std::size_t slots, Read read, Compute compute) {
+    slots = std::max<std::size_t>(slots, 1);
+    BoundedMpmcQueue freeSlots(slots);
+    BoundedMpmcQueue filledSlots(slots);
+    std::vector<std::size_t> slotItems(slots);
+    for (std::size_t slot = 0; slot < slots; ++slot)
+        freeSlots.tryPush(slot);
+
+    std::atomic<std::size_t> nextItem { 0 };
+    std::atomic<std::size_t> readersDone { 0 };
+    std::atomic<bool> failed { false };
+    PipelineStats stats;
+
+    #pragma omp parallel
+    {
+        const std::size_t team = static_cast<std::size_t>(omp_get_num_threads());
+        const std::size_t thread = static_cast<std::size_t>(omp_get_thread_num());
+        const std::size_t readerCount = (team == 1) ? 1 : std::min(std::max<std::size_t>(readers, 1), team - 1);
+        SpinBudget budget;
+        double waitSeconds = 0.0;
+
+        if (team == 1) {
+            for (std::size_t item = 0; item < items; ++item) {
+                if (!read(item, 0, 0)) {
+                    failed.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                compute(item, 0, 0);
+            }
+        }
+        else if (thread < readerCount) {
+            while (!failed.load(std::memory_order_relaxed)) {
+                const std::size_t item = nextItem.fetch_add(1, std::memory_order_relaxed);
+                if (item >= items)
+                    break;
+                std::size_t slot = 0;
+                freeSlots.pop(slot, budget, waitSeconds);
+                if (!read(item, slot, thread)) {
+                    failed.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                slotItems[slot] = item;
+                filledSlots.push(slot, budget, waitSeconds);
+            }
+            if (readersDone.fetch_add(1, std::memory_order_acq_rel) + 1 == readerCount)
+                filledSlots.close();
+        }
+        else {
+            const std::size_t worker = thread - readerCount;
+            std::size_t slot = 0;
+            while (filledSlots.pop(slot, budget, waitSeconds)) {
+                compute(slotItems[slot], slot, worker);
+                // Never waits: the pool holds exactly slots indices.
+                freeSlots.push(slot, budget, waitSeconds);
+            }
+        }
+
+        #pragma omp critical
+        {
+            if (thread == 0) {
+                stats.readers = readerCount;
+                stats.workers = (team == 1) ? 1 : team - readerCount;
+            }
+            if (thread < readerCount)
+                stats.readerWaitSeconds += waitSeconds;
+            else
+                stats.workerWaitSeconds += waitSeconds;
+            stats.sleeps += budget.sleeps;
+        }
+    }
+    stats.failed = failed.load();
+    return stats;
+}
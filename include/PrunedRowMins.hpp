@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <omp.h>
+
+#include "Accumulators.hpp"
+#include "SimdMin.hpp"
+
+// Branch-and-bound max of row minima over a dense row-major matrix. The best
+// row min found so far is a shared relaxed atomic; a row is abandoned after
+// the first SIMD block (minUntilBelow) that takes its running min below that
+// bound, since it can no longer be the max. Abandoned rows only ever hold
+// values below the final answer, so the result equals the full scan.
+// Optionally the rows are first ordered by the min of a few sampled elements,
+// largest first, so that rows likely to win are scanned early and the bound
+// tightens quickly. Rows go out in dynamic chunks so the order is roughly kept.
+
+constexpr std::size_t pruneSamplesPerRow = 8;
+constexpr int pruneChunkRows = 8;
+
+// Row indices by decreasing min over pruneSamplesPerRow evenly spaced elements.
+// touched grows by the elements sampled.
+inline std::vector<std::size_t> sampledRowOrder(const double* matrix, std::size_t rows, std::size_t columns, std::size_t& touched) {
+    const std::size_t samples = std::min(pruneSamplesPerRow, columns);
+    std::vector<double> sampleMins(rows);
+    #pragma omp parallel for schedule(static)
+    for (std::size_t i = 0; i < rows; ++i) {
+        const double* rowData = matrix + i * columns;
+        double sampleMin = std::numeric_limits<double>::infinity();
+        for (std::size_t k = 0; k < samples; ++k)
+            sampleMin = std::min(sampleMin, rowData[k * columns / samples]);
+        sampleMins[i] = sampleMin;
+    }
+    touched += rows * samples;
+
+    std::vector<std::size_t> order(rows);
+    for (std::size_t i = 0; i < rows; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return sampleMins[a] > sampleMins[b];
+    });
+    return order;
+}
+
+// order == nullptr scans the rows in index order. Returns the max of row
+// minima; touched grows by the elements read.
+template <typename Kernel>
+double prunedMaxOfRowMins(const double* matrix, std::size_t rows, std::size_t columns,
+    const std::vector<std::size_t>* order, std::size_t& touched) {
+    std::atomic<double> best { std::numeric_limits<double>::lowest() };
+    std::size_t rowTouched = 0;
+
+    #pragma omp parallel for schedule(dynamic, pruneChunkRows) reduction(+:rowTouched)
+    for (std::size_t k = 0; k < rows; ++k) {
+        const std::size_t i = (order != nullptr) ? (*order)[k] : k;
+        const double bound = best.load(std::memory_order_relaxed);
+        const double rowMin = minUntilBelow<Kernel>(matrix + i * columns, columns, bound, rowTouched);
+        if (rowMin >= bound)
+            atomicMaxDouble(best, rowMin);
+    }
+
+    touched += rowTouched;
+    return best.load(std::memory_order_relaxed);
+}
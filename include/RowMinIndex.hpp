@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <omp.h>
+
+// Max of row minima over a dense row-major n x n matrix (the OpenMP_4
+// layout) that stays current under cell updates without rescanning the
+// matrix. The index keeps, per row, the min and the column holding it, and a
+// tournament tree of maxima over the row mins, so the answer is the root.
+//
+// A batch of updates is grouped by row and each touched row is handled by one
+// thread, applying its updates in stream order: a value below the row min
+// becomes the new min, and a value above the min written to the min's own
+// cell is the only case that needs the row rescanned, once, after its last
+// update. Then only the tree paths above changed rows are recomputed, one
+// tree level at a time. The matrix is updated in place.
+
+struct CellUpdate {
+    std::uint32_t row;
+    std::uint32_t column;
+    double value;
+};
+
+// Tree levels with fewer dirty nodes than this are recomputed serially.
+constexpr std::size_t rowMinIndexParallelNodes = 4096;
+
+class RowMinIndex {
+public:
+    RowMinIndex(double* matrix, std::size_t size)
+        : matrix(matrix), size(size), rowMins(size), rowArgMins(size) {
+        leafCount = 1;
+        while (leafCount < size)
+            leafCount *= 2;
+        tree.assign(2 * leafCount, std::numeric_limits<double>::lowest());
+    }
+
+    // Full scan of every row; also the state to compare incremental results with.
+    template <typename Kernel>
+    void rebuild() {
+        #pragma omp parallel for schedule(static)
+        for (std::size_t i = 0; i < size; ++i)
+            scanRow<Kernel>(i);
+        for (std::size_t i = 0; i < size; ++i)
+            tree[leafCount + i] = rowMins[i];
+        for (std::size_t node = leafCount - 1; node >= 1; --node)
+            tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+    }
+
+    double maxOfRowMins() const {
+        return tree[1];
+    }
+
+    double rowMin(std::size_t row) const {
+        return rowMins[row];
+    }
+
+    std::size_t rowArgMin(std::size_t row) const {
+        return rowArgMins[row];
+    }
+
+    // count must fit in 32 bits.
+    template <typename Kernel>
+    void applyBatch(const CellUpdate* updates, std::size_t count) {
+        // Keys (row, position in batch) sort by row and keep stream order
+        // within a row, with plain integer compares.
+        order.resize(count);
+        for (std::size_t k = 0; k < count; ++k)
+            order[k] = (static_cast<std::uint64_t>(updates[k].row) << 32) | k;
+        std::sort(order.begin(), order.end());
+
+        groupStarts.clear();
+        for (std::size_t k = 0; k < count; ++k) {
+            if (k == 0 || (order[k] >> 32) != (order[k - 1] >> 32))
+                groupStarts.push_back(k);
+        }
+        const std::size_t groups = groupStarts.size();
+        groupStarts.push_back(count);
+        groupChanged.assign(groups, 0);
+
+        std::size_t rescanned = 0;
+        #pragma omp parallel for schedule(dynamic, 16) reduction(+:rescanned)
+        for (std::size_t g = 0; g < groups; ++g) {
+            const std::size_t row = static_cast<std::size_t>(order[groupStarts[g]] >> 32);
+            double* rowData = matrix + row * size;
+            const double oldMin = rowMins[row];
+            double newMin = oldMin;
+            std::size_t argMin = rowArgMins[row];
+            bool rescan = false;
+            for (std::size_t k = groupStarts[g]; k < groupStarts[g + 1]; ++k) {
+                const CellUpdate& update = updates[order[k] & 0xffffffffu];
+                rowData[update.column] = update.value;
+                if (rescan)
+                    continue;
+                if (update.value < newMin) {
+                    newMin = update.value;
+                    argMin = update.column;
+                }
+                else if (update.column == argMin && update.value > newMin) {
+                    rescan = true;
+                }
+            }
+            if (rescan) {
+                scanRow<Kernel>(row);
+                ++rescanned;
+            }
+            else {
+                rowMins[row] = newMin;
+                rowArgMins[row] = argMin;
+            }
+            groupChanged[g] = (rowMins[row] != oldMin) ? 1 : 0;
+        }
+        lastRescannedRows = rescanned;
+
+        dirtyNodes.clear();
+        for (std::size_t g = 0; g < groups; ++g) {
+            if (groupChanged[g] != 0) {
+                const std::size_t row = static_cast<std::size_t>(order[groupStarts[g]] >> 32);
+                tree[leafCount + row] = rowMins[row];
+                dirtyNodes.push_back(leafCount + row);
+            }
+        }
+        lastChangedRows = dirtyNodes.size();
+        propagate();
+    }
+
+    // Rows rescanned and row mins changed by the last batch.
+    std::size_t lastRescannedRows = 0;
+    std::size_t lastChangedRows = 0;
+
+private:
+    template <typename Kernel>
+    void scanRow(std::size_t row) {
+        const double* rowData = matrix + row * size;
+        const double minValue = Kernel::run(rowData, size);
+        rowMins[row] = minValue;
+        rowArgMins[row] = static_cast<std::size_t>(std::find(rowData, rowData + size, minValue) - rowData);
+    }
+
+    // dirtyNodes holds ascending nodes of one level; parents of a sorted list
+    // stay sorted, so duplicates are adjacent.
+    void propagate() {
+        while (!dirtyNodes.empty() && dirtyNodes.front() > 1) {
+            std::size_t parents = 0;
+            for (std::size_t k = 0; k < dirtyNodes.size(); ++k) {
+                const std::size_t parent = dirtyNodes[k] / 2;
+                if (parents == 0 || dirtyNodes[parents - 1] != parent)
+                    dirtyNodes[parents++] = parent;
+            }
+            dirtyNodes.resize(parents);
+            #pragma omp parallel for schedule(static) if (parents >= rowMinIndexParallelNodes)
+            for (std::size_t k = 0; k < parents; ++k) {
+                const std::size_t node = dirtyNodes[k];
+                tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+            }
+        }
+    }
+
+    double* matrix;
+    std::size_t size;
+    std::size_t leafCount = 1;
+    std::vector<double> rowMins;
+    std::vector<std::size_t> rowArgMins;
+    std::vector<double> tree;
+
+    // Per-batch scratch, kept to avoid reallocating on every batch.
+    std::vector<std::uint64_t> order;
+    std::vector<std::size_t> groupStarts;
+    std::vector<unsigned char> groupChanged;
+    std::vector<std::size_t> dirtyNodes;
+};
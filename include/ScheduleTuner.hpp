@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+// Online choice of the runtime schedule (omp_sched_t, chunk) for a loop that
+// is run through "schedule(runtime)". At most the first TUNE_FRACTION of the
+// iterations (env, default 0.2) are spent on successive halving: the budget
+// is split evenly over the rounds, every surviving (kind, chunk) candidate
+// runs an equal slice of its round's share and the faster half goes on, until
+// one is left. The rest of the loop runs with the winner.
+//
+// Consecutive slices can differ in cost (e.g. rows that grow with i), so
+// candidates are ranked by work per second, where the caller passes the
+// prefix sum of per-iteration work (iterations per second without one).
+// Each candidate's slice is also run as two halves in mirrored order (A B C
+// ... C B A), so a cost that drifts along the range evens out between
+// candidates. No half is shorter than scheduleTunerMinSlice iterations, so
+// that a slice is not dominated by the fork and join of its region; when the
+// budget is too small for all twelve candidates, only the first ones of the
+// list (ordered so that any prefix spans the kinds and chunk sizes) take
+// part. A loop whose budget does not fit two candidates is not explored: it
+// runs a fixed fallback, which is reported as such and not cached.
+//
+// Winners are kept in a small text file, TUNE_CACHE (env, default
+// schedule_tuner.cache in the working directory), one "signature<TAB>kind
+// <TAB>chunk" line per loop signature. The caller builds the signature from
+// whatever decides the best schedule (problem size, work distribution, thread
+// count); a signature found in the file skips exploration entirely. Within a
+// process the winner of the first run is reused by the later ones. Writers do
+// not lock the file, so concurrent tuning runs may drop each other's entries.
+
+inline const char* ompScheduleName(omp_sched_t kind) {
+    switch (kind) {
+    case omp_sched_dynamic: return "dynamic";
+    case omp_sched_guided: return "guided";
+    case omp_sched_auto: return "auto";
+    default: return "static";
+    }
+}
+
+inline bool parseOmpSchedule(const std::string& name, omp_sched_t& kind) {
+    if (name == "static")
+        kind = omp_sched_static;
+    else if (name == "dynamic")
+        kind = omp_sched_dynamic;
+    else if (name == "guided")
+        kind = omp_sched_guided;
+    else
+        return false;
+    return true;
+}
+
+constexpr std::size_t scheduleTunerMinSlice = 32;
+
+// Cache lines of earlier tuners that ranked differently are ignored.
+constexpr const char* scheduleTunerCacheVersion = "v2";
+
+struct ScheduleChoice {
+    omp_sched_t kind = omp_sched_static;
+    int chunk = 1;
+};
+
+// Schedule run without exploration when the budget is too small.
+constexpr ScheduleChoice scheduleTunerFallback { omp_sched_dynamic, 8 };
+
+class ScheduleTuner {
+public:
+    explicit ScheduleTuner(const std::string& loopSignature)
+        : signature(std::string(scheduleTunerCacheVersion) + " " + loopSignature) {
+        const char* fraction = std::getenv("TUNE_FRACTION");
+        if (fraction != nullptr)
+            tuneFraction = std::atof(fraction);
+        if (!(tuneFraction > 0.0 && tuneFraction < 1.0)) {
+            if (fraction != nullptr)
+                std::cerr << "TUNE_FRACTION must be in (0, 1), using 0.2\n";
+            tuneFraction = 0.2;
+        }
+        const char* path = std::getenv("TUNE_CACHE");
+        cachePath = (path != nullptr) ? path : "schedule_tuner.cache";
+        fromCache = loadCached();
+        known = fromCache;
+    }
+
+    // Runs runSlice(begin, end) over consecutive slices of [0, iterations);
+    // runSlice must run its slice as a schedule(runtime) loop. workPrefix,
+    // if given, has iterations + 1 entries, workPrefix[i] being the work of
+    // iterations [0, i). The runtime schedule is left at the winner.
+    template <typename RunSlice>
+    void run(std::size_t iterations, RunSlice runSlice, const std::vector<std::size_t>* workPrefix = nullptr) {
+        std::size_t next = 0;
+        exploreSeconds = 0.0;
+        if (!known) {
+            const auto exploreStart = std::chrono::steady_clock::now();
+            next = explore(iterations, runSlice, workPrefix);
+            exploreSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - exploreStart).count();
+            known = true;
+            if (!fallback)
+                storeCached();
+        }
+        omp_set_schedule(choice.kind, choice.chunk);
+        if (next < iterations)
+            runSlice(next, iterations);
+    }
+
+    // "kind:chunk" of the winner.
+    std::string winnerName() const {
+        return std::string(ompScheduleName(choice.kind)) + ":" + std::to_string(choice.chunk);
+    }
+
+    // explored | cache | fallback: where the schedule in use came from.
+    const char* sourceName() const {
+        return fromCache ? "cache" : (fallback ? "fallback" : "explored");
+    }
+
+    // Whether the winner came from the cache file rather than this process.
+    bool fromCache = false;
+    // Whether the budget was too small to explore (scheduleTunerFallback).
+    bool fallback = false;
+    // Exploration time of the last run() (0 when it had a winner already).
+    double exploreSeconds = 0.0;
+
+private:
+    template <typename RunSlice>
+    std::size_t explore(std::size_t iterations, RunSlice& runSlice, const std::vector<std::size_t>* workPrefix) {
+        struct Candidate {
+            ScheduleChoice choice;
+            double work;
+            double seconds;
+        };
+        // Every prefix of the list mixes kinds and chunk sizes, so a budget
+        // that fits only a few candidates still compares unlike schedules.
+        std::vector<Candidate> candidates;
+        const ScheduleChoice order[] = {
+            { omp_sched_dynamic, 8 }, { omp_sched_static, 64 }, { omp_sched_guided, 1 },
+            { omp_sched_static, 1 }, { omp_sched_dynamic, 64 }, { omp_sched_guided, 8 },
+            { omp_sched_dynamic, 1 }, { omp_sched_static, 512 }, { omp_sched_guided, 64 },
+            { omp_sched_static, 8 }, { omp_sched_dynamic, 512 }, { omp_sched_guided, 512 },
+        };
+        for (const ScheduleChoice& candidate : order)
+            candidates.push_back(Candidate { candidate, 0.0, 0.0 });
+
+        auto workOf = [&](std::size_t begin, std::size_t end) {
+            return (workPrefix != nullptr) ? static_cast<double>((*workPrefix)[end] - (*workPrefix)[begin]) : static_cast<double>(end - begin);
+        };
+        auto runHalf = [&](Candidate& candidate, std::size_t begin, std::size_t end) {
+            omp_set_schedule(candidate.choice.kind, candidate.choice.chunk);
+            const auto start = std::chrono::steady_clock::now();
+            runSlice(begin, end);
+            candidate.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            candidate.work += workOf(begin, end);
+        };
+        auto rate = [](const Candidate& candidate) {
+            return candidate.work / std::max(candidate.seconds, 1e-9);
+        };
+
+        const std::size_t budget = static_cast<std::size_t>(static_cast<double>(iterations) * tuneFraction);
+        auto roundsFor = [](std::size_t count) {
+            return static_cast<std::size_t>(std::ceil(std::log2(static_cast<double>(count))));
+        };
+        // The most candidates whose rounds all fit the budget at the minimum
+        // slice; later rounds have fewer candidates, so their slices grow.
+        while (candidates.size() >= 2 && 2 * scheduleTunerMinSlice * candidates.size() * roundsFor(candidates.size()) > budget)
+            candidates.pop_back();
+        if (candidates.size() < 2) {
+            fallback = true;
+            choice = scheduleTunerFallback;
+            return 0;
+        }
+
+        const std::size_t rounds = roundsFor(candidates.size());
+        std::size_t next = 0;
+        while (candidates.size() > 1) {
+            const std::size_t half = budget / rounds / candidates.size() / 2;
+            for (Candidate& candidate : candidates) {
+                candidate.work = 0.0;
+                candidate.seconds = 0.0;
+            }
+            for (std::size_t k = 0; k < candidates.size(); ++k, next += half)
+                runHalf(candidates[k], next, next + half);
+            for (std::size_t k = candidates.size(); k > 0; --k, next += half)
+                runHalf(candidates[k - 1], next, next + half);
+            std::stable_sort(candidates.begin(), candidates.end(), [&](const Candidate& a, const Candidate& b) {
+                return rate(a) > rate(b);
+            });
+            candidates.resize((candidates.size() + 1) / 2);
+        }
+        choice = candidates.front().choice;
+        return next;
+    }
+
+    bool loadCached() {
+        std::ifstream cache(cachePath);
+        std::string line;
+        while (std::getline(cache, line)) {
+            if (line.compare(0, signature.size() + 1, signature + "\t") != 0)
+                continue;
+            const std::size_t firstTab = signature.size();
+            const std::size_t secondTab = line.find('\t', firstTab + 1);
+            if (secondTab == std::string::npos)
+                continue;
+            ScheduleChoice cached;
+            if (!parseOmpSchedule(line.substr(firstTab + 1, secondTab - firstTab - 1), cached.kind))
+                continue;
+            cached.chunk = std::atoi(line.c_str() + secondTab + 1);
+            if (cached.chunk <= 0)
+                continue;
+            choice = cached;
+            return true;
+        }
+        return false;
+    }
+
+    void storeCached() const {
+        std::vector<std::string> lines;
+        {
+            std::ifstream cache(cachePath);
+            std::string line;
+            while (std::getline(cache, line)) {
+                if (line.compare(0, signature.size() + 1, signature + "\t") != 0)
+                    lines.push_back(line);
+            }
+        }
+        lines.push_back(signature + "\t" + ompScheduleName(choice.kind) + "\t" + std::to_string(choice.chunk));
+        std::ofstream cache(cachePath, std::ios::trunc);
+        if (!cache) {
+            std::cerr << "Cannot write " << cachePath << "; the tuned schedule is not cached\n";
+            return;
+        }
+        for (const std::string& line : lines)
+            cache << line << '\n';
+    }
+
+    std::string signature;
+    std::string cachePath;
+    double tuneFraction = 0.2;
+    bool known = false;
+    ScheduleChoice choice;
+};
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "CpuFeatures.hpp"
+
+// Hand-vectorized min kernels for double, float and int32 elements. Each ISA
+// path keeps four independent vector accumulators so the min dependency chain
+// does not limit throughput, then folds them horizontally and finishes the
+// tail in scalar code. Every comparison is a select (min instructions in the
+// vector paths), so the kernels do not branch on the data.
+//
+// MinKernel<T, level>::run is one instantiation of the family. withMinKernel()
+// turns a runtime SimdLevel into that type once, outside the caller's loops,
+// so the loops themselves are compiled for a fixed element type and ISA.
+
+template <typename T>
+constexpr T minIdentity() {
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
+template <typename T>
+inline T minScalar(const T* data, std::size_t count) {
+    T acc0 = minIdentity<T>();
+    T acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc0 = (data[i] < acc0) ? data[i] : acc0;
+        acc1 = (data[i + 1] < acc1) ? data[i + 1] : acc1;
+        acc2 = (data[i + 2] < acc2) ? data[i + 2] : acc2;
+        acc3 = (data[i + 3] < acc3) ? data[i + 3] : acc3;
+    }
+    for (; i < count; ++i)
+        acc0 = (data[i] < acc0) ? data[i] : acc0;
+    acc0 = (acc1 < acc0) ? acc1 : acc0;
+    acc2 = (acc3 < acc2) ? acc3 : acc2;
+    return (acc2 < acc0) ? acc2 : acc0;
+}
+
+#if defined(PT_X86)
+// Vector operations per ISA and element type: set1, unaligned load, lane-wise
+// min and the horizontal min of one vector.
+template <typename T>
+struct MinOpsSse41;
+
+template <>
+struct MinOpsSse41<double> {
+    using Vec = __m128d;
+    static constexpr std::size_t width = 2;
+    PT_TARGET("sse4.1") static Vec set1(double value) { return _mm_set1_pd(value); }
+    PT_TARGET("sse4.1") static Vec load(const double* data) { return _mm_loadu_pd(data); }
+    PT_TARGET("sse4.1") static Vec min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+    PT_TARGET("sse4.1") static double reduce(Vec a) {
+        return _mm_cvtsd_f64(_mm_min_pd(a, _mm_unpackhi_pd(a, a)));
+    }
+};
+
+template <>
+struct MinOpsSse41<float> {
+    using Vec = __m128;
+    static constexpr std::size_t width = 4;
+    PT_TARGET("sse4.1") static Vec set1(float value) { return _mm_set1_ps(value); }
+    PT_TARGET("sse4.1") static Vec load(const float* data) { return _mm_loadu_ps(data); }
+    PT_TARGET("sse4.1") static Vec min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+    PT_TARGET("sse4.1") static float reduce(Vec a) {
+        a = _mm_min_ps(a, _mm_movehl_ps(a, a));
+        a = _mm_min_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)));
+        return _mm_cvtss_f32(a);
+    }
+};
+
+template <>
+struct MinOpsSse41<int> {
+    using Vec = __m128i;
+    static constexpr std::size_t width = 4;
+    PT_TARGET("sse4.1") static Vec set1(int value) { return _mm_set1_epi32(value); }
+    PT_TARGET("sse4.1") static Vec load(const int* data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+    PT_TARGET("sse4.1") static Vec min(Vec a, Vec b) { return _mm_min_epi32(a, b); }
+    PT_TARGET("sse4.1") static int reduce(Vec a) {
+        a = _mm_min_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+        a = _mm_min_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(a);
+    }
+};
+
+template <typename T>
+struct MinOpsAvx2;
+
+template <>
+struct MinOpsAvx2<double> {
+    using Vec = __m256d;
+    static constexpr std::size_t width = 4;
+    PT_TARGET("avx2") static Vec set1(double value) { return _mm256_set1_pd(value); }
+    PT_TARGET("avx2") static Vec load(const double* data) { return _mm256_loadu_pd(data); }
+    PT_TARGET("avx2") static Vec min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+    PT_TARGET("avx2") static double reduce(Vec a) {
+        return MinOpsSse41<double>::reduce(_mm_min_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1)));
+    }
+};
+
+template <>
+struct MinOpsAvx2<float> {
+    using Vec = __m256;
+    static constexpr std::size_t width = 8;
+    PT_TARGET("avx2") static Vec set1(float value) { return _mm256_set1_ps(value); }
+    PT_TARGET("avx2") static Vec load(const float* data) { return _mm256_loadu_ps(data); }
+    PT_TARGET("avx2") static Vec min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+    PT_TARGET("avx2") static float reduce(Vec a) {
+        return MinOpsSse41<float>::reduce(_mm_min_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+};
+
+template <>
+struct MinOpsAvx2<int> {
+    using Vec = __m256i;
+    static constexpr std::size_t width = 8;
+    PT_TARGET("avx2") static Vec set1(int value) { return _mm256_set1_epi32(value); }
+    PT_TARGET("avx2") static Vec load(const int* data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)); }
+    PT_TARGET("avx2") static Vec min(Vec a, Vec b) { return _mm256_min_epi32(a, b); }
+    PT_TARGET("avx2") static int reduce(Vec a) {
+        return MinOpsSse41<int>::reduce(_mm_min_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1)));
+    }
+};
+
+template <typename T>
+struct MinOpsAvx512;
+
+template <>
+struct MinOpsAvx512<double> {
+    using Vec = __m512d;
+    static constexpr std::size_t width = 8;
+    PT_TARGET("avx512f") static Vec set1(double value) { return _mm512_set1_pd(value); }
+    PT_TARGET("avx512f") static Vec load(const double* data) { return _mm512_loadu_pd(data); }
+    PT_TARGET("avx512f") static Vec min(Vec a, Vec b) { return _mm512_min_pd(a, b); }
+    PT_TARGET("avx512f") static double reduce(Vec a) { return _mm512_reduce_min_pd(a); }
+};
+
+template <>
+struct MinOpsAvx512<float> {
+    using Vec = __m512;
+    static constexpr std::size_t width = 16;
+    PT_TARGET("avx512f") static Vec set1(float value) { return _mm512_set1_ps(value); }
+    PT_TARGET("avx512f") static Vec load(const float* data) { return _mm512_loadu_ps(data); }
+    PT_TARGET("avx512f") static Vec min(Vec a, Vec b) { return _mm512_min_ps(a, b); }
+    PT_TARGET("avx512f") static float reduce(Vec a) { return _mm512_reduce_min_ps(a); }
+};
+
+template <>
+struct MinOpsAvx512<int> {
+    using Vec = __m512i;
+    static constexpr std::size_t width = 16;
+    PT_TARGET("avx512f") static Vec set1(int value) { return _mm512_set1_epi32(value); }
+    PT_TARGET("avx512f") static Vec load(const int* data) { return _mm512_loadu_si512(data); }
+    PT_TARGET("avx512f") static Vec min(Vec a, Vec b) { return _mm512_min_epi32(a, b); }
+    PT_TARGET("avx512f") static int reduce(Vec a) { return _mm512_reduce_min_epi32(a); }
+};
+
+// The kernel bodies are identical per ISA; each needs its own target attribute
+// so the operations above inline into it.
+template <typename T>
+PT_TARGET("sse4.1")
+inline T minSse41(const T* data, std::size_t count) {
+    using Ops = MinOpsSse41<T>;
+    constexpr std::size_t width = Ops::width;
+    const typename Ops::Vec init = Ops::set1(minIdentity<T>());
+    typename Ops::Vec acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+    std::size_t i = 0;
+    for (; i + 4 * width <= count; i += 4 * width) {
+        acc0 = Ops::min(acc0, Ops::load(data + i));
+        acc1 = Ops::min(acc1, Ops::load(data + i + width));
+        acc2 = Ops::min(acc2, Ops::load(data + i + 2 * width));
+        acc3 = Ops::min(acc3, Ops::load(data + i + 3 * width));
+    }
+    for (; i + width <= count; i += width)
+        acc0 = Ops::min(acc0, Ops::load(data + i));
+    T result = Ops::reduce(Ops::min(Ops::min(acc0, acc1), Ops::min(acc2, acc3)));
+    for (; i < count; ++i)
+        result = (data[i] < result) ? data[i] : result;
+    return result;
+}
+
+template <typename T>
+PT_TARGET("avx2")
+inline T minAvx2(const T* data, std::size_t count) {
+    using Ops = MinOpsAvx2<T>;
+    constexpr std::size_t width = Ops::width;
+    const typename Ops::Vec init = Ops::set1(minIdentity<T>());
+    typename Ops::Vec acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+    std::size_t i = 0;
+    for (; i + 4 * width <= count; i += 4 * width) {
+        acc0 = Ops::min(acc0, Ops::load(data + i));
+        acc1 = Ops::min(acc1, Ops::load(data + i + width));
+        acc2 = Ops::min(acc2, Ops::load(data + i + 2 * width));
+        acc3 = Ops::min(acc3, Ops::load(data + i + 3 * width));
+    }
+    for (; i + width <= count; i += width)
+        acc0 = Ops::min(acc0, Ops::load(data + i));
+    T result = Ops::reduce(Ops::min(Ops::min(acc0, acc1), Ops::min(acc2, acc3)));
+    for (; i < count; ++i)
+        result = (data[i] < result) ? data[i] : result;
+    return result;
+}
+
+template <typename T>
+PT_TARGET("avx512f")
+inline T minAvx512(const T* data, std::size_t count) {
+    using Ops = MinOpsAvx512<T>;
+    constexpr std::size_t width = Ops::width;
+    const typename Ops::Vec init = Ops::set1(minIdentity<T>());
+    typename Ops::Vec acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+    std::size_t i = 0;
+    for (; i + 4 * width <= count; i += 4 * width) {
+        acc0 = Ops::min(acc0, Ops::load(data + i));
+        acc1 = Ops::min(acc1, Ops::load(data + i + width));
+        acc2 = Ops::min(acc2, Ops::load(data + i + 2 * width));
+        acc3 = Ops::min(acc3, Ops::load(data + i + 3 * width));
+    }
+    for (; i + width <= count; i += width)
+        acc0 = Ops::min(acc0, Ops::load(data + i));
+    T result = Ops::reduce(Ops::min(Ops::min(acc0, acc1), Ops::min(acc2, acc3)));
+    for (; i < count; ++i)
+        result = (data[i] < result) ? data[i] : result;
+    return result;
+}
+#endif
+
+template <typename T, SimdLevel Level>
+struct MinKernel {
+    static constexpr SimdLevel level = SimdLevel::scalar;
+
+    static T run(const T* data, std::size_t count) {
+        return minScalar(data, count);
+    }
+};
+
+#if defined(PT_X86)
+template <typename T>
+struct MinKernel<T, SimdLevel::sse41> {
+    static constexpr SimdLevel level = SimdLevel::sse41;
+
+    static T run(const T* data, std::size_t count) {
+        return minSse41(data, count);
+    }
+};
+
+template <typename T>
+struct MinKernel<T, SimdLevel::avx2> {
+    static constexpr SimdLevel level = SimdLevel::avx2;
+
+    static T run(const T* data, std::size_t count) {
+        return minAvx2(data, count);
+    }
+};
+
+template <typename T>
+struct MinKernel<T, SimdLevel::avx512> {
+    static constexpr SimdLevel level = SimdLevel::avx512;
+
+    static T run(const T* data, std::size_t count) {
+        return minAvx512(data, count);
+    }
+};
+#endif
+
+// Calls body(MinKernel<T, level>()) for the given level and returns its result.
+// Every call site instantiates body once per ISA.
+template <typename T, typename Body>
+decltype(auto) withMinKernel(SimdLevel level, Body&& body) {
+#if defined(PT_X86)
+    switch (level) {
+    case SimdLevel::avx512: return body(MinKernel<T, SimdLevel::avx512>());
+    case SimdLevel::avx2: return body(MinKernel<T, SimdLevel::avx2>());
+    case SimdLevel::sse41: return body(MinKernel<T, SimdLevel::sse41>());
+    default: break;
+    }
+#else
+    (void)level;
+#endif
+    return body(MinKernel<T, SimdLevel::scalar>());
+}
+
+// The same kernels behind a function pointer, for callers that pick one at
+// run time and call it on a few large blocks.
+template <typename T>
+using MinKernelFunction = T (*)(const T* data, std::size_t count);
+
+template <typename T>
+MinKernelFunction<T> selectMinKernel(SimdLevel level) {
+    return withMinKernel<T>(level, [](auto kernel) -> MinKernelFunction<T> {
+        return &decltype(kernel)::run;
+    });
+}
+
+// Elements per block of minUntilBelow.
+constexpr std::size_t minPruneBlock = 256;
+
+// Min of data[0, count) through Kernel, one block of minPruneBlock elements at
+// a time, giving up after the first block that takes the running min below
+// bound. The result is the exact min when that is >= bound and some value
+// below bound otherwise; touched grows by the elements read.
+template <typename Kernel, typename T>
+T minUntilBelow(const T* data, std::size_t count, T bound, std::size_t& touched) {
+    T result = minIdentity<T>();
+    std::size_t scanned = 0;
+    while (scanned < count) {
+        const std::size_t blockCount = (count - scanned < minPruneBlock) ? count - scanned : minPruneBlock;
+        const T blockMin = Kernel::run(data + scanned, blockCount);
+        result = (blockMin < result) ? blockMin : result;
+        scanned += blockCount;
+        if (result < bound)
+            break;
+    }
+    touched += scanned;
+    return result;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "Accumulators.hpp"
+#include "WakeSignal.hpp"
+
+// Bounded single-producer single-consumer ring of slot indices; the caller
+// owns one buffer per slot and fills or drains it in place, so nothing is
+// copied through the ring. Head (consumer position) and tail (producer
+// position) live on separate cache lines, and each side keeps its last view
+// of the other's position so that it only reads the shared line when the
+// ring looked full or empty. A side that has to wait spins, then sleeps on a
+// WakeSignal (WakeSignal.hpp).
+//
+// Producer: acquireWrite(), fill the slot, publish(); close() after the last.
+// Consumer: acquireRead(slot) until it returns false, release() after each.
+// Time spent waiting is summed per side, from the moment the ring is found
+// full (empty) until a slot is available.
+
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : slots(capacity == 0 ? 1 : capacity) {
+    }
+
+    std::size_t capacity() const {
+        return slots;
+    }
+
+    // Producer only; waits while every slot is in use.
+    std::size_t acquireWrite() {
+        const std::size_t position = producer.tail.load(std::memory_order_relaxed);
+        if (position - producer.cachedHead >= slots) {
+            producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+            if (position - producer.cachedHead >= slots) {
+                const auto waitStart = std::chrono::steady_clock::now();
+                notFull.wait(producer.budget, [&]() {
+                    producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+                    return position - producer.cachedHead < slots;
+                });
+                producer.waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStart).count();
+            }
+        }
+        return position % slots;
+    }
+
+    // Producer only; hands the slot from acquireWrite() to the consumer.
+    void publish() {
+        producer.tail.store(producer.tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        notEmpty.notifyAll();
+    }
+
+    // Producer only; no publish() may follow.
+    void close() {
+        closed.store(true, std::memory_order_release);
+        notEmpty.notifyAll();
+    }
+
+    // Consumer only; false once the ring is closed and drained.
+    bool acquireRead(std::size_t& slot) {
+        const std::size_t position = consumer.head.load(std::memory_order_relaxed);
+        if (position == consumer.cachedTail) {
+            consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+            if (position == consumer.cachedTail) {
+                const auto waitStart = std::chrono::steady_clock::now();
+                notEmpty.wait(consumer.budget, [&]() {
+                    consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+                    return position != consumer.cachedTail || closed.load(std::memory_order_acquire);
+                });
+                consumer.waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStart).count();
+                // Publishes before close() are visible once closed is.
+                consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+                if (position == consumer.cachedTail)
+                    return false;
+            }
+        }
+        slot = position % slots;
+        return true;
+    }
+
+    // Consumer only; returns the slot from acquireRead() to the producer.
+    void release() {
+        consumer.head.store(consumer.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        notFull.notifyAll();
+    }
+
+    double producerWaitSeconds() const {
+        return producer.waitSeconds;
+    }
+
+    double consumerWaitSeconds() const {
+        return consumer.waitSeconds;
+    }
+
+    // Waits that ended asleep on either side.
+    std::uint64_t sleeps() const {
+        return producer.budget.sleeps + consumer.budget.sleeps;
+    }
+
+private:
+    struct alignas(cacheLineSize) ProducerSide {
+        std::atomic<std::size_t> tail { 0 };
+        std::size_t cachedHead = 0;
+        SpinBudget budget;
+        double waitSeconds = 0.0;
+    };
+
+    struct alignas(cacheLineSize) ConsumerSide {
+        std::atomic<std::size_t> head { 0 };
+        std::size_t cachedTail = 0;
+        SpinBudget budget;
+        double waitSeconds = 0.0;
+    };
+
+    const std::size_t slots;
+    ProducerSide producer;
+    ConsumerSide consumer;
+    alignas(cacheLineSize) std::atomic<bool> closed { false };
+    WakeSignal notEmpty;
+    WakeSignal notFull;
+};
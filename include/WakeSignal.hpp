@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+
+#include "Accumulators.hpp"
+#include "CpuFeatures.hpp"
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+// Spin-then-block waiting for a condition another thread makes true. A
+// waiter polls ready() for up to its SpinBudget, then sleeps on a futex word
+// (a mutex and condition variable where there is no futex) until the other
+// side calls notifyAll() after making the condition true. notifyAll() costs
+// one atomic increment unless a waiter is actually asleep.
+//
+// The budget adapts per waiter: it doubles when the condition came true
+// while spinning and halves when the waiter had to sleep, so a waiter on a
+// side that is usually fast enough keeps spinning and one that usually waits
+// for long stops burning its core.
+
+inline void cpuRelax() {
+#if defined(PT_X86)
+    _mm_pause();
+#endif
+}
+
+struct SpinBudget {
+    static constexpr int minSpins = 16;
+    static constexpr int maxSpins = 1 << 14;
+
+    int spins = 1024;
+    // Waits that ended asleep rather than spinning.
+    std::uint64_t sleeps = 0;
+
+    void spinSucceeded() {
+        spins = std::min(spins * 2, maxSpins);
+    }
+
+    void slept() {
+        spins = std::max(spins / 2, minSpins);
+        ++sleeps;
+    }
+};
+
+class WakeSignal {
+public:
+    // Returns once ready() is true. ready() must only read state that the
+    // notifying side publishes before its notifyAll().
+    template <typename Ready>
+    void wait(SpinBudget& budget, Ready ready) {
+        for (int spin = 0; spin < budget.spins; ++spin) {
+            if (ready()) {
+                budget.spinSucceeded();
+                return;
+            }
+            cpuRelax();
+        }
+        while (true) {
+            // The sequence is read before the sleeper count is raised: a
+            // notifyAll() after this read either changes the word, so the
+            // sleep below returns at once, or is seen by the re-check.
+            const std::uint32_t observed = sequence.load(std::memory_order_seq_cst);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            if (ready()) {
+                sleepers.fetch_sub(1, std::memory_order_seq_cst);
+                break;
+            }
+            sleep(observed);
+            sleepers.fetch_sub(1, std::memory_order_seq_cst);
+            if (ready())
+                break;
+        }
+        budget.slept();
+    }
+
+    void notifyAll() {
+        sequence.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) != 0)
+            wake();
+    }
+
+private:
+#if defined(__linux__)
+    void sleep(std::uint32_t observed) {
+        // Returns at once if the word no longer holds observed; spurious
+        // wake-ups are handled by the caller's loop.
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&sequence), FUTEX_WAIT_PRIVATE, observed, nullptr, nullptr, 0);
+    }
+
+    void wake() {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&sequence), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    void sleep(std::uint32_t observed) {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return sequence.load(std::memory_order_seq_cst) != observed; });
+    }
+
+    void wake() {
+        { std::lock_guard<std::mutex> lock(mutex); }
+        condition.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+#endif
+
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be a plain 32-bit integer");
+
+    alignas(cacheLineSize) std::atomic<std::uint32_t> sequence { 0 };
+    std::atomic<std::uint32_t> sleepers { 0 };
+};
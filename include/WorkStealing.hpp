@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Accumulators.hpp"
+#include "Partition.hpp"
+
+// Work stealing over an iteration range on std::thread workers, as a
+// hand-written alternative to the OpenMP runtime's loop schedules.
+//
+// Every worker owns a Chase-Lev deque of iteration ranges (Chase & Lev,
+// SPAA'05, with the C11 orderings of Le et al., PPoPP'13) and starts with its
+// static block (staticBlockRange). A worker takes the range at the bottom of
+// its own deque and, while it is longer than grain, pushes the upper half
+// back and keeps the lower half; so the top of a deque always holds half of
+// what its owner has left. An idle worker steals that top range from a
+// random victim and splits it the same way. A deque never holds more than
+// one range per halving, so it has a fixed capacity.
+
+struct IterationRange {
+    std::size_t begin;
+    std::size_t end;
+};
+
+class ChaseLevDeque {
+public:
+    static constexpr std::int64_t capacity = 128;
+
+    // Owner only.
+    void push(IterationRange range) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::size_t slot = static_cast<std::size_t>(b % capacity);
+        begins[slot].store(range.begin, std::memory_order_relaxed);
+        ends[slot].store(range.end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only; takes the most recently pushed range.
+    bool pop(IterationRange& range) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        readSlot(b, range);
+        if (t == b) {
+            // Last range: race the thieves for it.
+            const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread; takes the oldest range. Fails when empty or on a lost race.
+    bool steal(IterationRange& range) {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+        // A slot is only rewritten once its range has been taken, so a torn
+        // read here is always followed by a failing CAS.
+        readSlot(t, range);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+private:
+    void readSlot(std::int64_t index, IterationRange& range) const {
+        const std::size_t slot = static_cast<std::size_t>(index % capacity);
+        range.begin = begins[slot].load(std::memory_order_relaxed);
+        range.end = ends[slot].load(std::memory_order_relaxed);
+    }
+
+    alignas(cacheLineSize) std::atomic<std::int64_t> top { 0 };
+    alignas(cacheLineSize) std::atomic<std::int64_t> bottom { 0 };
+    alignas(cacheLineSize) std::atomic<std::size_t> begins[capacity] = {};
+    std::atomic<std::size_t> ends[capacity] = {};
+};
+
+struct WorkStealingStats {
+    std::vector<double> busySeconds; // per worker, inside body calls
+    std::vector<std::size_t> steals; // per worker, successful steals
+};
+
+// Runs body(begin, end, worker) over [0, iterations) with ranges of at most
+// grain iterations. Worker 0 is the calling thread; the others are started
+// for this call, so their start-up is part of the caller's time.
+template <typename Body>
+WorkStealingStats runWorkStealing(std::size_t iterations, std::size_t workers, std::size_t grain, Body body) {
+    if (workers == 0)
+        workers = 1;
+    if (grain == 0)
+        grain = 1;
+
+    std::vector<ChaseLevDeque> deques(workers);
+    WorkStealingStats stats;
+    stats.busySeconds.assign(workers, 0.0);
+    stats.steals.assign(workers, 0);
+    std::atomic<std::size_t> remaining { iterations };
+
+    auto worker = [&](std::size_t id) {
+        ChaseLevDeque& own = deques[id];
+        double busySeconds = 0.0;
+        std::size_t steals = 0;
+        std::uint64_t victimState = 0x9E3779B97F4A7C15ull * (id + 1);
+
+        auto runRange = [&](IterationRange range) {
+            while (range.end - range.begin > grain) {
+                const std::size_t middle = range.begin + (range.end - range.begin) / 2;
+                own.push(IterationRange { middle, range.end });
+                range.end = middle;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            body(range.begin, range.end, id);
+            busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            remaining.fetch_sub(range.end - range.begin, std::memory_order_acq_rel);
+        };
+
+        IterationRange range {};
+        staticBlockRange(iterations, id, workers, range.begin, range.end);
+        if (range.end > range.begin)
+            runRange(range);
+        while (true) {
+            if (own.pop(range)) {
+                runRange(range);
+                continue;
+            }
+            if (remaining.load(std::memory_order_acquire) == 0)
+                break;
+            if (workers > 1) {
+                victimState ^= victimState << 13;
+                victimState ^= victimState >> 7;
+                victimState ^= victimState << 17;
+                std::size_t victim = static_cast<std::size_t>(victimState % (workers - 1));
+                if (victim >= id)
+                    ++victim;
+                if (deques[victim].steal(range)) {
+                    ++steals;
+                    runRange(range);
+                    continue;
+                }
+            }
+            std::this_thread::yield();
+        }
+        stats.busySeconds[id] = busySeconds;
+        stats.steals[id] = steals;
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t id = 1; id < workers; ++id)
+        threads.emplace_back(worker, id);
+    worker(0);
+    for (std::thread& thread : threads)
+        thread.join();
+    return stats;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CounterRng.hpp"
+
+// Per-iteration cost of an irregular loop, in inner work units, computed up
+// front from the seed. The cost of iteration i depends only on (seed, i) and
+// the distribution parameters, so every schedule and thread count runs the
+// same work. Distributions, all between lightWork and heavyWork:
+//   bernoulli - heavyWork with probability heavyProbability, else lightWork
+//   pareto    - Pareto with scale lightWork, shape chosen so that a
+//               heavyProbability share reaches heavyWork, capped there;
+//               lightWork must be >= 1 (callers reject less). With
+//               heavyWork <= lightWork or heavyProbability 0 or 1 every
+//               iteration costs lightWork (heavyWork for probability 1)
+//   clustered - runs of workloadClusterLength iterations, each run heavy as a
+//               whole with probability heavyProbability
+//   linear    - rising from lightWork at the first iteration to heavyWork at
+//               the last (heavyProbability unused)
+
+enum class WorkloadDistribution {
+    bernoulli,
+    pareto,
+    clustered,
+    linear
+};
+
+constexpr std::size_t workloadClusterLength = 1000;
+
+inline const char* workloadDistributionName(WorkloadDistribution distribution) {
+    switch (distribution) {
+    case WorkloadDistribution::pareto: return "pareto";
+    case WorkloadDistribution::clustered: return "clustered";
+    case WorkloadDistribution::linear: return "linear";
+    default: return "bernoulli";
+    }
+}
+
+inline bool parseWorkloadDistribution(const std::string& name, WorkloadDistribution& distribution) {
+    if (name == "bernoulli")
+        distribution = WorkloadDistribution::bernoulli;
+    else if (name == "pareto")
+        distribution = WorkloadDistribution::pareto;
+    else if (name == "clustered")
+        distribution = WorkloadDistribution::clustered;
+    else if (name == "linear")
+        distribution = WorkloadDistribution::linear;
+    else
+        return false;
+    return true;
+}
+
+struct WorkloadParams {
+    WorkloadDistribution distribution = WorkloadDistribution::bernoulli;
+    double heavyProbability = 0.0;
+    int lightWork = 0;
+    int heavyWork = 0;
+    std::uint64_t seed = 0;
+};
+
+inline std::vector<int> buildWorkload(const WorkloadParams& params, std::size_t iterations) {
+    std::vector<int> costs(iterations);
+    const int light = params.lightWork;
+    const int heavy = params.heavyWork;
+
+    if (params.distribution == WorkloadDistribution::linear) {
+        const double step = (iterations > 1) ? static_cast<double>(heavy - light) / static_cast<double>(iterations - 1) : 0.0;
+        for (std::size_t i = 0; i < iterations; ++i)
+            costs[i] = light + static_cast<int>(std::lround(step * static_cast<double>(i)));
+        return costs;
+    }
+
+    // One uniform draw per iteration (per run for clustered), stream 0.
+    const bool clustered = (params.distribution == WorkloadDistribution::clustered);
+    const std::size_t draws = clustered ? (iterations + workloadClusterLength - 1) / workloadClusterLength : iterations;
+    std::vector<double> uniform(draws);
+    parallelFillUniformReal(uniform.data(), 0, draws, params.seed, 0, 0.0, 1.0);
+
+    if (params.distribution == WorkloadDistribution::pareto) {
+        // P(X >= heavy) = (light / heavy)^shape = heavyProbability.
+        const bool degenerate = (light <= 0 || heavy <= light || params.heavyProbability <= 0.0 || params.heavyProbability >= 1.0);
+        const double shape = degenerate ? 1.0 : std::log(params.heavyProbability) / std::log(static_cast<double>(light) / heavy);
+        for (std::size_t i = 0; i < iterations; ++i) {
+            if (degenerate) {
+                costs[i] = (params.heavyProbability >= 1.0) ? heavy : light;
+                continue;
+            }
+            // Inverse CDF; 1 - u is in (0, 1].
+            const double value = static_cast<double>(light) * std::pow(1.0 - uniform[i], -1.0 / shape);
+            costs[i] = static_cast<int>(std::min(static_cast<double>(heavy), std::floor(value)));
+        }
+        return costs;
+    }
+
+    for (std::size_t i = 0; i < iterations; ++i) {
+        const double draw = clustered ? uniform[i / workloadClusterLength] : uniform[i];
+        costs[i] = (draw < params.heavyProbability) ? heavy : light;
+    }
+    return costs;
+}
+
+// Lower bound on the makespan of any schedule of costs on workers, in work
+// units: no worker can finish before the average share nor before the single
+// most expensive iteration.
+inline double makespanLowerBound(const std::vector<int>& costs, std::size_t workers) {
+    double total = 0.0;
+    int largest = 0;
+    for (int cost : costs) {
+        total += cost;
+        largest = std::max(largest, cost);
+    }
+    return std::max(total / static_cast<double>(std::max<std::size_t>(workers, 1)), static_cast<double>(largest));
+}
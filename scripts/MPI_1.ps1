@@ -32,12 +32,12 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,vectorSize,numProcesses,mode,timeSeconds,resultValue,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,vectorSize,numProcesses,mode,timeSeconds,resultValue,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $vectorSizeList = @(1000000, 5000000, 10000000)
 $processList = @(1, 2, 4, 6, 8, 16, 32)
 $modeList = @("min","max")
-$numRuns = 5
+$numRuns = 1
 
 foreach ($mode in $modeList) {
     foreach ($vectorSize in $vectorSizeList) {
@@ -51,13 +51,13 @@ foreach ($mode in $modeList) {
                 }
 
                 $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                if ($parts.Count -lt 5) {
-                    Write-Warning "Unexpected process output (expected 5 comma-separated fields): '$processInfo'. Skipping."
+                if ($parts.Count -lt 19) {
+                    Write-Warning "Unexpected process output (expected 19 comma-separated fields): '$processInfo'. Skipping."
                     continue
                 }
 
-                # parts: [0]=vectorSize, [1]=numProcesses, [2]=mode, [3]=timeSeconds, [4]=resultValue
-                $csvLine = "MPI_1,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$runIndex,MPICH_NUM_PROC=$procs"
+                # parts: [0]=vectorSize, [1]=numProcesses, [2]=mode, [3]=timeSeconds, [4]=resultValue, [5..18]=BenchStats columns
+                $csvLine = "MPI_1,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$(($parts[5..18]) -join ','),$runIndex,MPICH_NUM_PROC=$procs"
                 $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
 
                 Write-Host "$(Get-Date -Format 's') appended: mode=$mode size=$vectorSize procs=$procs run=$runIndex"
@@ -16,7 +16,7 @@ csvPath="$resultsDir/MPI_1.csv"
 vectorSizeList=(1000000 5000000 10000000)
 processList=(1 2 4 6 8 16 32)
 modeList=("min" "max")
-numRuns=5
+numRuns=1
 
 mkdir -p "$binDir"
 mkdir -p "$resultsDir"
@@ -30,7 +30,7 @@ if [[ ! -f "$srcDir/MPI_1.cpp" ]]; then
     exit 1
 fi
 
-mpicxx -O3 -std=c++17 -march=native -o "$binDir/$exeName" "$srcDir/MPI_1.cpp"
+mpicxx -O3 -std=c++17 -march=native -fopenmp -I"$projectRoot/include" -o "$binDir/$exeName" "$srcDir/MPI_1.cpp"
 
 if [[ ! -x "$binDir/$exeName" ]]; then
     echo "Compilation failed or executable not found at $binDir/$exeName" >&2
@@ -38,7 +38,7 @@ if [[ ! -x "$binDir/$exeName" ]]; then
 fi
 echo "Built executable: $binDir/$exeName"
 
-printf '%s\n' "testType,vectorSize,numProcesses,mode,timeSeconds,resultValue,runIndex,mpiEnv" > "$csvPath"
+printf '%s\n' "testType,vectorSize,numProcesses,mode,timeSeconds,resultValue,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" > "$csvPath"
 
 echo "Submitting jobs to Slurm (logs -> $logDir)..."
 for mode in "${modeList[@]}"; do
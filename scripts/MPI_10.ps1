@@ -31,7 +31,7 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,method,matrixRows,matrixCols,blockRows,blockCols,numProcesses,timeSeconds,checksum,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,method,matrixRows,matrixCols,blockRows,blockCols,numProcesses,timeSeconds,checksum,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $matrixSizes = @(512, 1024, 2048, 4096)
 $blockPairs = @(
@@ -40,7 +40,7 @@ $blockPairs = @(
 )
 $methods = @("derived","pack","manual")
 $processList = @(1, 2, 4, 6, 8)
-$numRuns = 5
+$numRuns = 1
 
 foreach ($matrixSize in $matrixSizes) {
     foreach ($pair in $blockPairs) {
@@ -56,12 +56,12 @@ foreach ($matrixSize in $matrixSizes) {
                         continue
                     }
                     $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                    if ($parts.Count -lt 8) {
-                        Write-Warning "Unexpected process output (expected at least 8 comma-separated fields): '$processInfo'. Skipping."
+                    if ($parts.Count -lt 23) {
+                        Write-Warning "Unexpected process output (expected at least 23 comma-separated fields): '$processInfo'. Skipping."
                         continue
                     }
-                    # parts: [0]=method, [1]=matrixRows, [2]=matrixCols, [3]=blockRows, [4]=blockCols, [5]=numProcesses, [6]=timeSeconds, [7]=checksum
-                    $csvLine = "MPI_10,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$runIndex,PROCS=$procs"
+                    # parts: [0]=method, [1]=matrixRows, [2]=matrixCols, [3]=blockRows, [4]=blockCols, [5]=numProcesses, [6]=timeSeconds, [7]=checksum, [9..22]=BenchStats columns
+                    $csvLine = "MPI_10,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$(($parts[9..22]) -join ','),$runIndex,PROCS=$procs"
                     $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
                     Write-Host "$(Get-Date -Format 's') appended: method=$method N=$matrixSize block=${blockRows}x${blockCols} procs=$procs run=$runIndex"
                 }
@@ -16,7 +16,7 @@ csvPath="$resultsDir/MPI_10.csv"
 matrixSizes=(512 1024 2048 4096)
 blockPairs=("32x32" "64x64")
 processList=(2 4 6 8 16)
-numRuns=5
+numRuns=1
 
 mkdir -p "$binDir"
 mkdir -p "$resultsDir"
@@ -30,7 +30,7 @@ if [[ ! -f "$srcDir/MPI_10.cpp" ]]; then
     exit 1
 fi
 
-mpicxx -O3 -std=c++17 -march=native -o "$binDir/$exeName" "$srcDir/MPI_10.cpp"
+mpicxx -O3 -std=c++17 -march=native -fopenmp -I"$projectRoot/include" -o "$binDir/$exeName" "$srcDir/MPI_10.cpp"
 
 if [[ ! -x "$binDir/$exeName" ]]; then
     echo "Build failed: executable not found at $binDir/$exeName" >&2
@@ -38,7 +38,7 @@ if [[ ! -x "$binDir/$exeName" ]]; then
 fi
 echo "Built: $binDir/$exeName"
 
-printf '%s\n' "testType,method,matrixRows,matrixCols,blockRows,blockCols,numProcesses,timeSeconds,checksum,runIndex,mpiEnv" > "$csvPath"
+printf '%s\n' "testType,method,matrixRows,matrixCols,blockRows,blockCols,numProcesses,timeSeconds,checksum,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" > "$csvPath"
 
 echo "Submitting jobs to Slurm (logs -> $logDir)..."
 for matrixSize in "${matrixSizes[@]}"; do
@@ -24,7 +24,7 @@ if (-not (Test-Path $exePath)) {
     exit 1
 }
 
-"testType,gridRows,gridCols,numProcesses,commType,medianTimeSeconds,globalSum,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,gridRows,gridCols,numProcesses,commType,medianTimeSeconds,globalSum,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 function Get-GridDims([int]$procCount) {
     $approx = [math]::Floor([math]::Sqrt($procCount))
@@ -38,7 +38,7 @@ function Get-GridDims([int]$procCount) {
 
 $processList = @(4, 6, 8, 9, 16, 32, 64)
 $numIterationsList = @(200, 500)
-$numRuns = 3
+$numRuns = 1
 
 foreach ($numProcesses in $processList) {
     $gridDims = Get-GridDims $numProcesses
@@ -56,12 +56,12 @@ foreach ($numProcesses in $processList) {
             $lines = $processInfo -split "`n" | Where-Object { $_ -ne "" }
             foreach ($line in $lines) {
                 $parts = ($line -split ',') | ForEach-Object { $_.Trim() }
-                if ($parts.Count -lt 7) {
+                if ($parts.Count -lt 21) {
                     Write-Warning "Unexpected output: '$line'"
                     continue
                 }
-                # parts: [0]=MPI_11, [1]=gridRows, [2]=gridCols, [3]=numProcesses, [4]=commType, [5]=medianTimeSeconds, [6]=globalSum
-                $csvLine = "MPI_11,$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$runIndex,PROCS=$numProcesses"
+                # parts: [0]=MPI_11, [1]=gridRows, [2]=gridCols, [3]=numProcesses, [4]=commType, [5]=medianTimeSeconds, [6]=globalSum, [7..20]=BenchStats columns
+                $csvLine = "MPI_11,$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$(($parts[7..20]) -join ','),$runIndex,PROCS=$numProcesses"
                 $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
                 Write-Host "$(Get-Date -Format 's') appended: procs=$numProcesses grid=${gridRows}x${gridCols} comm=$($parts[4]) iters=$numIterations run=$runIndex"
             }
@@ -24,11 +24,11 @@ if (-not (Test-Path $exePath)) {
     exit 1
 }
 
-"testType,topology,gridRows,gridCols,numProcesses,commCreated,avgTimePerAllreduce,finalGlobal,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,topology,gridRows,gridCols,numProcesses,commCreated,avgTimePerAllreduce,finalGlobal,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $processList = @(2, 4, 6, 8, 9, 16, 32)
 $numIterations = 200
-$numRuns = 3
+$numRuns = 1
 
 foreach ($numProcs in $processList) {
     for ($runIndex = 1; $runIndex -le $numRuns; $runIndex++) {
@@ -15,7 +15,7 @@ csvPath="$resultsDir/MPI_12.csv"
 
 processList=(2 4 6 8 9 16 32 64 128)
 numIterations=100
-numRuns=5
+numRuns=1
 
 mkdir -p "$binDir"
 mkdir -p "$resultsDir"
@@ -37,7 +37,7 @@ if [[ ! -x "$binDir/$exeName" ]]; then
 fi
 echo "Built: $binDir/$exeName"
 
-printf '%s\n' "testType,topology,gridRows,gridCols,numProcesses,commCreated,avgTimePerAllreduce,finalGlobal,runIndex,mpiEnv" > "$csvPath"
+printf '%s\n' "testType,topology,gridRows,gridCols,numProcesses,commCreated,avgTimePerAllreduce,finalGlobal,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" > "$csvPath"
 
 echo "Submitting jobs to Slurm (logs -> $logDir)..."
 for numProcs in "${processList[@]}"; do
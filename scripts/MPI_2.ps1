@@ -32,11 +32,11 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,problemSize,numProcesses,timeSeconds,dotProduct,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,problemSize,numProcesses,timeSeconds,dotProduct,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $problemSizeList = @(1000000, 5000000, 10000000)
 $processList = @(1, 2, 4, 6, 8, 16, 32)
-$numRuns = 5
+$numRuns = 1
 
 foreach ($problemSize in $problemSizeList) {
     foreach ($procs in $processList) {
@@ -49,13 +49,13 @@ foreach ($problemSize in $problemSizeList) {
             }
 
             $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-            if ($parts.Count -lt 4) {
-                Write-Warning "Unexpected process output (expected 4 comma-separated fields): '$processInfo'. Skipping."
+            if ($parts.Count -lt 18) {
+                Write-Warning "Unexpected process output (expected 18 comma-separated fields): '$processInfo'. Skipping."
                 continue
             }
 
-            # parts: [0]=problemSize, [1]=numProcesses, [2]=timeSeconds, [3]=dotProduct
-            $csvLine = "MPI_2,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$runIndex,PROCS=$procs"
+            # parts: [0]=problemSize, [1]=numProcesses, [2]=timeSeconds, [3]=dotProduct, [4..17]=BenchStats columns
+            $csvLine = "MPI_2,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$(($parts[4..17]) -join ','),$runIndex,PROCS=$procs"
             $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
 
             Write-Host "$(Get-Date -Format 's') appended: size=$problemSize procs=$procs run=$runIndex"
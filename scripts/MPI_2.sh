@@ -15,7 +15,7 @@ csvPath="$resultsDir/MPI_2.csv"
 
 problemSizeList=(1000000 5000000 10000000)
 processList=(1 2 4 6 8 16 32)
-numRuns=5
+numRuns=1
 
 mkdir -p "$binDir"
 mkdir -p "$resultsDir"
@@ -29,7 +29,7 @@ if [[ ! -f "$srcDir/MPI_2.cpp" ]]; then
     exit 1
 fi
 
-mpicxx -O3 -std=c++17 -march=native -o "$binDir/$exeName" "$srcDir/MPI_2.cpp"
+mpicxx -O3 -std=c++17 -march=native -fopenmp -I"$projectRoot/include" -o "$binDir/$exeName" "$srcDir/MPI_2.cpp"
 
 if [[ ! -x "$binDir/$exeName" ]]; then
     echo "Build failed: executable not found at $binDir/$exeName" >&2
@@ -38,7 +38,7 @@ fi
 echo "Built: $binDir/$exeName"
 
 echo "Creating fresh CSV: $csvPath"
-printf '%s\n' "testType,problemSize,numProcesses,timeSeconds,dotProduct,runIndex,mpiEnv" > "$csvPath"
+printf '%s\n' "testType,problemSize,numProcesses,timeSeconds,dotProduct,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" > "$csvPath"
 
 echo "Submitting jobs to Slurm (logs -> $logDir)..."
 for problemSize in "${problemSizeList[@]}"; do
@@ -31,7 +31,7 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,messageSizeBytes,numProcesses,numIterations,totalTimeSeconds,avgRoundTripSeconds,bandwidthBytesPerSec,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,messageSizeBytes,numProcesses,numIterations,totalTimeSeconds,avgRoundTripSeconds,bandwidthBytesPerSec,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $messageSizeList = @(1, 8, 64, 512, 4096, 32768, 262144, 1048576, 4194304, 8388608)
 
@@ -45,7 +45,7 @@ function Get-IterationsForSize([int64]$size) {
 }
 
 $processCount = 2
-$numRuns = 5
+$numRuns = 1
 
 foreach ($messageSize in $messageSizeList) {
     $numIterations = Get-IterationsForSize $messageSize
@@ -57,12 +57,12 @@ foreach ($messageSize in $messageSizeList) {
             continue
         }
         $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-        if ($parts.Count -lt 6) {
-            Write-Warning "Unexpected process output (expected 6 comma-separated fields): '$processInfo'. Skipping."
+        if ($parts.Count -lt 20) {
+            Write-Warning "Unexpected process output (expected 20 comma-separated fields): '$processInfo'. Skipping."
             continue
         }
-        # parts: [0]=messageSize, [1]=numProcesses, [2]=numIterations, [3]=totalTimeSeconds, [4]=avgRoundTripSeconds, [5]=bandwidthBytesPerSec
-        $csvLine = "MPI_3,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$runIndex,PROCS=$processCount"
+        # parts: [0]=messageSize, [1]=numProcesses, [2]=numIterations, [3]=totalTimeSeconds, [4]=avgRoundTripSeconds, [5]=bandwidthBytesPerSec, [6..19]=BenchStats columns
+        $csvLine = "MPI_3,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$(($parts[6..19]) -join ','),$runIndex,PROCS=$processCount"
         $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
 
         Write-Host "$(Get-Date -Format 's') appended: size=$messageSize iterations=$numIterations run=$runIndex"
@@ -16,7 +16,7 @@ csvPath="$resultsDir/MPI_3.csv"
 messageSizeList=(1 8 64 512 4096 32768 262144 1048576 4194304 8388608)
 
 processCount=2
-numRuns=5
+numRuns=1
 
 mkdir -p "$binDir"
 mkdir -p "$resultsDir"
@@ -55,7 +55,7 @@ function getIterationsForSize() {
     fi
 }
 
-printf '%s\n' "testType,messageSizeBytes,numProcesses,numIterations,totalTimeSeconds,avgRoundTripSeconds,bandwidthBytesPerSec,runIndex,mpiEnv" > "$csvPath"
+printf '%s\n' "testType,messageSizeBytes,numProcesses,numIterations,totalTimeSeconds,avgRoundTripSeconds,bandwidthBytesPerSec,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" > "$csvPath"
 
 echo "Submitting jobs to Slurm (logs -> $logDir)..."
 for messageSize in "${messageSizeList[@]}"; do
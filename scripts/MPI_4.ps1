@@ -32,12 +32,12 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,matrixSize,numProcesses,mode,timeSeconds,checksum,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,matrixSize,numProcesses,mode,timeSeconds,checksum,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $matrixSizeList = @(240, 480, 720, 960, 1200)
 $processList = @(1, 4, 9, 16, 25)
 $modeList = @("blockRow","cannon")
-$numRuns = 5
+$numRuns = 1
 
 foreach ($matrixSize in $matrixSizeList) {
     foreach ($numProcs in $processList) {
@@ -68,12 +68,12 @@ foreach ($matrixSize in $matrixSizeList) {
                     continue
                 }
                 $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                if ($parts.Count -lt 5) {
-                    Write-Warning "Unexpected process output (expected 5 comma-separated fields): '$processInfo'. Skipping."
+                if ($parts.Count -lt 19) {
+                    Write-Warning "Unexpected process output (expected 19 comma-separated fields): '$processInfo'. Skipping."
                     continue
                 }
-                # parts: [0]=matrixSize, [1]=numProcesses, [2]=mode, [3]=timeSeconds, [4]=checksum
-                $csvLine = "MPI_4,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$runIndex,PROCS=$numProcs"
+                # parts: [0]=matrixSize, [1]=numProcesses, [2]=mode, [3]=timeSeconds, [4]=checksum, [5..18]=BenchStats columns
+                $csvLine = "MPI_4,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$(($parts[5..18]) -join ','),$runIndex,PROCS=$numProcs"
                 $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
 
                 Write-Host "$(Get-Date -Format 's') appended: N=$matrixSize procs=$numProcs mode=$($parts[2]) run=$runIndex"
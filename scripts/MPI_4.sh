@@ -17,7 +17,7 @@ csvPath="$resultsDir/MPI_4.csv"
 matrixSizeList=(240 480 720 960 1200)
 processList=(1 4 9 16 25)
 modeList=("blockRow" "cannon")
-numRuns=5
+numRuns=1
 
 mkdir -p "$binDir"
 mkdir -p "$resultsDir"
@@ -31,7 +31,7 @@ if [[ ! -f "$srcDir/MPI_4.cpp" ]]; then
     exit 1
 fi
 
-mpicxx -O3 -std=c++17 -march=native -o "$binDir/$exeName" "$srcDir/MPI_4.cpp"
+mpicxx -O3 -std=c++17 -march=native -fopenmp -I"$projectRoot/include" -o "$binDir/$exeName" "$srcDir/MPI_4.cpp"
 
 if [[ ! -x "$binDir/$exeName" ]]; then
     echo "Build failed: executable not found at $binDir/$exeName" >&2
@@ -39,7 +39,7 @@ if [[ ! -x "$binDir/$exeName" ]]; then
 fi
 echo "Built: $binDir/$exeName"
 
-printf '%s\n' "testType,matrixSize,numProcesses,mode,timeSeconds,checksum,runIndex,mpiEnv" > "$csvPath"
+printf '%s\n' "testType,matrixSize,numProcesses,mode,timeSeconds,checksum,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" > "$csvPath"
 
 echo "Submitting jobs to Slurm (logs -> $logDir)..."
 for matrixSize in "${matrixSizeList[@]}"; do
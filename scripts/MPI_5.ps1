@@ -31,7 +31,7 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,messageSizeBytes,numMessages,computeMicroseconds,numIterations,numProcesses,totalTimeSeconds,avgTimePerIteration,bandwidthBytesPerSec,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,messageSizeBytes,numMessages,computeMicroseconds,numIterations,numProcesses,totalTimeSeconds,avgTimePerIteration,bandwidthBytesPerSec,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $messageSizeList = @(1, 64, 1024, 65536, 262144)
 $numMessagesList = @(1, 4, 16, 32)
@@ -46,7 +46,7 @@ function Get-IterationsForSize([int64]$size) {
 }
 
 $processList = @(2, 4, 6, 8)
-$numRuns = 5
+$numRuns = 1
 
 foreach ($messageSize in $messageSizeList) {
     $numIterations = Get-IterationsForSize $messageSize
@@ -60,12 +60,12 @@ foreach ($messageSize in $messageSizeList) {
                         continue
                     }
                     $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                    if ($parts.Count -lt 8) {
-                        Write-Warning "Unexpected process output (expected 8 comma-separated fields): '$processInfo'. Skipping."
+                    if ($parts.Count -lt 22) {
+                        Write-Warning "Unexpected process output (expected 22 comma-separated fields): '$processInfo'. Skipping."
                         continue
                     }
-                    # parts: [0]=messageSizeBytes, [1]=numMessages, [2]=computeMicroseconds, [3]=numIterations, [4]=numProcesses, [5]=totalTimeSeconds, [6]=avgTimePerIteration, [7]=bandwidthBytesPerSec
-                    $csvLine = "MPI_5,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$runIndex,PROCS=$procs"
+                    # parts: [0]=messageSizeBytes, [1]=numMessages, [2]=computeMicroseconds, [3]=numIterations, [4]=numProcesses, [5]=totalTimeSeconds, [6]=avgTimePerIteration, [7]=bandwidthBytesPerSec, [8..21]=BenchStats columns
+                    $csvLine = "MPI_5,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$(($parts[8..21]) -join ','),$runIndex,PROCS=$procs"
                     $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
                     Write-Host "$(Get-Date -Format 's') appended: size=$messageSize msgs=$numMessages computeUs=$computeMicro procs=$procs run=$runIndex"
                 }
@@ -24,14 +24,14 @@ if (-not (Test-Path $exePath)) {
     exit 1
 }
 
-"testType,messageSizeBytes,numProcesses,mode,numIterations,computeUnits,avgWallSeconds,avgCommSeconds,avgComputeSeconds,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,messageSizeBytes,numProcesses,mode,numIterations,computeUnits,avgWallSeconds,avgCommSeconds,avgComputeSeconds,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $messageSizeList = @(1024, 16384, 65536, 262144, 1048576)
 $processList = @(1, 2, 4, 6, 8)
 $computeUnitsList = @(0, 10, 50, 200)
 $numIterations = 50
 $modes = @("blocking","nonblocking","comm_only","compute_only")
-$numRuns = 3
+$numRuns = 1
 
 foreach ($messageSize in $messageSizeList) {
     foreach ($numProcs in $processList) {
@@ -45,12 +45,12 @@ foreach ($messageSize in $messageSizeList) {
                         continue
                     }
                     $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                    if ($parts.Count -lt 9) {
+                    if ($parts.Count -lt 23) {
                         Write-Warning "Unexpected output: '$processInfo'. Skipping."
                         continue
                     }
                     # parts correspond to CSV line from program; append runIndex and env
-                    $csvLine = "MPI_7,$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$($parts[8]),$runIndex,PROCS=$numProcs"
+                    $csvLine = "MPI_7,$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$($parts[8]),$(($parts[9..22]) -join ','),$runIndex,PROCS=$numProcs"
                     $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
                     Write-Host "$(Get-Date -Format 's') appended: size=$messageSize procs=$numProcs mode=$mode units=$computeUnits run=$runIndex"
                 }
@@ -24,11 +24,11 @@ if (-not (Test-Path $exePath)) {
     exit 1
 }
 
-"testType,messageSize,numProcesses,mode,numIterations,totalTime,avgRoundTrip,bandwidth,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,messageSize,numProcesses,mode,numIterations,totalTime,avgRoundTrip,bandwidth,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $messageSizeList = @(1, 16, 1024, 16384, 65536, 262144, 1048576)
 $modes = @("separate","sendrecv","isend_irecv")
-$numRuns = 5
+$numRuns = 1
 
 foreach ($messageSize in $messageSizeList) {
     if ($messageSize -le 64) { $numIterations = 20000 }
@@ -46,12 +46,12 @@ foreach ($messageSize in $messageSizeList) {
                 continue
             }
             $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-            if ($parts.Count -lt 8) {
+            if ($parts.Count -lt 22) {
                 Write-Warning "Unexpected output: '$processInfo'. Skipping."
                 continue
             }
-            # parts: [0]=MPI_8, [1]=messageSize, [2]=numProcesses, [3]=mode, [4]=numIterations, [5]=totalTime, [6]=avgRoundTrip, [7]=bandwidth
-            $csvLine = "MPI_8,$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$runIndex,PROCS=2"
+            # parts: [0]=MPI_8, [1]=messageSize, [2]=numProcesses, [3]=mode, [4]=numIterations, [5]=totalTime, [6]=avgRoundTrip, [7]=bandwidth, [8..21]=BenchStats columns
+            $csvLine = "MPI_8,$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$(($parts[8..21]) -join ','),$runIndex,PROCS=2"
             $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
             Write-Host "$(Get-Date -Format 's') appended: size=$messageSize mode=$mode run=$runIndex"
         }
@@ -15,7 +15,7 @@ csvPath="$resultsDir/MPI_8.csv"
 
 messageSizeList=(1 16 1024 16384 65536 262144 1048576 4194304)
 modes=("separate" "sendrecv" "isend_irecv")
-numRuns=5
+numRuns=1
 processCount=2
 
 mkdir -p "$binDir"
@@ -55,7 +55,7 @@ function getIterationsForSize() {
     fi
 }
 
-printf '%s\n' "testType,messageSize,numProcesses,mode,numIterations,totalTime,avgRoundTrip,bandwidth,runIndex,mpiEnv" > "$csvPath"
+printf '%s\n' "testType,messageSize,numProcesses,mode,numIterations,totalTime,avgRoundTrip,bandwidth,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,mpiEnv" > "$csvPath"
 
 echo "Submitting jobs to Slurm (logs -> $logDir)..."
 for messageSize in "${messageSizeList[@]}"; do
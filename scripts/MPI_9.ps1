@@ -24,12 +24,12 @@ if (-not (Test-Path $exePath)) {
     exit 1
 }
 
-"testType,opName,messageSizeBytes,numProcesses,customTime,mpiTime,checksum,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,opName,messageSizeBytes,numProcesses,customTime,mpiTime,checksum,customRuns,customOutliers,customMeanSeconds,customMinSeconds,customP5Seconds,customP95Seconds,customStddevSeconds,customCiRelative,customIpc,customLlcMissRate,customBranchMissRate,customLlcMissGBs,customDramGBs,customDtlbMpki,mpiRuns,mpiOutliers,mpiMeanSeconds,mpiMinSeconds,mpiP5Seconds,mpiP95Seconds,mpiStddevSeconds,mpiCiRelative,mpiIpc,mpiLlcMissRate,mpiBranchMissRate,mpiLlcMissGBs,mpiDramGBs,mpiDtlbMpki,runIndex,mpiEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $opList = @("bcast","reduce","scatter","gather","allgather","alltoall")
 $messageSizeList = @(1, 16, 1024, 16384, 65536, 262144, 1048576)
 $processList = @(1, 2, 4, 8)
-$numRuns = 3
+$numRuns = 1
 
 foreach ($op in $opList) {
     foreach ($msgSize in $messageSizeList) {
@@ -41,12 +41,12 @@ foreach ($op in $opList) {
                     continue
                 }
                 $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                if ($parts.Count -lt 9) {
+                if ($parts.Count -lt 35) {
                     Write-Warning "Unexpected output: '$processInfo'. Skipping."
                     continue
                 }
-                # parts: [0]=MPI_9, [1]=opName, [2]=messageSize, [3]=numProcesses, [4]=customTime, [5]=mpiTime, [6]=checksum, [7]=runIndex, [8]=mpiEnv
-                $csvLine = "MPI_9,$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$runIndex,PROCS=$procs"
+                # parts: [0]=MPI_9, [1]=opName, [2]=messageSize, [3]=numProcesses, [4]=customTime, [5]=mpiTime, [6]=checksum, [7..34]=BenchStats columns
+                $csvLine = "MPI_9,$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$(($parts[7..34]) -join ','),$runIndex,PROCS=$procs"
                 $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
                 Write-Host "$(Get-Date -Format 's') appended: op=$op msg=$msgSize procs=$procs run=$runIndex"
             }
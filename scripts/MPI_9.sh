@@ -16,7 +16,7 @@ csvPath="$resultsDir/MPI_9.csv"
 opList=(bcast reduce scatter gather allgather alltoall)
 messageSizeList=(1 16 1024 16384 65536 262144 1048576)
 processList=(1 2 4 8 16)
-numRuns=3
+numRuns=1
 
 mkdir -p "$binDir"
 mkdir -p "$resultsDir"
@@ -38,7 +38,7 @@ if [[ ! -x "$binDir/$exeName" ]]; then
 fi
 echo "Built: $binDir/$exeName"
 
-printf '%s\n' "testType,opName,messageSizeBytes,numProcesses,customTime,mpiTime,checksum,runIndex,mpiEnv" > "$csvPath"
+printf '%s\n' "testType,opName,messageSizeBytes,numProcesses,customTime,mpiTime,checksum,customRuns,customOutliers,customMeanSeconds,customMinSeconds,customP5Seconds,customP95Seconds,customStddevSeconds,customCiRelative,customIpc,customLlcMissRate,customBranchMissRate,customLlcMissGBs,customDramGBs,customDtlbMpki,mpiRuns,mpiOutliers,mpiMeanSeconds,mpiMinSeconds,mpiP5Seconds,mpiP95Seconds,mpiStddevSeconds,mpiCiRelative,mpiIpc,mpiLlcMissRate,mpiBranchMissRate,mpiLlcMissGBs,mpiDramGBs,mpiDtlbMpki,runIndex,mpiEnv" > "$csvPath"
 
 echo "Submitting jobs to Slurm (logs -> $logDir)..."
 for op in "${opList[@]}"; do
@@ -34,12 +34,12 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,problemSize,numThreads,mode,timeSeconds,minValue,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,problemSize,numThreads,mode,timeSeconds,minValue,numaPolicy,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $problemSizeList = @(1000000, 5000000, 10000000, 50000000, 100000000)
 $threadList = @(1, 2, 4, 6, 8, 16, 32)
-$modeList = @("reduction", "no_reduction")
-$numRuns = 5
+$modeList = @("reduction", "no_reduction", "simd")
+$numRuns = 1
 
 foreach ($mode in $modeList) {
     foreach ($problemSize in $problemSizeList) {
@@ -54,13 +54,13 @@ foreach ($mode in $modeList) {
                 }
 				
 				$parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-				if ($parts.Count -lt 5) {
-					Write-Warning "Unexpected process output (expected 5 comma-separated fields): '$processInfo'. Skipping."
+				if ($parts.Count -lt 20) {
+					Write-Warning "Unexpected process output (expected 20 comma-separated fields): '$processInfo'. Skipping."
 					continue
 				}
 
-				# parts: [0]=problemSize, [1]=numThreads, [2]=mode, [3]=timeSeconds, [4]=minValue
-				$csvLine = "OpenMP_1,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
+				# parts: [0]=problemSize, [1]=numThreads, [2]=mode, [3]=timeSeconds, [4]=minValue, [5]=numaPolicy, [6..19]=BenchStats columns
+				$csvLine = "OpenMP_1,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$(($parts[6..19]) -join ','),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
 				$csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
 
                 Write-Host "$(Get-Date -Format 's') appended: mode=$mode size=$problemSize threads=$threads run=$runIndex"
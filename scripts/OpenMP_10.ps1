@@ -0,0 +1,79 @@
+param(
+    [string]$ProjectRoot = (Split-Path -Parent (Split-Path -Parent $MyInvocation.MyCommand.Definition))
+)
+
+Set-StrictMode -Version Latest
+$ErrorActionPreference = "Stop"
+
+$buildDir = Join-Path $ProjectRoot "build"
+$binDir = Join-Path $buildDir "bin"
+$resultsDir = Join-Path $ProjectRoot "results"
+$exeName = "OpenMP_10.exe"
+$csvPath = Join-Path $resultsDir "OpenMP_10.csv"
+
+New-Item -ItemType Directory -Force -Path $buildDir | Out-Null
+New-Item -ItemType Directory -Force -Path $resultsDir | Out-Null
+
+Write-Host "Configuring and building via CMake..."
+& cmake -S $ProjectRoot -B $buildDir -DCMAKE_BUILD_TYPE=Release
+& cmake --build $buildDir --config Release
+
+$exePath = Join-Path $binDir $exeName
+
+if (-not (Test-Path $exePath)) {
+    Write-Error "Executable not found at $exePath. Проверьте, что CMakeLists.txt находится в $ProjectRoot и сборка прошла успешно."
+    exit 1
+}
+
+$metadataPath = Join-Path $resultsDir "metadata.txt"
+if (-not (Test-Path $metadataPath)) {
+    $compilerInfo = & cmake --version | Select-Object -First 1
+    $osInfo = (Get-CimInstance Win32_OperatingSystem).Caption
+    "$compilerInfo" | Out-File -FilePath $metadataPath -Encoding utf8
+    "os: $osInfo" | Out-File -FilePath $metadataPath -Append -Encoding utf8
+    "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
+}
+
+"testType,matrixSize,numThreads,mode,batchSize,numBatches,hotFraction,timeSeconds,updatesPerSecond,batchP50Seconds,batchP99Seconds,rescannedRows,answerChecksum,numaPolicy,isa,hugePages,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
+
+$matrixSizeList = @(1000, 2000, 4000)
+$threadList = @(1, 2, 4, 8, 16, 32, 64)
+$modeList = @("incremental", "rescan")
+$batchSizeList = @(64, 1024, 16384)
+$hotFractionList = @(0.0, 0.1, 0.5)
+$numBatches = 64
+$numRuns = 1
+
+foreach ($mode in $modeList) {
+    foreach ($matrixSize in $matrixSizeList) {
+        foreach ($batchSize in $batchSizeList) {
+            foreach ($hotFraction in $hotFractionList) {
+                foreach ($threads in $threadList) {
+                    $env:OMP_NUM_THREADS = "$threads"
+                    for ($runIndex = 1; $runIndex -le $numRuns; $runIndex++) {
+                        $seed = Get-Random
+                        $processInfo = & "$exePath" $matrixSize $mode $batchSize $numBatches $hotFraction $seed
+                        if ($LASTEXITCODE -ne 0) {
+                            Write-Warning "Process returned non-zero exit code ($LASTEXITCODE). Skipping this run."
+                            continue
+                        }
+
+                        $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
+                        if ($parts.Count -lt 29) {
+                            Write-Warning "Unexpected process output (expected >=29 comma-separated fields): '$processInfo'. Skipping."
+                            continue
+                        }
+
+                        # parts: [0]=matrixSize, [1]=numThreads, [2]=mode, [3]=batchSize, [4]=numBatches, [5]=hotFraction, [6]=timeSeconds, [7]=updatesPerSecond, [8]=batchP50Seconds, [9]=batchP99Seconds, [10]=rescannedRows, [11]=answerChecksum, [12]=numaPolicy, [13]=isa, [14]=hugePages, [15..28]=BenchStats columns
+                        $csvLine = "OpenMP_10,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$($parts[8]),$($parts[9]),$($parts[10]),$($parts[11]),$($parts[12]),$($parts[13]),$($parts[14]),$(($parts[15..28]) -join ','),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
+                        $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
+
+                        Write-Host "$(Get-Date -Format 's') appended: mode=$mode size=$matrixSize batch=$batchSize hot=$hotFraction threads=$threads run=$runIndex"
+                    }
+                }
+            }
+        }
+    }
+}
+
+Write-Host "Sweep finished. Results written to $csvPath"
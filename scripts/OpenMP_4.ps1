@@ -34,12 +34,12 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,matrixSize,numThreads,mode,timeSeconds,maxOfRowMins,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,matrixSize,numThreads,mode,timeSeconds,maxOfRowMins,numaPolicy,isa,elementsTouched,hugePages,pageKiB,hugeFraction,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $matrixSizeList = @(500, 1000, 2000, 4000)
 $threadList = @(1, 2, 4, 6, 8, 16, 32, 64)
-$modeList = @("reduction", "no_reduction")
-$numRuns = 5
+$modeList = @("reduction", "no_reduction", "pruned", "pruned_sampled")
+$numRuns = 1
 
 foreach ($mode in $modeList) {
     foreach ($matrixSize in $matrixSizeList) {
@@ -54,13 +54,13 @@ foreach ($mode in $modeList) {
                 }
 
                 $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                if ($parts.Count -lt 5) {
-                    Write-Warning "Unexpected process output (expected 5 comma-separated fields): '$processInfo'. Skipping."
+                if ($parts.Count -lt 25) {
+                    Write-Warning "Unexpected process output (expected >=25 comma-separated fields): '$processInfo'. Skipping."
                     continue
                 }
 
-                # parts: [0]=matrixSize, [1]=numThreads, [2]=mode, [3]=timeSeconds, [4]=maxOfRowMins
-                $csvLine = "OpenMP_4,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
+                # parts: [0]=matrixSize, [1]=numThreads, [2]=mode, [3]=timeSeconds, [4]=maxOfRowMins, [5]=numaPolicy, [6]=isa, [7]=elementsTouched, [8]=hugePages, [9]=pageKiB, [10]=hugeFraction, [11..24]=BenchStats columns
+                $csvLine = "OpenMP_4,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$($parts[8]),$($parts[9]),$($parts[10]),$(($parts[11..24]) -join ','),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
                 $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
 
                 Write-Host "$(Get-Date -Format 's') appended: mode=$mode size=$matrixSize threads=$threads run=$runIndex"
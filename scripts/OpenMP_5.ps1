@@ -34,45 +34,48 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,matrixSize,numThreads,mode,matrixType,bandwidth,schedule,chunk,timeSeconds,maxOfRowMins,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,matrixSize,numThreads,mode,matrixType,bandwidth,schedule,chunk,timeSeconds,maxOfRowMins,numaPolicy,storage,isa,imbalance,threadSeconds,hugePages,pageKiB,hugeFraction,tunedSchedule,tuneSource,exploreSeconds,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $matrixSizeList = @(500, 1000, 2000, 4000)
 $threadList = @(1, 2, 4, 6, 8, 16, 32)
 $modeList = @("reduction", "no_reduction")
-$scheduleList = @("static", "dynamic", "guided")
+$scheduleList = @("static", "dynamic", "guided", "balanced", "tuned")
 $chunkList = @(1, 16)
 $matrixTypeList = @("banded", "triangular")
 $bandwidthList = @(3, 16)
+$storageList = @("padded", "dense", "compact", "csr")
 
-$numRuns = 5
+$numRuns = 1
 
 foreach ($mode in $modeList) {
     foreach ($matrixType in $matrixTypeList) {
         foreach ($matrixSize in $matrixSizeList) {
             foreach ($bandwidth in $bandwidthList) {
-                foreach ($schedule in $scheduleList) {
-                    foreach ($chunk in $chunkList) {
-                        foreach ($threads in $threadList) {
-                            $env:OMP_NUM_THREADS = "$threads"
-                            for ($runIndex = 1; $runIndex -le $numRuns; $runIndex++) {
-                                $seed = Get-Random
-                                $processInfo = & "$exePath" $matrixSize $mode $matrixType $schedule $chunk $bandwidth $seed
-                                if ($LASTEXITCODE -ne 0) {
-                                    Write-Warning "Process returned non-zero exit code ($LASTEXITCODE). Skipping this run."
-                                    continue
-                                }
+                foreach ($storage in $storageList) {
+                    foreach ($schedule in $scheduleList) {
+                        foreach ($chunk in $chunkList) {
+                            foreach ($threads in $threadList) {
+                                $env:OMP_NUM_THREADS = "$threads"
+                                for ($runIndex = 1; $runIndex -le $numRuns; $runIndex++) {
+                                    $seed = Get-Random
+                                    $processInfo = & "$exePath" $matrixSize $mode $matrixType $schedule $chunk $bandwidth $seed $storage
+                                    if ($LASTEXITCODE -ne 0) {
+                                        Write-Warning "Process returned non-zero exit code ($LASTEXITCODE). Skipping this run."
+                                        continue
+                                    }
 
-                                $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                                if ($parts.Count -lt 9) {
-                                    Write-Warning "Unexpected process output (expected >=9 comma-separated fields): '$processInfo'. Skipping."
-                                    continue
-                                }
+                                    $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
+                                    if ($parts.Count -lt 34) {
+                                        Write-Warning "Unexpected process output (expected >=34 comma-separated fields): '$processInfo'. Skipping."
+                                        continue
+                                    }
 
-                                # parts: [0]=matrixSize, [1]=numThreads, [2]=mode, [3]=matrixType, [4]=bandwidth, [5]=schedule, [6]=chunk, [7]=timeSeconds, [8]=maxOfRowMins
-                                $csvLine = "OpenMP_5,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$($parts[8]),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
-                                $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
+                                    # parts: [0]=matrixSize, [1]=numThreads, [2]=mode, [3]=matrixType, [4]=bandwidth, [5]=schedule, [6]=chunk, [7]=timeSeconds, [8]=maxOfRowMins, [9]=numaPolicy, [10]=storage, [11]=isa, [12]=imbalance, [13]=threadSeconds, [14]=hugePages, [15]=pageKiB, [16]=hugeFraction, [17]=tunedSchedule, [18]=tuneSource, [19]=exploreSeconds, [20..33]=BenchStats columns
+                                    $csvLine = "OpenMP_5,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$($parts[8]),$($parts[9]),$($parts[10]),$($parts[11]),$($parts[12]),$($parts[13]),$($parts[14]),$($parts[15]),$($parts[16]),$($parts[17]),$($parts[18]),$($parts[19]),$(($parts[20..33]) -join ','),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
+                                    $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
 
-                                Write-Host "$(Get-Date -Format 's') appended: mode=$mode type=$matrixType size=$matrixSize band=$bandwidth schedule=$schedule chunk=$chunk threads=$threads run=$runIndex"
+                                    Write-Host "$(Get-Date -Format 's') appended: mode=$mode type=$matrixType size=$matrixSize band=$bandwidth storage=$storage schedule=$schedule chunk=$chunk threads=$threads run=$runIndex"
+                                }
                             }
                         }
                     }
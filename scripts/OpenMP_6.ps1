@@ -34,45 +34,52 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,problemSize,numThreads,schedule,chunk,timeSeconds,resultSum,heavyProbability,lightWork,heavyWork,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,problemSize,numThreads,schedule,chunk,timeSeconds,resultSum,heavyProbability,lightWork,heavyWork,steals,workerSeconds,tunedSchedule,tuneSource,exploreSeconds,distribution,totalWork,makespanBound,makespanEfficiency,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $problemSizeList = @(10000, 50000, 100000)
 $threadList = @(1, 2, 4, 6, 8, 16, 32, 64)
-$scheduleList = @("static","dynamic","guided")
+$scheduleList = @("static","dynamic","guided","steal","tuned","tasks","lpt")
 $chunkList = @(1, 10, 100)
 
 
 $heavyProbabilityList = @(0.05, 0.15)
 $lightWork = 10
 $heavyWork = 1000
+$distributionList = @("bernoulli", "pareto", "clustered", "linear")
 
-$numRuns = 5
+$numRuns = 1
+
+# tasks: lets the heavy blocks' priority(1) take effect
+$env:OMP_MAX_TASK_PRIORITY = "1"
 
 foreach ($problemSize in $problemSizeList) {
     foreach ($heavyProb in $heavyProbabilityList) {
-        foreach ($schedule in $scheduleList) {
-            foreach ($chunk in $chunkList) {
-                foreach ($threads in $threadList) {
-                    $env:OMP_NUM_THREADS = "$threads"
-                    for ($runIndex = 1; $runIndex -le $numRuns; $runIndex++) {
-                        $seed = Get-Random
-                        $processInfo = & "$exePath" $problemSize $schedule $chunk $heavyProb $lightWork $heavyWork $seed
-                        if ($LASTEXITCODE -ne 0) {
-                            Write-Warning "Process returned non-zero exit code ($LASTEXITCODE). Skipping this run."
-                            continue
-                        }
-
-                        $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                        if ($parts.Count -lt 6) {
-                            Write-Warning "Unexpected process output (expected 6 comma-separated fields): '$processInfo'. Skipping."
-                            continue
+        foreach ($distribution in $distributionList) {
+            # One seed per workload, so every schedule and thread count runs the same iterations.
+            $seed = Get-Random
+            foreach ($schedule in $scheduleList) {
+                foreach ($chunk in $chunkList) {
+                    foreach ($threads in $threadList) {
+                        $env:OMP_NUM_THREADS = "$threads"
+                        for ($runIndex = 1; $runIndex -le $numRuns; $runIndex++) {
+                            $processInfo = & "$exePath" $problemSize $schedule $chunk $heavyProb $lightWork $heavyWork $seed $distribution
+                            if ($LASTEXITCODE -ne 0) {
+                                Write-Warning "Process returned non-zero exit code ($LASTEXITCODE). Skipping this run."
+                                continue
+                            }
+
+                            $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
+                            if ($parts.Count -lt 29) {
+                                Write-Warning "Unexpected process output (expected 29 comma-separated fields): '$processInfo'. Skipping."
+                                continue
+                            }
+
+                            # parts: [0]=problemSize, [1]=numThreads, [2]=schedule, [3]=chunk, [4]=timeSeconds, [5]=resultSum, [6]=steals, [7]=workerSeconds, [8]=tunedSchedule, [9]=tuneSource, [10]=exploreSeconds, [11]=distribution, [12]=totalWork, [13]=makespanBound, [14]=makespanEfficiency, [15..28]=BenchStats columns
+                            $csvLine = "OpenMP_6,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$heavyProb,$lightWork,$heavyWork,$($parts[6]),$($parts[7]),$($parts[8]),$($parts[9]),$($parts[10]),$($parts[11]),$($parts[12]),$($parts[13]),$($parts[14]),$(($parts[15..28]) -join ','),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
+                            $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
+
+                            Write-Host "$(Get-Date -Format 's') appended: N=$problemSize heavyProb=$heavyProb distribution=$distribution schedule=$schedule chunk=$chunk threads=$threads run=$runIndex"
                         }
-
-                        # parts: [0]=problemSize, [1]=numThreads, [2]=schedule, [3]=chunk, [4]=timeSeconds, [5]=resultSum
-                        $csvLine = "OpenMP_6,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$heavyProb,$lightWork,$heavyWork,$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
-                        $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
-
-                        Write-Host "$(Get-Date -Format 's') appended: N=$problemSize heavyProb=$heavyProb schedule=$schedule chunk=$chunk threads=$threads run=$runIndex"
                     }
                 }
             }
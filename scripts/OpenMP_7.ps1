@@ -34,12 +34,12 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,problemSize,numThreads,mode,timeSeconds,globalSum,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,problemSize,numThreads,mode,timeSeconds,globalSum,updatesPerSecond,numaPolicy,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $problemSizeList = @(500000, 1000000, 5000000)
 $threadList = @(1, 2, 4, 6, 8, 16, 32)
-$modeList = @("reduction", "atomic", "critical", "lock")
-$numRuns = 5
+$modeList = @("reduction", "atomic", "critical", "lock", "padded", "false_sharing", "cas", "sharded", "combining")
+$numRuns = 1
 
 foreach ($mode in $modeList) {
     foreach ($problemSize in $problemSizeList) {
@@ -54,13 +54,13 @@ foreach ($mode in $modeList) {
                 }
 
                 $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                if ($parts.Count -lt 5) {
-                    Write-Warning "Unexpected process output (expected 5 comma-separated fields): '$processInfo'. Skipping."
+                if ($parts.Count -lt 21) {
+                    Write-Warning "Unexpected process output (expected 21 comma-separated fields): '$processInfo'. Skipping."
                     continue
                 }
 
-                # parts: [0]=problemSize, [1]=numThreads, [2]=mode, [3]=timeSeconds, [4]=globalSum
-                $csvLine = "OpenMP_7,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
+                # parts: [0]=problemSize, [1]=numThreads, [2]=mode, [3]=timeSeconds, [4]=globalSum, [5]=updatesPerSecond, [6]=numaPolicy, [7..20]=BenchStats columns
+                $csvLine = "OpenMP_7,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$(($parts[7..20]) -join ','),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
                 $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
 
                 Write-Host "$(Get-Date -Format 's') appended: mode=$mode N=$problemSize threads=$threads run=$runIndex"
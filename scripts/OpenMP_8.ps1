@@ -34,38 +34,45 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,numVectors,vectorSize,numThreads,mode,timeSeconds,totalSum,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,numVectors,vectorSize,numThreads,mode,timeSeconds,totalSum,ringCapacity,producerSlotWaitSeconds,consumerSlotWaitSeconds,ringSleeps,readers,workers,reduction,isa,ioBackend,queueDepth,blockKiB,direct,readGBs,mmapPrefetch,coldSeconds,coldResidentFraction,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $vectorCountList = @(10, 50)
 $vectorSizeList = @(100000, 300000)
 $threadList = @(1, 2, 4, 6, 8, 16, 32)
-$modeList = @("sequential", "sections")
-$numRuns = 5
+$modeList = @("sequential", "sections", "pipeline")
+$ringCapacity = 4
+$readers = 1
+$reductionList = @("ordered", "unordered")
+$numRuns = 1
 
 foreach ($vectorCount in $vectorCountList) {
     foreach ($vectorSize in $vectorSizeList) {
         foreach ($mode in $modeList) {
-            foreach ($threads in $threadList) {
-                $env:OMP_NUM_THREADS = "$threads"
-                for ($runIndex = 1; $runIndex -le $numRuns; $runIndex++) {
-                    $seed = Get-Random
-                    $processInfo = & "$exePath" $vectorCount $vectorSize $mode $seed
-                    if ($LASTEXITCODE -ne 0) {
-                        Write-Warning "Process returned non-zero exit code ($LASTEXITCODE). Skipping this run."
-                        continue
-                    }
+            # The reduction order only matters for the pipeline.
+            $modeReductions = if ($mode -eq "pipeline") { $reductionList } else { @("ordered") }
+            foreach ($reduction in $modeReductions) {
+                foreach ($threads in $threadList) {
+                    $env:OMP_NUM_THREADS = "$threads"
+                    for ($runIndex = 1; $runIndex -le $numRuns; $runIndex++) {
+                        $seed = Get-Random
+                        $processInfo = & "$exePath" $vectorCount $vectorSize $mode $seed $ringCapacity $readers $reduction
+                        if ($LASTEXITCODE -ne 0) {
+                            Write-Warning "Process returned non-zero exit code ($LASTEXITCODE). Skipping this run."
+                            continue
+                        }
 
-                    $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                    if ($parts.Count -lt 6) {
-                        Write-Warning "Unexpected process output (expected 6 comma-separated fields): '$processInfo'. Skipping."
-                        continue
-                    }
+                        $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
+                        if ($parts.Count -lt 36) {
+                            Write-Warning "Unexpected process output (expected 36 comma-separated fields): '$processInfo'. Skipping."
+                            continue
+                        }
 
-                    # parts: [0]=numVectors, [1]=vectorSize, [2]=numThreads, [3]=mode, [4]=timeSeconds, [5]=totalSum
-                    $csvLine = "OpenMP_8,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
-                    $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
+                        # parts: [0]=numVectors, [1]=vectorSize, [2]=numThreads, [3]=mode, [4]=timeSeconds, [5]=totalSum, [6]=ringCapacity, [7]=producerSlotWaitSeconds, [8]=consumerSlotWaitSeconds, [9]=ringSleeps, [10]=readers, [11]=workers, [12]=reduction, [13]=isa, [14]=ioBackend, [15]=queueDepth, [16]=blockKiB, [17]=direct, [18]=readGBs, [19]=mmapPrefetch, [20]=coldSeconds, [21]=coldResidentFraction, [22..35]=BenchStats columns
+                        $csvLine = "OpenMP_8,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$($parts[8]),$($parts[9]),$($parts[10]),$($parts[11]),$($parts[12]),$($parts[13]),$($parts[14]),$($parts[15]),$($parts[16]),$($parts[17]),$($parts[18]),$($parts[19]),$($parts[20]),$($parts[21]),$(($parts[22..35]) -join ','),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
+                        $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
 
-                    Write-Host "$(Get-Date -Format 's') appended: vectors=$vectorCount size=$vectorSize mode=$mode threads=$threads run=$runIndex"
+                        Write-Host "$(Get-Date -Format 's') appended: vectors=$vectorCount size=$vectorSize mode=$mode reduction=$reduction threads=$threads run=$runIndex"
+                    }
                 }
             }
         }
@@ -33,13 +33,14 @@ if (-not (Test-Path $metadataPath)) {
     "buildDate: $(Get-Date -Format o)" | Out-File -FilePath $metadataPath -Append -Encoding utf8
 }
 
-"testType,matrixSize,numThreads,mode,innerThreads,timeSeconds,maxOfRowMins,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
+"testType,matrixSize,numThreads,mode,innerThreads,timeSeconds,maxOfRowMins,numaPolicy,isa,rowGrain,elementsTouched,hugePages,pageKiB,hugeFraction,runs,outliers,meanSeconds,minSeconds,p5Seconds,p95Seconds,stddevSeconds,ciRelative,ipc,llcMissRate,branchMissRate,llcMissGBs,dramGBs,dtlbMpki,runIndex,ompEnv" | Out-File -FilePath $csvPath -Encoding utf8
 
 $matrixSizeList = @(500, 1000, 2000)
 $threadList = @(1, 2, 4, 6, 8, 16)
-$modeList = @("outer","inner","nested")
+$modeList = @("outer","inner","nested","tiled","taskloop","pruned","pruned_sampled")
 $innerThreadsList = @(1, 2, 4)
-$numRuns = 5
+$rowGrain = 16
+$numRuns = 1
 
 foreach ($matrixSize in $matrixSizeList) {
     foreach ($mode in $modeList) {
@@ -48,18 +49,18 @@ foreach ($matrixSize in $matrixSizeList) {
             foreach ($innerThreads in $innerThreadsList) {
                 for ($runIndex = 1; $runIndex -le $numRuns; $runIndex++) {
                     $seed = Get-Random
-                    $processInfo = & "$exePath" $matrixSize $mode $innerThreads $seed
+                    $processInfo = & "$exePath" $matrixSize $mode $innerThreads $seed $rowGrain
                     if ($LASTEXITCODE -ne 0) {
                         Write-Warning "Process returned non-zero exit code ($LASTEXITCODE). Skipping this run."
                         continue
                     }
                     $parts = ($processInfo -split ',') | ForEach-Object { $_.Trim() }
-                    if ($parts.Count -lt 6) {
-                        Write-Warning "Unexpected process output (expected 6 comma-separated fields): '$processInfo'. Skipping."
+                    if ($parts.Count -lt 27) {
+                        Write-Warning "Unexpected process output (expected >=27 comma-separated fields): '$processInfo'. Skipping."
                         continue
                     }
-                    # parts: [0]=matrixSize, [1]=numThreads, [2]=mode, [3]=innerThreads, [4]=timeSeconds, [5]=maxOfRowMins
-                    $csvLine = "OpenMP_9,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
+                    # parts: [0]=matrixSize, [1]=numThreads, [2]=mode, [3]=innerThreads, [4]=timeSeconds, [5]=maxOfRowMins, [6]=numaPolicy, [7]=isa, [8]=rowGrain, [9]=elementsTouched, [10]=hugePages, [11]=pageKiB, [12]=hugeFraction, [13..26]=BenchStats columns
+                    $csvLine = "OpenMP_9,$($parts[0]),$($parts[1]),$($parts[2]),$($parts[3]),$($parts[4]),$($parts[5]),$($parts[6]),$($parts[7]),$($parts[8]),$($parts[9]),$($parts[10]),$($parts[11]),$($parts[12]),$(($parts[13..26]) -join ','),$runIndex,OMP_NUM_THREADS=$($env:OMP_NUM_THREADS)"
                     $csvLine | Out-File -FilePath $csvPath -Append -Encoding utf8
                     Write-Host "$(Get-Date -Format 's') appended: N=$matrixSize mode=$mode outerThreads=$threads innerThreads=$innerThreads run=$runIndex"
                 }
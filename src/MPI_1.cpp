@@ -1,15 +1,18 @@
 #include <mpi.h>
 #include <iostream>
 #include <vector>
-#include <random>
 #include <string>
 #include <iomanip>
 #include <cstdint>
 #include <limits>
 
+#include "BenchHarnessMpi.hpp"
+#include "CounterRng.hpp"
+
 // Usage:
 //   MPI_1 <vectorSize> <mode> [seed]
 //   mode: min | max
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
 //
 // Example:
 //   mpiexec -n 4 ./MPI_1 1000000 min 12345
@@ -53,11 +56,7 @@ int main(int argc, char** argv) {
     std::vector<double> fullVector;
     if (worldRank == 0) {
         fullVector.resize(vectorSize);
-        std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-        std::uniform_real_distribution<double> distribution(0.0, 1.0e6);
-        for (std::size_t i = 0; i < vectorSize; ++i) {
-            fullVector[i] = distribution(generator);
-        }
+        parallelFillUniformReal(fullVector.data(), 0, vectorSize, seed, 0, 0.0, 1.0e6);
     }
 
     const std::size_t base = vectorSize / static_cast<std::size_t>(worldSize);
@@ -80,54 +79,59 @@ int main(int argc, char** argv) {
     const int localCount = sendCounts[worldRank];
     std::vector<double> localBuffer(static_cast<std::size_t>(localCount));
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeStart = MPI_Wtime();
-
-    MPI_Scatterv(
-        (worldRank == 0 ? fullVector.data() : nullptr),
-        (worldRank == 0 ? sendCounts.data() : nullptr),
-        (worldRank == 0 ? displacements.data() : nullptr),
-        MPI_DOUBLE,
-        (localCount > 0 ? localBuffer.data() : nullptr),
-        localCount,
-        MPI_DOUBLE,
-        0,
-        MPI_COMM_WORLD
-    );
-
-    double localResult;
-    if (localCount == 0) {
-        localResult = wantMin ? std::numeric_limits<double>::max() : std::numeric_limits<double>::lowest();
-    }
-    else {
-        localResult = localBuffer[0];
-        for (int i = 1; i < localCount; ++i) {
-            const double val = localBuffer[static_cast<std::size_t>(i)];
-            if (wantMin) {
-                if (val < localResult)
-                    localResult = val;
-            }
-            else {
-                if (val > localResult)
-                    localResult = val;
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    double globalResult = 0.0;
+    const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        const double timeStart = MPI_Wtime();
+
+        MPI_Scatterv(
+            (worldRank == 0 ? fullVector.data() : nullptr),
+            (worldRank == 0 ? sendCounts.data() : nullptr),
+            (worldRank == 0 ? displacements.data() : nullptr),
+            MPI_DOUBLE,
+            (localCount > 0 ? localBuffer.data() : nullptr),
+            localCount,
+            MPI_DOUBLE,
+            0,
+            MPI_COMM_WORLD
+        );
+
+        double localResult;
+        if (localCount == 0) {
+            localResult = wantMin ? std::numeric_limits<double>::max() : std::numeric_limits<double>::lowest();
+        }
+        else {
+            localResult = localBuffer[0];
+            for (int i = 1; i < localCount; ++i) {
+                const double val = localBuffer[static_cast<std::size_t>(i)];
+                if (wantMin) {
+                    if (val < localResult)
+                        localResult = val;
+                }
+                else {
+                    if (val > localResult)
+                        localResult = val;
+                }
             }
         }
-    }
 
-    double globalResult = 0.0;
-    if (wantMin) {
-        MPI_Reduce(&localResult, &globalResult, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
-    }
-    else {
-        MPI_Reduce(&localResult, &globalResult, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
-    }
+        if (wantMin) {
+            MPI_Reduce(&localResult, &globalResult, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+        }
+        else {
+            MPI_Reduce(&localResult, &globalResult, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        }
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeEnd = MPI_Wtime();
-    const double timeSeconds = timeEnd - timeStart;
+        MPI_Barrier(MPI_COMM_WORLD);
+        return MPI_Wtime() - timeStart;
+    });
 
     if (worldRank == 0) {
-        std::cout << vectorSize << "," << worldSize << "," << mode << "," << std::fixed << std::setprecision(6) << timeSeconds << "," << globalResult << std::endl;
+        BenchRow row;
+        row.add("vectorSize", vectorSize).add("numProcesses", worldSize).add("mode", mode)
+            .addFixed("timeSeconds", stats.median, 6).addFixed("resultValue", globalResult, 6).addStats(stats);
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
@@ -1,7 +1,6 @@
 #include <mpi.h>
 #include <iostream>
 #include <vector>
-#include <random>
 #include <string>
 #include <cstring>
 #include <chrono>
@@ -10,9 +9,13 @@
 #include <cstdint>
 #include <algorithm>
 
+#include "BenchHarnessMpi.hpp"
+#include "CounterRng.hpp"
+
 // Usage:
 //   MPI_10 <matrixRows> <matrixCols> <blockRows> <blockCols> <method> [seed]
 // method: derived | pack | manual
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
 
 using std::size_t;
 
@@ -57,17 +60,17 @@ int main(int argc, char** argv) {
         return 3;
     }
 
+    if (method != "derived" && method != "pack" && method != "manual") {
+        if (worldRank == 0)
+            std::cerr << "Unknown method: " << method << "\n";
+        MPI_Finalize();
+        return 4;
+    }
+
     std::vector<double> fullMatrix;
     if (worldRank == 0) {
         fullMatrix.assign(matrixRows * matrixCols, 0.0);
-        std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-        std::uniform_real_distribution<double> distribution(0.0, 1.0);
-        for (size_t i = 0; i < matrixRows; ++i) {
-            const size_t rowOff = i * matrixCols;
-            for (size_t j = 0; j < matrixCols; ++j) {
-                fullMatrix[rowOff + j] = distribution(generator);
-            }
-        }
+        parallelFillUniformReal(fullMatrix.data(), 0, matrixRows * matrixCols, seed, 0, 0.0, 1.0);
     }
 
     const size_t blockSizeElements = blockRows * blockCols;
@@ -83,94 +86,90 @@ int main(int argc, char** argv) {
         return {static_cast<int>(startRow), static_cast<int>(startCol)};
         };
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    double timeStart = MPI_Wtime();
-
-    if (method == "derived") {
-        MPI_Datatype vectorType;
-        MPI_Type_vector(static_cast<int>(blockRows), static_cast<int>(blockCols), static_cast<int>(matrixCols), MPI_DOUBLE, &vectorType);
-
-        MPI_Datatype resizedType;
-        MPI_Aint lb = 0;
-        MPI_Aint extent = static_cast<MPI_Aint>(sizeof(double) * blockCols);
-        MPI_Type_create_resized(vectorType, lb, extent, &resizedType);
-        MPI_Type_commit(&resizedType);
-
-        if (worldRank == 0) {
-            for (int p = 1; p < worldSize; ++p) {
-                auto [startRow, startCol] = computeStart(p);
-                double* sendPtr = fullMatrix.data() + static_cast<size_t>(startRow) * matrixCols + static_cast<size_t>(startCol);
-                MPI_Send(sendPtr, 1, resizedType, p, 100 + p, MPI_COMM_WORLD);
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        double timeStart = MPI_Wtime();
+
+        if (method == "derived") {
+            MPI_Datatype vectorType;
+            MPI_Type_vector(static_cast<int>(blockRows), static_cast<int>(blockCols), static_cast<int>(matrixCols), MPI_DOUBLE, &vectorType);
+
+            MPI_Datatype resizedType;
+            MPI_Aint lb = 0;
+            MPI_Aint extent = static_cast<MPI_Aint>(sizeof(double) * blockCols);
+            MPI_Type_create_resized(vectorType, lb, extent, &resizedType);
+            MPI_Type_commit(&resizedType);
+
+            if (worldRank == 0) {
+                for (int p = 1; p < worldSize; ++p) {
+                    auto [startRow, startCol] = computeStart(p);
+                    double* sendPtr = fullMatrix.data() + static_cast<size_t>(startRow) * matrixCols + static_cast<size_t>(startCol);
+                    MPI_Send(sendPtr, 1, resizedType, p, 100 + p, MPI_COMM_WORLD);
+                }
+            }
+            else {
+                MPI_Recv(recvBuffer.data(), static_cast<int>(blockSizeElements), MPI_DOUBLE, 0, 100 + worldRank, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
             }
-        }
-        else {
-            MPI_Recv(recvBuffer.data(), static_cast<int>(blockSizeElements), MPI_DOUBLE, 0, 100 + worldRank, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-        }
 
-        MPI_Type_free(&resizedType);
-        MPI_Type_free(&vectorType);
-    }
-    else if (method == "pack") {
-        int packRowSize = 0;
-        MPI_Pack_size(static_cast<int>(blockCols), MPI_DOUBLE, MPI_COMM_WORLD, &packRowSize);
-        int packBufferSize = packRowSize * static_cast<int>(blockRows) + 1024;
-        if (packBufferSize < 0)
-            packBufferSize = 1024;
-        std::vector<char> packBuffer(static_cast<size_t>(packBufferSize));
+            MPI_Type_free(&resizedType);
+            MPI_Type_free(&vectorType);
+        }
+        else if (method == "pack") {
+            int packRowSize = 0;
+            MPI_Pack_size(static_cast<int>(blockCols), MPI_DOUBLE, MPI_COMM_WORLD, &packRowSize);
+            int packBufferSize = packRowSize * static_cast<int>(blockRows) + 1024;
+            if (packBufferSize < 0)
+                packBufferSize = 1024;
+            std::vector<char> packBuffer(static_cast<size_t>(packBufferSize));
+
+            if (worldRank == 0) {
+                for (int p = 1; p < worldSize; ++p) {
+                    auto [startRow, startCol] = computeStart(p);
+                    int position = 0;
+                    for (int r = 0; r < static_cast<int>(blockRows); ++r) {
+                        double* srcPtr = fullMatrix.data() + static_cast<size_t>(startRow + r) * matrixCols + static_cast<size_t>(startCol);
+                        MPI_Pack(srcPtr, static_cast<int>(blockCols), MPI_DOUBLE, packBuffer.data(), packBufferSize, &position, MPI_COMM_WORLD);
+                    }
+                    MPI_Send(packBuffer.data(), position, MPI_PACKED, p, 200 + p, MPI_COMM_WORLD);
+                }
+            }
+            else {
+                MPI_Status status;
+                MPI_Probe(0, 200 + worldRank, MPI_COMM_WORLD, &status);
+                int incomingSize = 0;
+                MPI_Get_count(&status, MPI_PACKED, &incomingSize);
+                std::vector<char> incomingBuffer(static_cast<size_t>(incomingSize));
+                MPI_Recv(incomingBuffer.data(), incomingSize, MPI_PACKED, 0, 200 + worldRank, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
-        if (worldRank == 0) {
-            for (int p = 1; p < worldSize; ++p) {
-                auto [startRow, startCol] = computeStart(p);
                 int position = 0;
                 for (int r = 0; r < static_cast<int>(blockRows); ++r) {
-                    double* srcPtr = fullMatrix.data() + static_cast<size_t>(startRow + r) * matrixCols + static_cast<size_t>(startCol);
-                    MPI_Pack(srcPtr, static_cast<int>(blockCols), MPI_DOUBLE, packBuffer.data(), packBufferSize, &position, MPI_COMM_WORLD);
+                    MPI_Unpack(incomingBuffer.data(), incomingSize, &position,
+                        recvBuffer.data() + static_cast<size_t>(r) * blockCols, static_cast<int>(blockCols), MPI_DOUBLE, MPI_COMM_WORLD);
                 }
-                MPI_Send(packBuffer.data(), position, MPI_PACKED, p, 200 + p, MPI_COMM_WORLD);
             }
         }
-        else {
-            MPI_Status status;
-            MPI_Probe(0, 200 + worldRank, MPI_COMM_WORLD, &status);
-            int incomingSize = 0;
-            MPI_Get_count(&status, MPI_PACKED, &incomingSize);
-            std::vector<char> incomingBuffer(static_cast<size_t>(incomingSize));
-            MPI_Recv(incomingBuffer.data(), incomingSize, MPI_PACKED, 0, 200 + worldRank, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-            int position = 0;
-            for (int r = 0; r < static_cast<int>(blockRows); ++r) {
-                MPI_Unpack(incomingBuffer.data(), incomingSize, &position,
-                    recvBuffer.data() + static_cast<size_t>(r) * blockCols, static_cast<int>(blockCols), MPI_DOUBLE, MPI_COMM_WORLD);
-            }
-        }
-    }
-    else if (method == "manual") {
-        std::vector<double> packBuffer(blockSizeElements);
-        if (worldRank == 0) {
-            for (int p = 1; p < worldSize; ++p) {
-                auto [startRow, startCol] = computeStart(p);
-                double* dstPtr = packBuffer.data();
-                for (int r = 0; r < static_cast<int>(blockRows); ++r) {
-                    double* srcPtr = fullMatrix.data() + static_cast<size_t>(startRow + r) * matrixCols + static_cast<size_t>(startCol);
-                    std::memcpy(dstPtr + static_cast<size_t>(r) * blockCols, srcPtr, static_cast<size_t>(blockCols) * sizeof(double));
+        else if (method == "manual") {
+            std::vector<double> packBuffer(blockSizeElements);
+            if (worldRank == 0) {
+                for (int p = 1; p < worldSize; ++p) {
+                    auto [startRow, startCol] = computeStart(p);
+                    double* dstPtr = packBuffer.data();
+                    for (int r = 0; r < static_cast<int>(blockRows); ++r) {
+                        double* srcPtr = fullMatrix.data() + static_cast<size_t>(startRow + r) * matrixCols + static_cast<size_t>(startCol);
+                        std::memcpy(dstPtr + static_cast<size_t>(r) * blockCols, srcPtr, static_cast<size_t>(blockCols) * sizeof(double));
+                    }
+                    MPI_Send(packBuffer.data(), static_cast<int>(blockSizeElements), MPI_DOUBLE, p, 300 + p, MPI_COMM_WORLD);
                 }
-                MPI_Send(packBuffer.data(), static_cast<int>(blockSizeElements), MPI_DOUBLE, p, 300 + p, MPI_COMM_WORLD);
+            }
+            else {
+                MPI_Recv(recvBuffer.data(), static_cast<int>(blockSizeElements), MPI_DOUBLE, 0, 300 + worldRank, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
             }
         }
-        else {
-            MPI_Recv(recvBuffer.data(), static_cast<int>(blockSizeElements), MPI_DOUBLE, 0, 300 + worldRank, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-        }
-    }
-    else {
-        if (worldRank == 0)
-            std::cerr << "Unknown method: " << method << "\n";
-        MPI_Finalize();
-        return 4;
-    }
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    double timeEnd = MPI_Wtime();
-    double elapsedSeconds = timeEnd - timeStart;
+        MPI_Barrier(MPI_COMM_WORLD);
+        return MPI_Wtime() - timeStart;
+    });
 
     double localSum = 0.0;
     if (worldRank != 0) {
@@ -182,8 +181,11 @@ int main(int argc, char** argv) {
     MPI_Reduce(&localSum, &globalSum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
 
     if (worldRank == 0) {
-        std::cout << "MPI_9," << method << "," << matrixRows << "," << matrixCols << "," << blockRows << "," << blockCols << "," << worldSize << ","
-            << std::fixed << std::setprecision(6) << elapsedSeconds << "," << std::setprecision(12) << globalSum << std::endl;
+        BenchRow row;
+        row.add("testType", "MPI_9").add("method", method).add("matrixRows", matrixRows).add("matrixCols", matrixCols)
+            .add("blockRows", blockRows).add("blockCols", blockCols).add("numProcesses", worldSize)
+            .addFixed("timeSeconds", stats.median, 6).addFixed("checksum", globalSum, 12).addStats(stats);
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
@@ -7,8 +7,13 @@
 #include <numeric>
 #include <iomanip>
 
+#include "BenchHarnessMpi.hpp"
+
 // Usage:
 //   MPI_11 <numIterations> [gridRows gridCols] [seed]
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// A measured run is numIterations allreduces and its sample is their median
+// latency; medianTimeSeconds is the median of those samples.
 
 static double computeMedian(std::vector<double>& valuesVector) {
     if (valuesVector.empty())
@@ -86,6 +91,7 @@ int main(int argc, char** argv) {
     commList.emplace_back(std::string("col"), colComm);
 
     const double localValueBase = static_cast<double>(worldRank + 1);
+    const BenchConfig benchConfig = benchConfigFromEnv();
 
     for (const auto& commEntry : commList) {
         const std::string commLabel = commEntry.first;
@@ -94,31 +100,33 @@ int main(int argc, char** argv) {
         std::vector<double> iterationTimes;
         iterationTimes.reserve(numIterations);
 
-        for (std::size_t iter = 0; iter < numIterations; ++iter) {
-            const double localValue = localValueBase + 1e-6 * static_cast<double>(iter);
+        const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+            iterationTimes.clear();
+            for (std::size_t iter = 0; iter < numIterations; ++iter) {
+                const double localValue = localValueBase + 1e-6 * static_cast<double>(iter);
 
-            MPI_Barrier(measuredComm);
+                MPI_Barrier(measuredComm);
 
-            const double t0 = MPI_Wtime();
-            double globalSum = 0.0;
-            MPI_Allreduce(&localValue, &globalSum, 1, MPI_DOUBLE, MPI_SUM, measuredComm);
-            const double t1 = MPI_Wtime();
-            iterationTimes.push_back(t1 - t0);
-        }
+                const double t0 = MPI_Wtime();
+                double globalSum = 0.0;
+                MPI_Allreduce(&localValue, &globalSum, 1, MPI_DOUBLE, MPI_SUM, measuredComm);
+                const double t1 = MPI_Wtime();
+                iterationTimes.push_back(t1 - t0);
+            }
 
-        const double medianTime = computeMedian(iterationTimes);
+            return computeMedian(iterationTimes);
+        });
 
         const double localValueCheck = localValueBase;
         double globalSumCheck = 0.0;
         MPI_Allreduce(&localValueCheck, &globalSumCheck, 1, MPI_DOUBLE, MPI_SUM, measuredComm);
 
         if (worldRank == 0) {
-            std::cout << "MPI_11,"
-                << gridRows << "," << gridCols << ","
-                << worldSize << ","
-                << commLabel << ","
-                << std::fixed << std::setprecision(6) << medianTime << ","
-                << std::setprecision(12) << globalSumCheck << std::endl;
+            BenchRow row;
+            row.add("testType", "MPI_11").add("gridRows", gridRows).add("gridCols", gridCols)
+                .add("numProcesses", worldSize).add("commType", commLabel)
+                .addFixed("medianTimeSeconds", stats.median, 6).addFixed("globalSum", globalSumCheck, 12).addStats(stats);
+            row.print(std::cout, benchConfig);
         }
     }
 
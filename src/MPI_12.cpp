@@ -7,8 +7,13 @@
 #include <iomanip>
 #include <sstream>
 
+#include "BenchHarnessMpi.hpp"
+
 // Usage:
 //   MPI_12 <numIterations> [gridRows gridCols]
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// A measured run is numIterations allreduces on the topology communicator;
+// avgTimePerAllreduce is the median run divided by numIterations.
 
 static double computeAverage(double value) {
     return value;
@@ -55,7 +60,11 @@ int main(int argc, char** argv) {
     const int gridRows = gridDims.first;
     const int gridCols = gridDims.second;
 
-    auto measureAllreduceAvg = [&](MPI_Comm comm, int iterations, double& outFinalGlobal) -> double {
+    const BenchConfig benchConfig = benchConfigFromEnv();
+
+    // Every topology below spans all ranks, so the harness runs on MPI_COMM_WORLD
+    // and its statistics land on world rank 0 whatever the reordered ranks are.
+    auto measureAllreduceAvg = [&](MPI_Comm comm, int iterations, double& outFinalGlobal, BenchStats& outStats) -> double {
         if (comm == MPI_COMM_NULL) {
             outFinalGlobal = 0.0;
             return -1.0;
@@ -63,20 +72,18 @@ int main(int argc, char** argv) {
 
         double localValue = static_cast<double>(worldRank + 1);
 
-        MPI_Barrier(comm);
-        const double t0 = MPI_Wtime();
-
         double globalValue = 0.0;
-        for (int it = 0; it < iterations; ++it) {
-            double iterValue = localValue + 1e-7 * it;
-            MPI_Allreduce(&iterValue, &globalValue, 1, MPI_DOUBLE, MPI_SUM, comm);
-        }
+        outStats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+            MPI_Barrier(comm);
+            const double t0 = MPI_Wtime();
 
-        const double t1 = MPI_Wtime();
-        const double localElapsed = t1 - t0;
+            for (int it = 0; it < iterations; ++it) {
+                double iterValue = localValue + 1e-7 * it;
+                MPI_Allreduce(&iterValue, &globalValue, 1, MPI_DOUBLE, MPI_SUM, comm);
+            }
 
-        double maxElapsed = 0.0;
-        MPI_Reduce(&localElapsed, &maxElapsed, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
+            return MPI_Wtime() - t0;
+        });
 
         const double reducedFinal = globalValue;
         double finalGlobalOnWorldRoot = 0.0;
@@ -84,9 +91,19 @@ int main(int argc, char** argv) {
 
         outFinalGlobal = finalGlobalOnWorldRoot;
 
-        if (maxElapsed <= 0.0)
+        if (outStats.median <= 0.0)
             return 0.0;
-        return maxElapsed / static_cast<double>(iterations);
+        return outStats.median / static_cast<double>(iterations);
+        };
+
+    auto printTopologyRow = [&](const char* topology, int rows, int cols, bool created, double avgTime, double global, const BenchStats& stats) {
+        if (worldRank != 0)
+            return;
+        BenchRow row;
+        row.add("testType", "MPI_12").add("topology", topology).add("gridRows", rows).add("gridCols", cols)
+            .add("numProcesses", worldSize).add("commCreated", created ? 1 : 0)
+            .addFixed("avgTimePerAllreduce", avgTime, 6).addFixed("finalGlobal", global, 12).addStats(stats);
+        row.print(std::cout, benchConfig);
         };
 
     // --- 1) Cartesian (non-periodic) ---
@@ -121,17 +138,12 @@ int main(int argc, char** argv) {
 
     double finalGlobal = 0.0;
     double avgTimeCart = -1.0;
+    BenchStats cartStats;
     if (cartComm != MPI_COMM_NULL) {
-        avgTimeCart = measureAllreduceAvg(cartComm, numIterations, finalGlobal);
+        avgTimeCart = measureAllreduceAvg(cartComm, numIterations, finalGlobal, cartStats);
     }
 
-    if (worldRank == 0) {
-        std::ostringstream oss;
-        oss << "MPI_12,cart," << gridRows << "," << gridCols << "," << worldSize << ","
-            << (cartComm != MPI_COMM_NULL ? "1" : "0") << ","
-            << std::fixed << std::setprecision(6) << avgTimeCart << "," << std::setprecision(12) << finalGlobal;
-        std::cout << oss.str() << std::endl;
-    }
+    printTopologyRow("cart", gridRows, gridCols, cartComm != MPI_COMM_NULL, avgTimeCart, finalGlobal, cartStats);
 
     // --- 2) Torus (periodic Cartesian) ---
     MPI_Comm torusComm = MPI_COMM_NULL;
@@ -165,17 +177,12 @@ int main(int argc, char** argv) {
     }
 
     double avgTimeTorus = -1.0;
+    BenchStats torusStats;
     finalGlobal = 0.0;
     if (torusComm != MPI_COMM_NULL) {
-        avgTimeTorus = measureAllreduceAvg(torusComm, numIterations, finalGlobal);
-    }
-    if (worldRank == 0) {
-        std::ostringstream oss;
-        oss << "MPI_12,torus," << gridRows << "," << gridCols << "," << worldSize << ","
-            << (torusComm != MPI_COMM_NULL ? "1" : "0") << ","
-            << std::fixed << std::setprecision(6) << avgTimeTorus << "," << std::setprecision(12) << finalGlobal;
-        std::cout << oss.str() << std::endl;
+        avgTimeTorus = measureAllreduceAvg(torusComm, numIterations, finalGlobal, torusStats);
     }
+    printTopologyRow("torus", gridRows, gridCols, torusComm != MPI_COMM_NULL, avgTimeTorus, finalGlobal, torusStats);
 
     // --- 3) Graph topology (custom adjacency) ---
     MPI_Comm graphComm = MPI_COMM_NULL;
@@ -235,17 +242,12 @@ int main(int argc, char** argv) {
     }
 
     double avgTimeGraph = -1.0;
+    BenchStats graphStats;
     finalGlobal = 0.0;
     if (graphComm != MPI_COMM_NULL) {
-        avgTimeGraph = measureAllreduceAvg(graphComm, numIterations, finalGlobal);
-    }
-    if (worldRank == 0) {
-        std::ostringstream oss;
-        oss << "MPI_12,graph,0,0," << worldSize << ","
-            << (graphComm != MPI_COMM_NULL ? "1" : "0") << ","
-            << std::fixed << std::setprecision(6) << avgTimeGraph << "," << std::setprecision(12) << finalGlobal;
-        std::cout << oss.str() << std::endl;
+        avgTimeGraph = measureAllreduceAvg(graphComm, numIterations, finalGlobal, graphStats);
     }
+    printTopologyRow("graph", 0, 0, graphComm != MPI_COMM_NULL, avgTimeGraph, finalGlobal, graphStats);
 
     // --- 4) Star topology (center = rank 0 connected to all others) ---
     MPI_Comm starComm = MPI_COMM_NULL;
@@ -295,17 +297,12 @@ int main(int argc, char** argv) {
     }
 
     double avgTimeStar = -1.0;
+    BenchStats starStats;
     finalGlobal = 0.0;
     if (starComm != MPI_COMM_NULL) {
-        avgTimeStar = measureAllreduceAvg(starComm, numIterations, finalGlobal);
-    }
-    if (worldRank == 0) {
-        std::ostringstream oss;
-        oss << "MPI_12,star,0,0," << worldSize << ","
-            << (starComm != MPI_COMM_NULL ? "1" : "0") << ","
-            << std::fixed << std::setprecision(6) << avgTimeStar << "," << std::setprecision(12) << finalGlobal;
-        std::cout << oss.str() << std::endl;
+        avgTimeStar = measureAllreduceAvg(starComm, numIterations, finalGlobal, starStats);
     }
+    printTopologyRow("star", 0, 0, starComm != MPI_COMM_NULL, avgTimeStar, finalGlobal, starStats);
 
     if (cartComm != MPI_COMM_NULL)
         MPI_Comm_free(&cartComm);
@@ -1,13 +1,16 @@
 #include <mpi.h>
 #include <iostream>
 #include <vector>
-#include <random>
 #include <string>
 #include <iomanip>
 #include <cstdint>
 
+#include "BenchHarnessMpi.hpp"
+#include "CounterRng.hpp"
+
 // Usage:
 //   MPI_2 <problemSize> [seed]
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
 //
 // Example:
 //   mpiexec -n 4 ./MPI_2 10000000 12345
@@ -43,12 +46,8 @@ int main(int argc, char** argv) {
     if (processRank == 0) {
         fullA.resize(problemSize);
         fullB.resize(problemSize);
-        std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-        std::uniform_real_distribution<double> distribution(0.0, 1.0);
-        for (std::size_t i = 0; i < problemSize; ++i) {
-            fullA[i] = distribution(generator);
-            fullB[i] = distribution(generator);
-        }
+        parallelFillUniformReal(fullA.data(), 0, problemSize, seed, 0, 0.0, 1.0);
+        parallelFillUniformReal(fullB.data(), 0, problemSize, seed, 1, 0.0, 1.0);
     }
 
     const std::size_t base = problemSize / static_cast<std::size_t>(numProcesses);
@@ -72,48 +71,52 @@ int main(int argc, char** argv) {
     std::vector<double> localA(static_cast<std::size_t>(localCount));
     std::vector<double> localB(static_cast<std::size_t>(localCount));
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeStart = MPI_Wtime();
-
-    MPI_Scatterv(
-        (processRank == 0 ? fullA.data() : nullptr),
-        (processRank == 0 ? sendCounts.data() : nullptr),
-        (processRank == 0 ? displacements.data() : nullptr),
-        MPI_DOUBLE,
-        (localCount > 0 ? localA.data() : nullptr),
-        localCount,
-        MPI_DOUBLE,
-        0,
-        MPI_COMM_WORLD
-    );
-
-    MPI_Scatterv(
-        (processRank == 0 ? fullB.data() : nullptr),
-        (processRank == 0 ? sendCounts.data() : nullptr),
-        (processRank == 0 ? displacements.data() : nullptr),
-        MPI_DOUBLE,
-        (localCount > 0 ? localB.data() : nullptr),
-        localCount,
-        MPI_DOUBLE,
-        0,
-        MPI_COMM_WORLD
-    );
-
-    double localDot = 0.0;
-    for (int i = 0; i < localCount; ++i) {
-        localDot += localA[static_cast<std::size_t>(i)] * localB[static_cast<std::size_t>(i)];
-    }
-
+    const BenchConfig benchConfig = benchConfigFromEnv();
     double globalDot = 0.0;
-    MPI_Reduce(&localDot, &globalDot, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        const double timeStart = MPI_Wtime();
+
+        MPI_Scatterv(
+            (processRank == 0 ? fullA.data() : nullptr),
+            (processRank == 0 ? sendCounts.data() : nullptr),
+            (processRank == 0 ? displacements.data() : nullptr),
+            MPI_DOUBLE,
+            (localCount > 0 ? localA.data() : nullptr),
+            localCount,
+            MPI_DOUBLE,
+            0,
+            MPI_COMM_WORLD
+        );
+
+        MPI_Scatterv(
+            (processRank == 0 ? fullB.data() : nullptr),
+            (processRank == 0 ? sendCounts.data() : nullptr),
+            (processRank == 0 ? displacements.data() : nullptr),
+            MPI_DOUBLE,
+            (localCount > 0 ? localB.data() : nullptr),
+            localCount,
+            MPI_DOUBLE,
+            0,
+            MPI_COMM_WORLD
+        );
+
+        double localDot = 0.0;
+        for (int i = 0; i < localCount; ++i) {
+            localDot += localA[static_cast<std::size_t>(i)] * localB[static_cast<std::size_t>(i)];
+        }
+
+        MPI_Reduce(&localDot, &globalDot, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeEnd = MPI_Wtime();
-    const double timeSeconds = timeEnd - timeStart;
+        MPI_Barrier(MPI_COMM_WORLD);
+        return MPI_Wtime() - timeStart;
+    });
 
     if (processRank == 0) {
-        std::cout << problemSize << "," << numProcesses << "," << std::fixed << std::setprecision(6)
-            << timeSeconds << "," << globalDot << std::endl;
+        BenchRow row;
+        row.add("problemSize", problemSize).add("numProcesses", numProcesses)
+            .addFixed("timeSeconds", stats.median, 6).addFixed("dotProduct", globalDot, 6).addStats(stats);
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
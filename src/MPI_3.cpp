@@ -7,8 +7,12 @@
 #include <algorithm>
 #include <cstdint>
 
+#include "BenchHarnessMpi.hpp"
+
 // Usage:
 //   MPI_3 <messageSizeBytes> [numIterations]
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+//   Each measured run is numIterations round trips.
 //
 // Example:
 //   mpiexec -n 2 ./MPI_3 1024 10000
@@ -57,38 +61,27 @@ int main(int argc, char** argv) {
     std::vector<char> sendBuffer(bufferSize, 'x');
     std::vector<char> recvBuffer(bufferSize, 0);
 
-    // Warm-up
-    const int warmUpIterations = std::min(10, numIterations);
-    MPI_Barrier(MPI_COMM_WORLD);
-    for (int iter = 0; iter < warmUpIterations; ++iter) {
-        if (worldRank == 0) {
-            MPI_Send(sendBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 1, 100, MPI_COMM_WORLD);
-            MPI_Recv(recvBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 1, 101, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-        }
-        else {
-            MPI_Recv(recvBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 0, 100, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            MPI_Send(sendBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 0, 101, MPI_COMM_WORLD);
-        }
-    }
-
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeStart = MPI_Wtime();
-
-    for (int iter = 0; iter < numIterations; ++iter) {
-        if (worldRank == 0) {
-            MPI_Send(sendBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 1, 100, MPI_COMM_WORLD);
-            MPI_Recv(recvBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 1, 101, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        const double timeStart = MPI_Wtime();
+
+        for (int iter = 0; iter < numIterations; ++iter) {
+            if (worldRank == 0) {
+                MPI_Send(sendBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 1, 100, MPI_COMM_WORLD);
+                MPI_Recv(recvBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 1, 101, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            }
+            else {
+                MPI_Recv(recvBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 0, 100, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                MPI_Send(sendBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 0, 101, MPI_COMM_WORLD);
+            }
         }
-        else {
-            MPI_Recv(recvBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 0, 100, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            MPI_Send(sendBuffer.data(), static_cast<int>(bufferSize), MPI_CHAR, 0, 101, MPI_COMM_WORLD);
-        }
-    }
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeEnd = MPI_Wtime();
+        MPI_Barrier(MPI_COMM_WORLD);
+        return MPI_Wtime() - timeStart;
+    });
 
-    const double totalTimeSeconds = timeEnd - timeStart;
+    const double totalTimeSeconds = stats.median;
     const double avgRoundTripSeconds = totalTimeSeconds / static_cast<double>(numIterations);
 
     double bandwidthBytesPerSec = 0.0;
@@ -98,10 +91,11 @@ int main(int argc, char** argv) {
     }
 
     if (worldRank == 0) {
-        std::cout << bufferSize << "," << worldSize << "," << numIterations << ","
-            << std::fixed << std::setprecision(6) << totalTimeSeconds << ","
-            << std::fixed << std::setprecision(9) << avgRoundTripSeconds << ","
-            << std::fixed << std::setprecision(3) << bandwidthBytesPerSec << std::endl;
+        BenchRow row;
+        row.add("messageSizeBytes", bufferSize).add("numProcesses", worldSize).add("numIterations", numIterations)
+            .addFixed("totalTimeSeconds", totalTimeSeconds, 6).addFixed("avgRoundTripSeconds", avgRoundTripSeconds, 9)
+            .addFixed("bandwidthBytesPerSec", bandwidthBytesPerSec, 3).addStats(stats);
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
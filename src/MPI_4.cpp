@@ -9,6 +9,9 @@
 #include <numeric>
 #include <cstddef>
 
+#include "BenchHarnessMpi.hpp"
+#include "CounterRng.hpp"
+
 // Two matrix-multiplication algorithms with MPI:
 // blockRow : simple row-block distribution (scatter rows of A, broadcast B)
 // cannon   : Cannon's algorithm on q x q process grid (q^2 == numProcesses)
@@ -16,6 +19,7 @@
 // Usage:
 //   MPI_4 <matrixSize> <mode> [seed]
 //   modes: blockRow | cannon
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
 
 static void multiplyAddBlock(const double* blockA, const double* blockB, double* blockC, int blockSize) {
     for (int i = 0; i < blockSize; ++i) {
@@ -75,234 +79,237 @@ int main(int argc, char** argv) {
     if (worldRank == 0) {
         fullA.assign(matrixSize * matrixSize, 0.0);
         fullB.assign(matrixSize * matrixSize, 0.0);
-        std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-        std::uniform_real_distribution<double> distribution(0.0, 1.0);
-        for (std::size_t i = 0; i < matrixSize; ++i) {
-            const std::size_t rowOff = i * matrixSize;
-            for (std::size_t j = 0; j < matrixSize; ++j) {
-                fullA[rowOff + j] = distribution(generator);
-                fullB[rowOff + j] = distribution(generator);
-            }
-        }
+        parallelFillUniformReal(fullA.data(), 0, matrixSize * matrixSize, seed, 0, 0.0, 1.0);
+        parallelFillUniformReal(fullB.data(), 0, matrixSize * matrixSize, seed, 1, 0.0, 1.0);
     }
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeStart = MPI_Wtime();
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    double checksum = 0.0;
+    const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        const double timeStart = MPI_Wtime();
 
-    std::vector<double> localC;
-    double elapsedSeconds = 0.0;
+        std::vector<double> localC;
+        double elapsedSeconds = 0.0;
 
-    if (mode == "blockRow") {
-        const std::size_t baseRows = matrixSize / static_cast<std::size_t>(worldSize);
-        const int remainder = static_cast<int>(matrixSize % static_cast<std::size_t>(worldSize));
-        const int localRows = static_cast<int>(baseRows + (worldRank < remainder ? 1u : 0u));
+        if (mode == "blockRow") {
+            const std::size_t baseRows = matrixSize / static_cast<std::size_t>(worldSize);
+            const int remainder = static_cast<int>(matrixSize % static_cast<std::size_t>(worldSize));
+            const int localRows = static_cast<int>(baseRows + (worldRank < remainder ? 1u : 0u));
 
-        std::vector<int> sendCounts(worldSize), displacements(worldSize);
-        if (worldRank == 0) {
-            std::size_t offsetRows = 0;
-            for (int p = 0; p < worldSize; ++p) {
-                std::size_t rowsForP = baseRows + (p < remainder ? 1u : 0u);
-                sendCounts[p] = static_cast<int>(rowsForP * matrixSize);
-                displacements[p] = static_cast<int>(offsetRows * matrixSize);
-                offsetRows += rowsForP;
+            std::vector<int> sendCounts(worldSize), displacements(worldSize);
+            if (worldRank == 0) {
+                std::size_t offsetRows = 0;
+                for (int p = 0; p < worldSize; ++p) {
+                    std::size_t rowsForP = baseRows + (p < remainder ? 1u : 0u);
+                    sendCounts[p] = static_cast<int>(rowsForP * matrixSize);
+                    displacements[p] = static_cast<int>(offsetRows * matrixSize);
+                    offsetRows += rowsForP;
+                }
             }
-        }
 
-        std::vector<double> localA(static_cast<std::size_t>(localRows) * matrixSize);
-        std::vector<double> localB(matrixSize * matrixSize);
-
-        MPI_Scatterv(
-            (worldRank == 0 ? fullA.data() : nullptr),
-            (worldRank == 0 ? sendCounts.data() : nullptr),
-            (worldRank == 0 ? displacements.data() : nullptr),
-            MPI_DOUBLE,
-            (localRows > 0 ? localA.data() : nullptr),
-            localRows * static_cast<int>(matrixSize),
-            MPI_DOUBLE,
-            0,
-            MPI_COMM_WORLD
-        );
-
-        MPI_Bcast((worldRank == 0 ? fullB.data() : localB.data()), static_cast<int>(matrixSize * matrixSize), MPI_DOUBLE, 0, MPI_COMM_WORLD);
-        const double* bData = (worldRank == 0 ? fullB.data() : localB.data());
-
-        localC.assign(static_cast<std::size_t>(localRows) * matrixSize, 0.0);
-        for (int i = 0; i < localRows; ++i) {
-            const std::size_t aRowOff = static_cast<std::size_t>(i) * matrixSize;
-            const std::size_t cRowOff = static_cast<std::size_t>(i) * matrixSize;
-            for (std::size_t k = 0; k < matrixSize; ++k) {
-                const double aVal = localA[aRowOff + k];
-                const std::size_t bRowOff = k * matrixSize;
-                for (std::size_t j = 0; j < matrixSize; ++j) {
-                    localC[cRowOff + j] += aVal * bData[bRowOff + j];
+            std::vector<double> localA(static_cast<std::size_t>(localRows) * matrixSize);
+            std::vector<double> localB(matrixSize * matrixSize);
+
+            MPI_Scatterv(
+                (worldRank == 0 ? fullA.data() : nullptr),
+                (worldRank == 0 ? sendCounts.data() : nullptr),
+                (worldRank == 0 ? displacements.data() : nullptr),
+                MPI_DOUBLE,
+                (localRows > 0 ? localA.data() : nullptr),
+                localRows * static_cast<int>(matrixSize),
+                MPI_DOUBLE,
+                0,
+                MPI_COMM_WORLD
+            );
+
+            MPI_Bcast((worldRank == 0 ? fullB.data() : localB.data()), static_cast<int>(matrixSize * matrixSize), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            const double* bData = (worldRank == 0 ? fullB.data() : localB.data());
+
+            localC.assign(static_cast<std::size_t>(localRows) * matrixSize, 0.0);
+            for (int i = 0; i < localRows; ++i) {
+                const std::size_t aRowOff = static_cast<std::size_t>(i) * matrixSize;
+                const std::size_t cRowOff = static_cast<std::size_t>(i) * matrixSize;
+                for (std::size_t k = 0; k < matrixSize; ++k) {
+                    const double aVal = localA[aRowOff + k];
+                    const std::size_t bRowOff = k * matrixSize;
+                    for (std::size_t j = 0; j < matrixSize; ++j) {
+                        localC[cRowOff + j] += aVal * bData[bRowOff + j];
+                    }
                 }
             }
-        }
 
-        std::vector<int> recvCounts(worldSize), recvDispls(worldSize);
-        if (worldRank == 0) {
-            std::size_t offsetRows = 0;
-            for (int p = 0; p < worldSize; ++p) {
-                std::size_t rowsForP = baseRows + (p < remainder ? 1u : 0u);
-                recvCounts[p] = static_cast<int>(rowsForP * matrixSize);
-                recvDispls[p] = static_cast<int>(offsetRows * matrixSize);
-                offsetRows += rowsForP;
+            std::vector<int> recvCounts(worldSize), recvDispls(worldSize);
+            if (worldRank == 0) {
+                std::size_t offsetRows = 0;
+                for (int p = 0; p < worldSize; ++p) {
+                    std::size_t rowsForP = baseRows + (p < remainder ? 1u : 0u);
+                    recvCounts[p] = static_cast<int>(rowsForP * matrixSize);
+                    recvDispls[p] = static_cast<int>(offsetRows * matrixSize);
+                    offsetRows += rowsForP;
+                }
             }
-        }
 
-        std::vector<double> fullC;
-        if (worldRank == 0)
-            fullC.assign(matrixSize * matrixSize, 0.0);
-
-        MPI_Gatherv(
-            (localC.empty() ? nullptr : localC.data()),
-            static_cast<int>(localC.size()),
-            MPI_DOUBLE,
-            (worldRank == 0 ? fullC.data() : nullptr),
-            (worldRank == 0 ? recvCounts.data() : nullptr),
-            (worldRank == 0 ? recvDispls.data() : nullptr),
-            MPI_DOUBLE,
-            0,
-            MPI_COMM_WORLD
-        );
+            std::vector<double> fullC;
+            if (worldRank == 0)
+                fullC.assign(matrixSize * matrixSize, 0.0);
+
+            MPI_Gatherv(
+                (localC.empty() ? nullptr : localC.data()),
+                static_cast<int>(localC.size()),
+                MPI_DOUBLE,
+                (worldRank == 0 ? fullC.data() : nullptr),
+                (worldRank == 0 ? recvCounts.data() : nullptr),
+                (worldRank == 0 ? recvDispls.data() : nullptr),
+                MPI_DOUBLE,
+                0,
+                MPI_COMM_WORLD
+            );
 
-        MPI_Barrier(MPI_COMM_WORLD);
-        elapsedSeconds = MPI_Wtime() - timeStart;
+            MPI_Barrier(MPI_COMM_WORLD);
+            elapsedSeconds = MPI_Wtime() - timeStart;
 
-        if (worldRank == 0) {
-            double checksum = 0.0;
-            for (double v : fullC) {
-                checksum += v;
+            if (worldRank == 0) {
+                checksum = 0.0;
+                for (double v : fullC) {
+                    checksum += v;
+                }
             }
-            std::cout << matrixSize << "," << worldSize << "," << "blockRow" << "," << std::fixed << std::setprecision(6) << elapsedSeconds << "," << std::setprecision(12) << checksum << std::endl;
         }
-    }
-    else if (mode == "cannon") {
-        q = static_cast<int>(std::floor(std::sqrt(static_cast<double>(worldSize)) + 0.5));
-        const int blockSizeInt = static_cast<int>(matrixSize / static_cast<std::size_t>(q));
-        const std::size_t blockSize = static_cast<std::size_t>(blockSizeInt);
+        else if (mode == "cannon") {
+            q = static_cast<int>(std::floor(std::sqrt(static_cast<double>(worldSize)) + 0.5));
+            const int blockSizeInt = static_cast<int>(matrixSize / static_cast<std::size_t>(q));
+            const std::size_t blockSize = static_cast<std::size_t>(blockSizeInt);
 
-        int dims[2] = {q, q};
-        int periods[2] = {1, 1};
-        MPI_Comm cartComm;
-        MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 1, &cartComm);
+            int dims[2] = {q, q};
+            int periods[2] = {1, 1};
+            MPI_Comm cartComm;
+            MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 1, &cartComm);
 
-        int myCoords[2];
-        MPI_Cart_coords(cartComm, worldRank, 2, myCoords);
-        const int myRow = myCoords[0], myCol = myCoords[1];
+            int myCoords[2];
+            MPI_Cart_coords(cartComm, worldRank, 2, myCoords);
+            const int myRow = myCoords[0], myCol = myCoords[1];
 
-        std::vector<double> localAblock(blockSize * blockSize);
-        std::vector<double> localBblock(blockSize * blockSize);
-        localC.assign(blockSize * blockSize, 0.0);
+            std::vector<double> localAblock(blockSize * blockSize);
+            std::vector<double> localBblock(blockSize * blockSize);
+            localC.assign(blockSize * blockSize, 0.0);
 
-        if (worldRank == 0) {
-            for (int p = 0; p < worldSize; ++p) {
-                int coords[2];
-                MPI_Cart_coords(cartComm, p, 2, coords);
-                const int prow = coords[0], pcol = coords[1];
-                const std::size_t rowStart = static_cast<std::size_t>(prow) * blockSize;
-                const std::size_t colStart = static_cast<std::size_t>(pcol) * blockSize;
-
-                std::vector<double> packA(blockSize * blockSize);
-                std::vector<double> packB(blockSize * blockSize);
-
-                for (int bi = 0; bi < blockSizeInt; ++bi) {
-                    const std::size_t srcOffA = (rowStart + static_cast<std::size_t>(bi)) * matrixSize + colStart;
-                    for (int bj = 0; bj < blockSizeInt; ++bj) {
-                        packA[static_cast<std::size_t>(bi) * blockSize + static_cast<std::size_t>(bj)] = fullA[srcOffA + static_cast<std::size_t>(bj)];
+            if (worldRank == 0) {
+                for (int p = 0; p < worldSize; ++p) {
+                    int coords[2];
+                    MPI_Cart_coords(cartComm, p, 2, coords);
+                    const int prow = coords[0], pcol = coords[1];
+                    const std::size_t rowStart = static_cast<std::size_t>(prow) * blockSize;
+                    const std::size_t colStart = static_cast<std::size_t>(pcol) * blockSize;
+
+                    std::vector<double> packA(blockSize * blockSize);
+                    std::vector<double> packB(blockSize * blockSize);
+
+                    for (int bi = 0; bi < blockSizeInt; ++bi) {
+                        const std::size_t srcOffA = (rowStart + static_cast<std::size_t>(bi)) * matrixSize + colStart;
+                        for (int bj = 0; bj < blockSizeInt; ++bj) {
+                            packA[static_cast<std::size_t>(bi) * blockSize + static_cast<std::size_t>(bj)] = fullA[srcOffA + static_cast<std::size_t>(bj)];
+                        }
                     }
-                }
-                for (int bi = 0; bi < blockSizeInt; ++bi) {
-                    const std::size_t srcOffB = (rowStart + static_cast<std::size_t>(bi)) * matrixSize + colStart;
-                    for (int bj = 0; bj < blockSizeInt; ++bj) {
-                        packB[static_cast<std::size_t>(bi) * blockSize + static_cast<std::size_t>(bj)] = fullB[srcOffB + static_cast<std::size_t>(bj)];
+                    for (int bi = 0; bi < blockSizeInt; ++bi) {
+                        const std::size_t srcOffB = (rowStart + static_cast<std::size_t>(bi)) * matrixSize + colStart;
+                        for (int bj = 0; bj < blockSizeInt; ++bj) {
+                            packB[static_cast<std::size_t>(bi) * blockSize + static_cast<std::size_t>(bj)] = fullB[srcOffB + static_cast<std::size_t>(bj)];
+                        }
                     }
-                }
 
-                if (p == 0) {
-                    localAblock = std::move(packA);
-                    localBblock = std::move(packB);
-                }
-                else {
-                    MPI_Send(packA.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, p, 17, cartComm);
-                    MPI_Send(packB.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, p, 19, cartComm);
+                    if (p == 0) {
+                        localAblock = std::move(packA);
+                        localBblock = std::move(packB);
+                    }
+                    else {
+                        MPI_Send(packA.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, p, 17, cartComm);
+                        MPI_Send(packB.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, p, 19, cartComm);
+                    }
                 }
             }
-        }
-        else {
-            MPI_Recv(localAblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, 0, 17, cartComm, MPI_STATUS_IGNORE);
-            MPI_Recv(localBblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, 0, 19, cartComm, MPI_STATUS_IGNORE);
-        }
+            else {
+                MPI_Recv(localAblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, 0, 17, cartComm, MPI_STATUS_IGNORE);
+                MPI_Recv(localBblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, 0, 19, cartComm, MPI_STATUS_IGNORE);
+            }
 
-        for (int s = 0; s < myRow; ++s) {
-            int srcRank, dstRank;
-            MPI_Cart_shift(cartComm, 1, 1, &srcRank, &dstRank);
-            MPI_Sendrecv_replace(localAblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, dstRank, 31, srcRank, 31, cartComm, MPI_STATUS_IGNORE);
-        }
-        for (int s = 0; s < myCol; ++s) {
-            int srcRank, dstRank;
-            MPI_Cart_shift(cartComm, 0, 1, &srcRank, &dstRank);
-            MPI_Sendrecv_replace(localBblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, dstRank, 33, srcRank, 33, cartComm, MPI_STATUS_IGNORE);
-        }
+            for (int s = 0; s < myRow; ++s) {
+                int srcRank, dstRank;
+                MPI_Cart_shift(cartComm, 1, 1, &srcRank, &dstRank);
+                MPI_Sendrecv_replace(localAblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, dstRank, 31, srcRank, 31, cartComm, MPI_STATUS_IGNORE);
+            }
+            for (int s = 0; s < myCol; ++s) {
+                int srcRank, dstRank;
+                MPI_Cart_shift(cartComm, 0, 1, &srcRank, &dstRank);
+                MPI_Sendrecv_replace(localBblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, dstRank, 33, srcRank, 33, cartComm, MPI_STATUS_IGNORE);
+            }
 
-        for (int iter = 0; iter < q; ++iter) {
-            multiplyAddBlock(localAblock.data(), localBblock.data(), localC.data(), blockSizeInt);
+            for (int iter = 0; iter < q; ++iter) {
+                multiplyAddBlock(localAblock.data(), localBblock.data(), localC.data(), blockSizeInt);
 
-            int srcA, dstA;
-            MPI_Cart_shift(cartComm, 1, -1, &srcA, &dstA);
-            MPI_Sendrecv_replace(localAblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, dstA, 41, srcA, 41, cartComm, MPI_STATUS_IGNORE);
+                int srcA, dstA;
+                MPI_Cart_shift(cartComm, 1, -1, &srcA, &dstA);
+                MPI_Sendrecv_replace(localAblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, dstA, 41, srcA, 41, cartComm, MPI_STATUS_IGNORE);
 
-            int srcB, dstB;
-            MPI_Cart_shift(cartComm, 0, -1, &srcB, &dstB);
-            MPI_Sendrecv_replace(localBblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, dstB, 43, srcB, 43, cartComm, MPI_STATUS_IGNORE);
-        }
+                int srcB, dstB;
+                MPI_Cart_shift(cartComm, 0, -1, &srcB, &dstB);
+                MPI_Sendrecv_replace(localBblock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, dstB, 43, srcB, 43, cartComm, MPI_STATUS_IGNORE);
+            }
 
-        if (worldRank == 0) {
-            std::vector<double> fullC(matrixSize * matrixSize, 0.0);
-
-            {
-                const int prow = 0, pcol = 0;
-                const std::size_t destRowStart = static_cast<std::size_t>(prow) * blockSize;
-                const std::size_t destColStart = static_cast<std::size_t>(pcol) * blockSize;
-                for (int bi = 0; bi < blockSizeInt; ++bi) {
-                    const std::size_t dstOff = (destRowStart + static_cast<std::size_t>(bi)) * matrixSize + destColStart;
-                    for (int bj = 0; bj < blockSizeInt; ++bj) {
-                        fullC[dstOff + static_cast<std::size_t>(bj)] = localC[static_cast<std::size_t>(bi) * blockSize + static_cast<std::size_t>(bj)];
+            if (worldRank == 0) {
+                std::vector<double> fullC(matrixSize * matrixSize, 0.0);
+
+                {
+                    const int prow = 0, pcol = 0;
+                    const std::size_t destRowStart = static_cast<std::size_t>(prow) * blockSize;
+                    const std::size_t destColStart = static_cast<std::size_t>(pcol) * blockSize;
+                    for (int bi = 0; bi < blockSizeInt; ++bi) {
+                        const std::size_t dstOff = (destRowStart + static_cast<std::size_t>(bi)) * matrixSize + destColStart;
+                        for (int bj = 0; bj < blockSizeInt; ++bj) {
+                            fullC[dstOff + static_cast<std::size_t>(bj)] = localC[static_cast<std::size_t>(bi) * blockSize + static_cast<std::size_t>(bj)];
+                        }
                     }
                 }
-            }
 
-            for (int p = 1; p < worldSize; ++p) {
-                int coords[2];
-                MPI_Cart_coords(cartComm, p, 2, coords);
-                const int prow = coords[0], pcol = coords[1];
-                const std::size_t destRowStart = static_cast<std::size_t>(prow) * blockSize;
-                const std::size_t destColStart = static_cast<std::size_t>(pcol) * blockSize;
-                std::vector<double> recvBlock(blockSize * blockSize);
-                MPI_Recv(recvBlock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, p, 51, cartComm, MPI_STATUS_IGNORE);
-                for (int bi = 0; bi < blockSizeInt; ++bi) {
-                    const std::size_t dstOff = (destRowStart + static_cast<std::size_t>(bi)) * matrixSize + destColStart;
-                    for (int bj = 0; bj < blockSizeInt; ++bj) {
-                        fullC[dstOff + static_cast<std::size_t>(bj)] = recvBlock[static_cast<std::size_t>(bi) * blockSize + static_cast<std::size_t>(bj)];
+                for (int p = 1; p < worldSize; ++p) {
+                    int coords[2];
+                    MPI_Cart_coords(cartComm, p, 2, coords);
+                    const int prow = coords[0], pcol = coords[1];
+                    const std::size_t destRowStart = static_cast<std::size_t>(prow) * blockSize;
+                    const std::size_t destColStart = static_cast<std::size_t>(pcol) * blockSize;
+                    std::vector<double> recvBlock(blockSize * blockSize);
+                    MPI_Recv(recvBlock.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, p, 51, cartComm, MPI_STATUS_IGNORE);
+                    for (int bi = 0; bi < blockSizeInt; ++bi) {
+                        const std::size_t dstOff = (destRowStart + static_cast<std::size_t>(bi)) * matrixSize + destColStart;
+                        for (int bj = 0; bj < blockSizeInt; ++bj) {
+                            fullC[dstOff + static_cast<std::size_t>(bj)] = recvBlock[static_cast<std::size_t>(bi) * blockSize + static_cast<std::size_t>(bj)];
+                        }
                     }
                 }
-            }
 
-            MPI_Barrier(MPI_COMM_WORLD);
-            elapsedSeconds = MPI_Wtime() - timeStart;
+                MPI_Barrier(MPI_COMM_WORLD);
+                elapsedSeconds = MPI_Wtime() - timeStart;
 
-            double checksum = 0.0;
-            for (double v : fullC) {
-                checksum += v;
+                checksum = 0.0;
+                for (double v : fullC) {
+                    checksum += v;
+                }
             }
-            std::cout << matrixSize << "," << worldSize << "," << "cannon" << "," << std::fixed << std::setprecision(6) << elapsedSeconds << "," << std::setprecision(12) << checksum << std::endl;
-        }
-        else {
-            MPI_Send(localC.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, 0, 51, cartComm);
-            MPI_Barrier(MPI_COMM_WORLD);
+            else {
+                MPI_Send(localC.data(), blockSizeInt * blockSizeInt, MPI_DOUBLE, 0, 51, cartComm);
+                MPI_Barrier(MPI_COMM_WORLD);
+            }
+
+            MPI_Comm_free(&cartComm);
         }
+        return elapsedSeconds;
+    });
 
-        MPI_Comm_free(&cartComm);
+    if (worldRank == 0) {
+        BenchRow row;
+        row.add("matrixSize", matrixSize).add("numProcesses", worldSize).add("mode", mode)
+            .addFixed("timeSeconds", stats.median, 6).addFixed("checksum", checksum, 12).addStats(stats);
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
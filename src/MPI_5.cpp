@@ -10,9 +10,13 @@
 #include <algorithm>
 #include <cstdint>
 
+#include "BenchHarnessMpi.hpp"
+
 // Usage:
 //   MPI_5 <messageSizeBytes> <numMessages> <computeMicroseconds> <numIterations> [computeMode]
 //   computeMode: sleep | busy (default sleep)
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+//   Each measured run is numIterations compute + exchange steps.
 
 static void busyWaitMicroseconds(long long microseconds) {
     if (microseconds <= 0)
@@ -64,60 +68,48 @@ int main(int argc, char** argv) {
     const int srcRank = (worldSize > 0) ? ((worldRank - 1 + worldSize) % worldSize) : 0;
     const int tagBase = 1000;
 
-    // Warm-up
-    MPI_Barrier(MPI_COMM_WORLD);
-    const int warmUpIters = std::min(10, numIterations);
-    for (int wi = 0; wi < warmUpIters; ++wi) {
-        if (worldSize > 1 && messageSize > 0 && numMessages > 0) {
-            for (int m = 0; m < numMessages; ++m) {
-                const int tag = tagBase + ((wi + m) & 0x7fff);
-                MPI_Sendrecv(
-                    sendBuffer.data(), messageSizeInt, MPI_CHAR, destRank, tag,
-                    recvBuffer.data(), messageSizeInt, MPI_CHAR, srcRank, tag,
-                    MPI_COMM_WORLD, MPI_STATUS_IGNORE
-                );
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        const double timeStart = MPI_Wtime();
+
+        for (int iter = 0; iter < numIterations; ++iter) {
+            if (computeMicroseconds > 0) {
+                if (computeMode == "busy") {
+                    busyWaitMicroseconds(computeMicroseconds);
+                }
+                else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(computeMicroseconds));
+                }
             }
-        }
-    }
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeStart = MPI_Wtime();
-
-    for (int iter = 0; iter < numIterations; ++iter) {
-        if (computeMicroseconds > 0) {
-            if (computeMode == "busy") {
-                busyWaitMicroseconds(computeMicroseconds);
-            }
-            else {
-                std::this_thread::sleep_for(std::chrono::microseconds(computeMicroseconds));
+            if (worldSize > 1 && messageSize > 0 && numMessages > 0) {
+                for (int m = 0; m < numMessages; ++m) {
+                    const int tag = tagBase + ((iter + m) & 0x7fff);
+                    MPI_Sendrecv(
+                        sendBuffer.data(), messageSizeInt, MPI_CHAR, destRank, tag,
+                        recvBuffer.data(), messageSizeInt, MPI_CHAR, srcRank, tag,
+                        MPI_COMM_WORLD, MPI_STATUS_IGNORE
+                    );
+                }
             }
         }
 
-        if (worldSize > 1 && messageSize > 0 && numMessages > 0) {
-            for (int m = 0; m < numMessages; ++m) {
-                const int tag = tagBase + ((iter + m) & 0x7fff);
-                MPI_Sendrecv(
-                    sendBuffer.data(), messageSizeInt, MPI_CHAR, destRank, tag,
-                    recvBuffer.data(), messageSizeInt, MPI_CHAR, srcRank, tag,
-                    MPI_COMM_WORLD, MPI_STATUS_IGNORE
-                );
-            }
-        }
-    }
-
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeEnd = MPI_Wtime();
+        MPI_Barrier(MPI_COMM_WORLD);
+        return MPI_Wtime() - timeStart;
+    });
 
-    const double totalTimeSeconds = timeEnd - timeStart;
+    const double totalTimeSeconds = stats.median;
     const double avgTimePerIteration = totalTimeSeconds / static_cast<double>(numIterations);
     const double totalBytesSentPerProcess = static_cast<double>(messageSize) * static_cast<double>(numMessages) * static_cast<double>(numIterations);
     const double bandwidthBytesPerSec = (totalTimeSeconds > 0.0) ? (totalBytesSentPerProcess / totalTimeSeconds) : 0.0;
 
     if (worldRank == 0) {
-        std::cout << messageSize << "," << numMessages << "," << computeMicroseconds << "," << numIterations << ","
-            << worldSize << "," << std::fixed << std::setprecision(6) << totalTimeSeconds << ","
-            << std::fixed << std::setprecision(9) << avgTimePerIteration << ","
-            << std::fixed << std::setprecision(3) << bandwidthBytesPerSec << std::endl;
+        BenchRow row;
+        row.add("messageSizeBytes", messageSize).add("numMessages", numMessages).add("computeMicroseconds", computeMicroseconds)
+            .add("numIterations", numIterations).add("numProcesses", worldSize).addFixed("totalTimeSeconds", totalTimeSeconds, 6)
+            .addFixed("avgTimePerIteration", avgTimePerIteration, 9).addFixed("bandwidthBytesPerSec", bandwidthBytesPerSec, 3).addStats(stats);
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
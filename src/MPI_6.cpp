@@ -1,7 +1,6 @@
 #include <mpi.h>
 #include <iostream>
 #include <vector>
-#include <random>
 #include <string>
 #include <iomanip>
 #include <algorithm>
@@ -11,6 +10,9 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "BenchHarnessMpi.hpp"
+#include "CounterRng.hpp"
+
 // Modes:
 //   collective  : MPI_Scatterv(A) + MPI_Bcast(B)
 //   manual_std  : MPI_Send / MPI_Irecv
@@ -20,6 +22,7 @@
 //
 // Usage:
 //   MPI_6 <matrixSize> <sendMode> [seed]
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
 // Example:
 //   mpiexec -n 4 ./MPI_6 512 manual_ssend 12345
 
@@ -59,15 +62,8 @@ int main(int argc, char** argv) {
     if (worldRank == 0) {
         fullA.assign(matrixSize * matrixSize, 0.0);
         fullB.assign(matrixSize * matrixSize, 0.0);
-        std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-        std::uniform_real_distribution<double> distribution(0.0, 1.0);
-        for (size_t i = 0; i < matrixSize; ++i) {
-            const size_t rowOff = i * matrixSize;
-            for (size_t j = 0; j < matrixSize; ++j) {
-                fullA[rowOff + j] = distribution(generator);
-                fullB[rowOff + j] = distribution(generator);
-            }
-        }
+        parallelFillUniformReal(fullA.data(), 0, matrixSize * matrixSize, seed, 0, 0.0, 1.0);
+        parallelFillUniformReal(fullB.data(), 0, matrixSize * matrixSize, seed, 1, 0.0, 1.0);
     }
 
     const size_t baseRows = matrixSize / static_cast<size_t>(worldSize);
@@ -95,199 +91,209 @@ int main(int argc, char** argv) {
     std::vector<double> localA(static_cast<size_t>(std::max(0, localCount)));
     std::vector<double> localB(static_cast<size_t>(matrixSize * matrixSize));
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeStart = MPI_Wtime();
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    double checksum = 0.0;
+    const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        const double timeStart = MPI_Wtime();
+
+        if (sendMode == "collective") {
+            MPI_Scatterv(
+                (worldRank == 0 ? fullA.data() : nullptr),
+                (worldRank == 0 ? sendCounts.data() : nullptr),
+                (worldRank == 0 ? displacements.data() : nullptr),
+                MPI_DOUBLE,
+                (localCount > 0 ? localA.data() : nullptr),
+                localCount,
+                MPI_DOUBLE,
+                0,
+                MPI_COMM_WORLD
+            );
+
+            MPI_Bcast((worldRank == 0 ? fullB.data() : localB.data()), matrixElemsInt, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+            if (worldRank == 0) {
+                std::copy(fullB.begin(), fullB.end(), localB.begin());
+            }
+        }
+        else {
+            MPI_Request recvRequestA = MPI_REQUEST_NULL;
+            MPI_Request recvRequestB = MPI_REQUEST_NULL;
 
-    if (sendMode == "collective") {
-        MPI_Scatterv(
-            (worldRank == 0 ? fullA.data() : nullptr),
-            (worldRank == 0 ? sendCounts.data() : nullptr),
-            (worldRank == 0 ? displacements.data() : nullptr),
-            MPI_DOUBLE,
-            (localCount > 0 ? localA.data() : nullptr),
-            localCount,
-            MPI_DOUBLE,
-            0,
-            MPI_COMM_WORLD
-        );
+            if (localCount > 0 && worldRank != 0) {
+                MPI_Irecv(localA.data(), localCount, MPI_DOUBLE, 0, 101, MPI_COMM_WORLD, &recvRequestA);
+            }
+            if (worldRank != 0) {
+                MPI_Irecv(localB.data(), matrixElemsInt, MPI_DOUBLE, 0, 102, MPI_COMM_WORLD, &recvRequestB);
+            }
 
-        MPI_Bcast((worldRank == 0 ? fullB.data() : localB.data()), matrixElemsInt, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            char* bsendBuffer = nullptr;
+            int bsendBufferSize = 0;
+            if (sendMode == "manual_bsend" && worldRank == 0) {
+                const long long bytesPerDouble = static_cast<long long>(sizeof(double));
+                long long requiredBytes = 0;
+                for (int p = 1; p < worldSize; ++p) {
+                    const long long aBytes = static_cast<long long>(sendCounts[p]) * bytesPerDouble;
+                    const long long bBytes = static_cast<long long>(matrixElemsInt) * bytesPerDouble;
+                    requiredBytes += (aBytes + static_cast<long long>(MPI_BSEND_OVERHEAD));
+                    requiredBytes += (bBytes + static_cast<long long>(MPI_BSEND_OVERHEAD));
+                }
+                const double safetyFactor = 2.0;
+                long double scaled = static_cast<long double>(requiredBytes) * safetyFactor;
+                const long long safetyMargin = 4LL * 1024 * 1024;
+                long long estimatedBytes = static_cast<long long>(scaled) + safetyMargin;
+
+                if (estimatedBytes > static_cast<long long>(INT_MAX) - 1024) {
+                    if (worldRank == 0) {
+                        std::cerr << "Warning: required MPI_Bsend buffer (" << estimatedBytes << " bytes) exceeds INT_MAX; capping to INT_MAX-1024.\n";
+                    }
+                    estimatedBytes = static_cast<long long>(INT_MAX) - 1024;
+                }
+                if (estimatedBytes < 0)
+                    estimatedBytes = static_cast<long long>(INT_MAX) - 1024;
 
-        if (worldRank == 0) {
-            std::copy(fullB.begin(), fullB.end(), localB.begin());
-        }
-    }
-    else {
-        MPI_Request recvRequestA = MPI_REQUEST_NULL;
-        MPI_Request recvRequestB = MPI_REQUEST_NULL;
+                bsendBufferSize = static_cast<int>(estimatedBytes);
 
-        if (localCount > 0 && worldRank != 0) {
-            MPI_Irecv(localA.data(), localCount, MPI_DOUBLE, 0, 101, MPI_COMM_WORLD, &recvRequestA);
-        }
-        if (worldRank != 0) {
-            MPI_Irecv(localB.data(), matrixElemsInt, MPI_DOUBLE, 0, 102, MPI_COMM_WORLD, &recvRequestB);
-        }
+                try {
+                    bsendBuffer = new char[bsendBufferSize];
+                }
+                catch (const std::bad_alloc& ex) {
+                    std::cerr << "Error: failed to allocate bsend buffer of size " << bsendBufferSize << " bytes: " << ex.what() << "\n";
+                    MPI_Abort(MPI_COMM_WORLD, 1);
+                }
 
-        char* bsendBuffer = nullptr;
-        int bsendBufferSize = 0;
-        if (sendMode == "manual_bsend" && worldRank == 0) {
-            const long long bytesPerDouble = static_cast<long long>(sizeof(double));
-            long long requiredBytes = 0;
-            for (int p = 1; p < worldSize; ++p) {
-                const long long aBytes = static_cast<long long>(sendCounts[p]) * bytesPerDouble;
-                const long long bBytes = static_cast<long long>(matrixElemsInt) * bytesPerDouble;
-                requiredBytes += (aBytes + static_cast<long long>(MPI_BSEND_OVERHEAD));
-                requiredBytes += (bBytes + static_cast<long long>(MPI_BSEND_OVERHEAD));
-            }
-            const double safetyFactor = 2.0;
-            long double scaled = static_cast<long double>(requiredBytes) * safetyFactor;
-            const long long safetyMargin = 4LL * 1024 * 1024;
-            long long estimatedBytes = static_cast<long long>(scaled) + safetyMargin;
-
-            if (estimatedBytes > static_cast<long long>(INT_MAX) - 1024) {
-                if (worldRank == 0) {
-                    std::cerr << "Warning: required MPI_Bsend buffer (" << estimatedBytes << " bytes) exceeds INT_MAX; capping to INT_MAX-1024.\n";
+                const int attachErr = MPI_Buffer_attach(bsendBuffer, bsendBufferSize);
+                if (attachErr != MPI_SUCCESS) {
+                    std::cerr << "Error: MPI_Buffer_attach failed when attaching buffer of size " << bsendBufferSize << " bytes.\n";
+                    void* detachedPtr = nullptr;
+                    int detachedSize = 0;
+                    MPI_Buffer_detach(&detachedPtr, &detachedSize);
+                    delete[] bsendBuffer;
+                    bsendBuffer = nullptr;
+                    MPI_Abort(MPI_COMM_WORLD, 2);
                 }
-                estimatedBytes = static_cast<long long>(INT_MAX) - 1024;
             }
-            if (estimatedBytes < 0)
-                estimatedBytes = static_cast<long long>(INT_MAX) - 1024;
 
-            bsendBufferSize = static_cast<int>(estimatedBytes);
+            MPI_Barrier(MPI_COMM_WORLD);
+
+            if (worldRank == 0) {
+                for (int p = 0; p < worldSize; ++p) {
+                    const int count = sendCounts[p];
+                    const int disp = displacements[p];
+                    if (p == 0) {
+                        if (count > 0) {
+                            std::copy(fullA.begin() + disp, fullA.begin() + disp + count, localA.begin());
+                        }
+                        std::copy(fullB.begin(), fullB.end(), localB.begin());
+                        continue;
+                    }
+
+                    const double* sendPtrA = (count > 0) ? (fullA.data() + disp) : nullptr;
+                    const double* sendPtrB = fullB.data();
 
-            try {
-                bsendBuffer = new char[bsendBufferSize];
+                    if (sendMode == "manual_std") {
+                        if (count > 0)
+                            MPI_Send(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
+                        MPI_Send(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
+                    }
+                    else if (sendMode == "manual_ssend") {
+                        if (count > 0)
+                            MPI_Ssend(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
+                        MPI_Ssend(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
+                    }
+                    else if (sendMode == "manual_bsend") {
+                        if (count > 0)
+                            MPI_Bsend(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
+                        MPI_Bsend(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
+                    }
+                    else if (sendMode == "manual_rsend") {
+                        if (count > 0)
+                            MPI_Rsend(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
+                        MPI_Rsend(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
+                    }
+                    else {
+                        if (count > 0)
+                            MPI_Send(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
+                        MPI_Send(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
+                    }
+                }
             }
-            catch (const std::bad_alloc& ex) {
-                std::cerr << "Error: failed to allocate bsend buffer of size " << bsendBufferSize << " bytes: " << ex.what() << "\n";
-                MPI_Abort(MPI_COMM_WORLD, 1);
+
+            if (worldRank != 0) {
+                if (localCount > 0)
+                    MPI_Wait(&recvRequestA, MPI_STATUS_IGNORE);
+                MPI_Wait(&recvRequestB, MPI_STATUS_IGNORE);
             }
 
-            const int attachErr = MPI_Buffer_attach(bsendBuffer, bsendBufferSize);
-            if (attachErr != MPI_SUCCESS) {
-                std::cerr << "Error: MPI_Buffer_attach failed when attaching buffer of size " << bsendBufferSize << " bytes.\n";
+            if (sendMode == "manual_bsend" && worldRank == 0) {
                 void* detachedPtr = nullptr;
                 int detachedSize = 0;
                 MPI_Buffer_detach(&detachedPtr, &detachedSize);
-                delete[] bsendBuffer;
-                bsendBuffer = nullptr;
-                MPI_Abort(MPI_COMM_WORLD, 2);
+                if (bsendBuffer) {
+                    delete[] bsendBuffer;
+                    bsendBuffer = nullptr;
+                }
             }
         }
 
-        MPI_Barrier(MPI_COMM_WORLD);
+        std::vector<double> localC(static_cast<size_t>(localRows) * matrixSize, 0.0);
+        for (int i = 0; i < localRows; ++i) {
+            const size_t aRowOffset = static_cast<size_t>(i) * matrixSize;
+            const size_t cRowOffset = static_cast<size_t>(i) * matrixSize;
+            for (size_t k = 0; k < matrixSize; ++k) {
+                const double aVal = localA[aRowOffset + k];
+                const size_t bRowOffset = k * matrixSize;
+                for (size_t j = 0; j < matrixSize; ++j) {
+                    localC[cRowOffset + j] += aVal * localB[bRowOffset + j];
+                }
+            }
+        }
 
+        std::vector<int> recvCounts(worldSize, 0);
+        std::vector<int> recvDispls(worldSize, 0);
         if (worldRank == 0) {
+            int offsetRows = 0;
             for (int p = 0; p < worldSize; ++p) {
-                const int count = sendCounts[p];
-                const int disp = displacements[p];
-                if (p == 0) {
-                    if (count > 0) {
-                        std::copy(fullA.begin() + disp, fullA.begin() + disp + count, localA.begin());
-                    }
-                    std::copy(fullB.begin(), fullB.end(), localB.begin());
-                    continue;
-                }
-
-                const double* sendPtrA = (count > 0) ? (fullA.data() + disp) : nullptr;
-                const double* sendPtrB = fullB.data();
-
-                if (sendMode == "manual_std") {
-                    if (count > 0)
-                        MPI_Send(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
-                    MPI_Send(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
-                }
-                else if (sendMode == "manual_ssend") {
-                    if (count > 0)
-                        MPI_Ssend(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
-                    MPI_Ssend(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
-                }
-                else if (sendMode == "manual_bsend") {
-                    if (count > 0)
-                        MPI_Bsend(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
-                    MPI_Bsend(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
-                }
-                else if (sendMode == "manual_rsend") {
-                    if (count > 0)
-                        MPI_Rsend(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
-                    MPI_Rsend(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
-                }
-                else {
-                    if (count > 0)
-                        MPI_Send(const_cast<double*>(sendPtrA), count, MPI_DOUBLE, p, 101, MPI_COMM_WORLD);
-                    MPI_Send(const_cast<double*>(sendPtrB), matrixElemsInt, MPI_DOUBLE, p, 102, MPI_COMM_WORLD);
-                }
+                const int rowsForP = static_cast<int>(baseRows + (p < remainder ? 1u : 0u));
+                recvCounts[p] = rowsForP * static_cast<int>(matrixSize);
+                recvDispls[p] = offsetRows * static_cast<int>(matrixSize);
+                offsetRows += rowsForP;
             }
         }
 
-        if (worldRank != 0) {
-            if (localCount > 0)
-                MPI_Wait(&recvRequestA, MPI_STATUS_IGNORE);
-            MPI_Wait(&recvRequestB, MPI_STATUS_IGNORE);
-        }
+        std::vector<double> fullC;
+        if (worldRank == 0)
+            fullC.assign(matrixSize * matrixSize, 0.0);
 
-        if (sendMode == "manual_bsend" && worldRank == 0) {
-            void* detachedPtr = nullptr;
-            int detachedSize = 0;
-            MPI_Buffer_detach(&detachedPtr, &detachedSize);
-            if (bsendBuffer) {
-                delete[] bsendBuffer;
-                bsendBuffer = nullptr;
-            }
-        }
-    }
+        MPI_Gatherv(
+            (localC.empty() ? nullptr : localC.data()),
+            static_cast<int>(localC.size()),
+            MPI_DOUBLE,
+            (worldRank == 0 ? fullC.data() : nullptr),
+            (worldRank == 0 ? recvCounts.data() : nullptr),
+            (worldRank == 0 ? recvDispls.data() : nullptr),
+            MPI_DOUBLE,
+            0,
+            MPI_COMM_WORLD
+        );
 
-    std::vector<double> localC(static_cast<size_t>(localRows) * matrixSize, 0.0);
-    for (int i = 0; i < localRows; ++ii) {
-        const size_t aRowOffset = static_cast<size_t>(i) * matrixSize;
-        const size_t cRowOffset = static_cast<size_t>(i) * matrixSize;
-        for (size_t k = 0; k < matrixSize; ++k) {
-            const double aVal = localA[aRowOffset + k];
-            const size_t bRowOffset = k * matrixSize;
-            for (size_t j = 0; j < matrixSize; ++j) {
-                localC[cRowOffset + j] += aVal * localB[bRowOffset + j];
-            }
-        }
-    }
+        MPI_Barrier(MPI_COMM_WORLD);
+        const double elapsedSeconds = MPI_Wtime() - timeStart;
 
-    std::vector<int> recvCounts(worldSize, 0);
-    std::vector<int> recvDispls(worldSize, 0);
-    if (worldRank == 0) {
-        int offsetRows = 0;
-        for (int p = 0; p < worldSize; ++p) {
-            const int rowsForP = static_cast<int>(baseRows + (p < remainder ? 1u : 0u));
-            recvCounts[p] = rowsForP * static_cast<int>(matrixSize);
-            recvDispls[p] = offsetRows * static_cast<int>(matrixSize);
-            offsetRows += rowsForP;
+        if (worldRank == 0) {
+            checksum = 0.0;
+            for (double v : fullC) {
+                checksum += v;
+            }
         }
-    }
-
-    std::vector<double> fullC;
-    if (worldRank == 0)
-        fullC.assign(matrixSize * matrixSize, 0.0);
-
-    MPI_Gatherv(
-        (localC.empty() ? nullptr : localC.data()),
-        static_cast<int>(localC.size()),
-        MPI_DOUBLE,
-        (worldRank == 0 ? fullC.data() : nullptr),
-        (worldRank == 0 ? recvCounts.data() : nullptr),
-        (worldRank == 0 ? recvDispls.data() : nullptr),
-        MPI_DOUBLE,
-        0,
-        MPI_COMM_WORLD
-    );
-
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeEnd = MPI_Wtime();
-    const double elapsedSeconds = timeEnd - timeStart;
+        return elapsedSeconds;
+    });
 
     if (worldRank == 0) {
-        double checksum = 0.0;
-        for (double v : fullC) {
-            checksum += v;
-        }
-        std::cout << matrixSize << "," << worldSize << "," << sendMode << "," << std::fixed << std::setprecision(6) << elapsedSeconds << "," << std::setprecision(12) << checksum << std::endl;
+        BenchRow row;
+        row.add("matrixSize", matrixSize).add("numProcesses", worldSize).add("sendMode", sendMode)
+            .addFixed("timeSeconds", stats.median, 6).addFixed("checksum", checksum, 12).addStats(stats);
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
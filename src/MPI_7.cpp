@@ -9,6 +9,8 @@
 #include <algorithm>
 #include <cstdint>
 
+#include "BenchHarnessMpi.hpp"
+
 // Usage:
 //   MPI_7 <messageSizeBytes> <numIterations> <computeUnits> <mode> [seed]
 // Modes:
@@ -16,6 +18,9 @@
 //   nonblocking  - MPI_Irecv/MPI_Isend, do compute, then MPI_Waitall
 //   comm_only    - only communication (blocking)
 //   compute_only - only computation
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+//   Each measured run is numIterations steps; the avg* columns are the medians
+//   over runs of the per-rank averages.
 //
 // Example:
 //   mpiexec -n 6 ./MPI_7 65536 50 200 nonblocking 12345
@@ -82,106 +87,113 @@ int main(int argc, char** argv) {
     const int srcRank = (worldRank - 1 + worldSize) % worldSize;
     const int tagA = 100;
 
-    // Warm-up
-    MPI_Barrier(MPI_COMM_WORLD);
-    for (int w = 0; w < 2; ++w) {
-        if (mode != "compute_only" && worldSize > 1) {
-            MPI_Sendrecv(sendBuffer.data(), bufferCountInt, MPI_BYTE, destRank, tagA,
-                recvBuffer.data(), bufferCountInt, MPI_BYTE, srcRank, tagA,
-                MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-        }
-    }
-    MPI_Barrier(MPI_COMM_WORLD);
-
-    double totalWallTime = 0.0;
-    double totalCommTime = 0.0;    // measured communication time (blocking sendrecv or Wait)
-    double totalComputeTime = 0.0; // measured compute time
-
-    const double globalStart = MPI_Wtime();
-
-    if (mode == "blocking") {
-        for (int iter = 0; iter < numIterations; ++iter) {
-            const double compStart = MPI_Wtime();
-            if (computeUnits > 0)
-                doComputeWork(computeUnits);
-            const double compEnd = MPI_Wtime();
-            totalComputeTime += (compEnd - compStart);
-
-            const double commStart = MPI_Wtime();
-            if (worldSize > 1)
-                MPI_Sendrecv(sendBuffer.data(), bufferCountInt, MPI_BYTE, destRank, tagA,
-                    recvBuffer.data(), bufferCountInt, MPI_BYTE, srcRank, tagA,
-                    MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            const double commEnd = MPI_Wtime();
-            totalCommTime += (commEnd - commStart);
-        }
+    if (mode != "blocking" && mode != "nonblocking" && mode != "comm_only" && mode != "compute_only") {
+        if (worldRank == 0)
+            std::cerr << "Unknown mode: " << mode << "\n";
+        MPI_Finalize();
+        return 3;
     }
-    else if (mode == "nonblocking") {
-        for (int iter = 0; iter < numIterations; ++iter) {
-            MPI_Request reqs[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
-            MPI_Status stats[2];
-
-            if (worldSize > 1) {
-                MPI_Irecv(recvBuffer.data(), bufferCountInt, MPI_BYTE, srcRank, tagA, MPI_COMM_WORLD, &reqs[0]);
-                MPI_Isend(sendBuffer.data(), bufferCountInt, MPI_BYTE, destRank, tagA, MPI_COMM_WORLD, &reqs[1]);
-            }
 
-            const double compStart = MPI_Wtime();
-            if (computeUnits > 0)
-                doComputeWork(computeUnits);
-            const double compEnd = MPI_Wtime();
-            totalComputeTime += (compEnd - compStart);
-
-            if (worldSize > 1) {
-                const double waitStart = MPI_Wtime();
-                MPI_Waitall(2, reqs, stats);
-                const double waitEnd = MPI_Wtime();
-                totalCommTime += (waitEnd - waitStart);
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    std::vector<double> wallSamples, commSamples, computeSamples;
+    int completedRuns = 0;
+    const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        double totalWallTime = 0.0;
+        double totalCommTime = 0.0;    // measured communication time (blocking sendrecv or Wait)
+        double totalComputeTime = 0.0; // measured compute time
+
+        const double globalStart = MPI_Wtime();
+
+        if (mode == "blocking") {
+            for (int iter = 0; iter < numIterations; ++iter) {
+                const double compStart = MPI_Wtime();
+                if (computeUnits > 0)
+                    doComputeWork(computeUnits);
+                const double compEnd = MPI_Wtime();
+                totalComputeTime += (compEnd - compStart);
+
+                const double commStart = MPI_Wtime();
+                if (worldSize > 1)
+                    MPI_Sendrecv(sendBuffer.data(), bufferCountInt, MPI_BYTE, destRank, tagA,
+                        recvBuffer.data(), bufferCountInt, MPI_BYTE, srcRank, tagA,
+                        MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                const double commEnd = MPI_Wtime();
+                totalCommTime += (commEnd - commStart);
             }
         }
-    }
-    else if (mode == "comm_only") {
-        for (int iter = 0; iter < numIterations; ++iter) {
-            const double commStart = MPI_Wtime();
-            if (worldSize > 1)
-                MPI_Sendrecv(sendBuffer.data(), bufferCountInt, MPI_BYTE, destRank, tagA,
-                    recvBuffer.data(), bufferCountInt, MPI_BYTE, srcRank, tagA,
-                    MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            const double commEnd = MPI_Wtime();
-            totalCommTime += (commEnd - commStart);
+        else if (mode == "nonblocking") {
+            for (int iter = 0; iter < numIterations; ++iter) {
+                MPI_Request reqs[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+                MPI_Status stats[2];
+
+                if (worldSize > 1) {
+                    MPI_Irecv(recvBuffer.data(), bufferCountInt, MPI_BYTE, srcRank, tagA, MPI_COMM_WORLD, &reqs[0]);
+                    MPI_Isend(sendBuffer.data(), bufferCountInt, MPI_BYTE, destRank, tagA, MPI_COMM_WORLD, &reqs[1]);
+                }
+
+                const double compStart = MPI_Wtime();
+                if (computeUnits > 0)
+                    doComputeWork(computeUnits);
+                const double compEnd = MPI_Wtime();
+                totalComputeTime += (compEnd - compStart);
+
+                if (worldSize > 1) {
+                    const double waitStart = MPI_Wtime();
+                    MPI_Waitall(2, reqs, stats);
+                    const double waitEnd = MPI_Wtime();
+                    totalCommTime += (waitEnd - waitStart);
+                }
+            }
         }
-    }
-    else if (mode == "compute_only") {
-        for (int iter = 0; iter < numIterations; ++iter) {
-            const double compStart = MPI_Wtime();
-            if (computeUnits > 0)
-                doComputeWork(computeUnits);
-            const double compEnd = MPI_Wtime();
-            totalComputeTime += (compEnd - compStart);
+        else if (mode == "comm_only") {
+            for (int iter = 0; iter < numIterations; ++iter) {
+                const double commStart = MPI_Wtime();
+                if (worldSize > 1)
+                    MPI_Sendrecv(sendBuffer.data(), bufferCountInt, MPI_BYTE, destRank, tagA,
+                        recvBuffer.data(), bufferCountInt, MPI_BYTE, srcRank, tagA,
+                        MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                const double commEnd = MPI_Wtime();
+                totalCommTime += (commEnd - commStart);
+            }
+        }
+        else if (mode == "compute_only") {
+            for (int iter = 0; iter < numIterations; ++iter) {
+                const double compStart = MPI_Wtime();
+                if (computeUnits > 0)
+                    doComputeWork(computeUnits);
+                const double compEnd = MPI_Wtime();
+                totalComputeTime += (compEnd - compStart);
+            }
         }
-    }
-    else {
-        if (worldRank == 0)
-            std::cerr << "Unknown mode: " << mode << "\n";
-        MPI_Finalize();
-        return 3;
-    }
 
-    const double globalEnd = MPI_Wtime();
-    totalWallTime = globalEnd - globalStart;
+        const double globalEnd = MPI_Wtime();
+        totalWallTime = globalEnd - globalStart;
 
-    double sumWallTime = 0.0, sumCommTime = 0.0, sumComputeTime = 0.0;
-    MPI_Reduce(&totalWallTime, &sumWallTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&totalCommTime, &sumCommTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&totalComputeTime, &sumComputeTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        double sumWallTime = 0.0, sumCommTime = 0.0, sumComputeTime = 0.0;
+        MPI_Reduce(&totalWallTime, &sumWallTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&totalCommTime, &sumCommTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&totalComputeTime, &sumComputeTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
 
-    if (worldRank == 0) {
-        const double avgWall = sumWallTime / static_cast<double>(worldSize);
-        const double avgComm = sumCommTime / static_cast<double>(worldSize);
-        const double avgCompute = sumComputeTime / static_cast<double>(worldSize);
+        if (worldRank == 0 && ++completedRuns > benchConfig.warmUpRuns) {
+            wallSamples.push_back(sumWallTime / static_cast<double>(worldSize));
+            commSamples.push_back(sumCommTime / static_cast<double>(worldSize));
+            computeSamples.push_back(sumComputeTime / static_cast<double>(worldSize));
+        }
+        return totalWallTime;
+    });
 
-        std::cout << "MPI_7," << static_cast<unsigned long long>(messageSize) << "," << worldSize << "," << mode << "," << numIterations << "," << computeUnits << ","
-            << std::fixed << std::setprecision(6) << avgWall << "," << avgComm << "," << avgCompute << std::endl;
+    if (worldRank == 0) {
+        const double avgWall = summarizeBenchSamples(wallSamples, false).median;
+        const double avgComm = summarizeBenchSamples(commSamples, false).median;
+        const double avgCompute = summarizeBenchSamples(computeSamples, false).median;
+
+        BenchRow row;
+        row.add("testType", "MPI_7").add("messageSizeBytes", static_cast<unsigned long long>(messageSize)).add("numProcesses", worldSize)
+            .add("mode", mode).add("numIterations", numIterations).add("computeUnits", computeUnits)
+            .addFixed("avgWallSeconds", avgWall, 6).addFixed("avgCommSeconds", avgComm, 6).addFixed("avgComputeSeconds", avgCompute, 6).addStats(stats);
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
@@ -8,9 +8,13 @@
 #include <algorithm>
 #include <cstdint>
 
+#include "BenchHarnessMpi.hpp"
+
 // Usage:
 //   MPI_8 <messageSizeBytes> <mode> [numIterations]
 //   modes: separate | sendrecv | isend_irecv
+//   BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+//   Each measured run is numIterations exchanges.
 // Example:
 //   mpiexec -n 2 ./MPI_8 65536 sendrecv 10000
 
@@ -67,68 +71,44 @@ int main(int argc, char** argv) {
     const int tagRecv = tagSend;
     const int partnerRank = (worldRank == 0) ? 1 : 0;
 
-    // Warm-up
-    const int warmUpIterations = std::min(10, numIterations);
-    MPI_Barrier(MPI_COMM_WORLD);
-    for (int i = 0; i < warmUpIterations; ++i) {
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    const BenchStats stats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        const double timeStart = MPI_Wtime();
+
         if (mode == "sendrecv") {
-            MPI_Sendrecv(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend,
-                recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv,
-                MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            for (int iter = 0; iter < numIterations; ++iter) {
+                MPI_Sendrecv(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend,
+                    recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv,
+                    MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            }
         }
         else if (mode == "isend_irecv") {
-            MPI_Request reqs[2];
-            MPI_Irecv(recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv, MPI_COMM_WORLD, &reqs[0]);
-            MPI_Isend(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend, MPI_COMM_WORLD, &reqs[1]);
-            MPI_Waitall(2, reqs, MPI_STATUSES_IGNORE);
-        }
-        else { // separate
-            if (worldRank == 0) {
-                MPI_Send(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend, MPI_COMM_WORLD);
-                MPI_Recv(recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            }
-            else {
-                MPI_Recv(recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                MPI_Send(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv, MPI_COMM_WORLD);
+            for (int iter = 0; iter < numIterations; ++iter) {
+                MPI_Request reqs[2];
+                MPI_Irecv(recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv, MPI_COMM_WORLD, &reqs[0]);
+                MPI_Isend(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend, MPI_COMM_WORLD, &reqs[1]);
+                MPI_Waitall(2, reqs, MPI_STATUSES_IGNORE);
             }
         }
-    }
-    MPI_Barrier(MPI_COMM_WORLD);
-
-    const double timeStart = MPI_Wtime();
-
-    if (mode == "sendrecv") {
-        for (int iter = 0; iter < numIterations; ++iter) {
-            MPI_Sendrecv(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend,
-                recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv,
-                MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-        }
-    }
-    else if (mode == "isend_irecv") {
-        for (int iter = 0; iter < numIterations; ++iter) {
-            MPI_Request reqs[2];
-            MPI_Irecv(recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv, MPI_COMM_WORLD, &reqs[0]);
-            MPI_Isend(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend, MPI_COMM_WORLD, &reqs[1]);
-            MPI_Waitall(2, reqs, MPI_STATUSES_IGNORE);
-        }
-    }
-    else { // separate
-        for (int iter = 0; iter < numIterations; ++iter) {
-            if (worldRank == 0) {
-                MPI_Send(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend, MPI_COMM_WORLD);
-                MPI_Recv(recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            }
-            else {
-                MPI_Recv(recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                MPI_Send(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv, MPI_COMM_WORLD);
+        else { // separate
+            for (int iter = 0; iter < numIterations; ++iter) {
+                if (worldRank == 0) {
+                    MPI_Send(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend, MPI_COMM_WORLD);
+                    MPI_Recv(recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                }
+                else {
+                    MPI_Recv(recvBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagSend, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                    MPI_Send(sendBuffer.data(), messageSizeInt, MPI_CHAR, partnerRank, tagRecv, MPI_COMM_WORLD);
+                }
             }
         }
-    }
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    const double timeEnd = MPI_Wtime();
+        MPI_Barrier(MPI_COMM_WORLD);
+        return MPI_Wtime() - timeStart;
+    });
 
-    const double totalTimeSeconds = timeEnd - timeStart;
+    const double totalTimeSeconds = stats.median;
     const double avgRoundTripSeconds = totalTimeSeconds / static_cast<double>(numIterations);
 
     double bandwidthBytesPerSec = 0.0;
@@ -137,10 +117,11 @@ int main(int argc, char** argv) {
     }
 
     if (worldRank == 0) {
-        std::cout << "MPI_8," << static_cast<unsigned long long>(messageSize) << "," << worldSize << "," << mode << "," << numIterations << ","
-            << std::fixed << std::setprecision(6) << totalTimeSeconds << ","
-            << std::fixed << std::setprecision(9) << avgRoundTripSeconds << ","
-            << std::fixed << std::setprecision(3) << bandwidthBytesPerSec << std::endl;
+        BenchRow row;
+        row.add("testType", "MPI_8").add("messageSize", static_cast<unsigned long long>(messageSize)).add("numProcesses", worldSize)
+            .add("mode", mode).add("numIterations", numIterations).addFixed("totalTime", totalTimeSeconds, 6)
+            .addFixed("avgRoundTrip", avgRoundTripSeconds, 9).addFixed("bandwidth", bandwidthBytesPerSec, 3).addStats(stats);
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
@@ -9,6 +9,8 @@
 #include <iomanip>
 #include <algorithm>
 
+#include "BenchHarnessMpi.hpp"
+
 // Implemented collectives (custom):
 //   customBroadcast (binomial tree)
 //   customReduce (binomial tree, sum)
@@ -20,6 +22,9 @@
 // Usage:
 //   MPI_9 <opName> <messageSizeBytes> [numIterations]
 // opName: bcast | reduce | scatter | gather | allgather | alltoall
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// Each measured run is numIterations operations; the custom and MPI versions
+// are measured separately and get one set of statistics columns each.
 // Example:
 //   mpiexec -n 4 ./MPI_9 bcast 65536 200
 
@@ -290,106 +295,84 @@ int main(int argc, char** argv) {
 
     MPI_Barrier(MPI_COMM_WORLD);
 
-    // Warm-up
-    if (opName == "bcast") {
-        int root = 0;
-        if (worldRank == root)
-            std::memcpy(recvBuffer.data(), sendBuffer.data(), static_cast<size_t>(messageSizeBytes));
-        customBroadcast(recvBuffer.data(), messageSizeBytes, root, MPI_COMM_WORLD);
-    }
-    else if (opName == "reduce") {
-        int root = 0;
-        std::vector<double> tmpRecv(sendReduceD.size(), 0.0);
-        customReduce(sendReduceD.data(), tmpRecv.data(), static_cast<int>(sendReduceD.size()), root, MPI_COMM_WORLD);
-    }
-    else if (opName == "scatter") {
-        customScatter(sendBuffer.data(), recvBuffer.data(), chunk, 0, MPI_COMM_WORLD);
-    }
-    else if (opName == "gather") {
-        customGather(sendBuffer.data(), recvBuffer.data(), chunk, 0, MPI_COMM_WORLD);
-    }
-    else if (opName == "allgather") {
-        customAllGather(sendBuffer.empty() ? nullptr : sendBuffer.data() + static_cast<size_t>(worldRank) * static_cast<size_t>(chunk),
-            recvBuffer.data(), chunk, MPI_COMM_WORLD);
-    }
-    else if (opName == "alltoall") {
-        customAllToAll(sendBuffer.data(), recvBuffer.data(), chunk, MPI_COMM_WORLD);
-    }
-
-    MPI_Barrier(MPI_COMM_WORLD);
-
     // measure custom
-    double startCustom = MPI_Wtime();
-    for (int it = 0; it < numIterations; ++it) {
-        if (opName == "bcast") {
-            int root = 0;
-            if (worldRank == root)
-                std::memcpy(recvBuffer.data(), sendBuffer.data(), static_cast<size_t>(messageSizeBytes));
-            customBroadcast(recvBuffer.data(), messageSizeBytes, root, MPI_COMM_WORLD);
-        }
-        else if (opName == "reduce") {
-            int root = 0;
-            std::vector<double> tmpRecv(sendReduceD.size(), 0.0);
-            customReduce(sendReduceD.data(), tmpRecv.data(), static_cast<int>(sendReduceD.size()), root, MPI_COMM_WORLD);
-            if (worldRank == root)
-                std::memcpy(recvReduceD.data(), tmpRecv.data(), tmpRecv.size() * sizeof(double));
-        }
-        else if (opName == "scatter") {
-            customScatter(sendBuffer.data(), recvBuffer.data(), chunk, 0, MPI_COMM_WORLD);
-        }
-        else if (opName == "gather") {
-            customGather(sendBuffer.data(), recvBuffer.data(), chunk, 0, MPI_COMM_WORLD);
-        }
-        else if (opName == "allgather") {
-            customAllGather(sendBuffer.data() + static_cast<size_t>(worldRank) * static_cast<size_t>(chunk), recvBuffer.data(), chunk, MPI_COMM_WORLD);
-        }
-        else if (opName == "alltoall") {
-            customAllToAll(sendBuffer.data(), recvBuffer.data(), chunk, MPI_COMM_WORLD);
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    const BenchStats customStats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        double startCustom = MPI_Wtime();
+        for (int it = 0; it < numIterations; ++it) {
+            if (opName == "bcast") {
+                int root = 0;
+                if (worldRank == root)
+                    std::memcpy(recvBuffer.data(), sendBuffer.data(), static_cast<size_t>(messageSizeBytes));
+                customBroadcast(recvBuffer.data(), messageSizeBytes, root, MPI_COMM_WORLD);
+            }
+            else if (opName == "reduce") {
+                int root = 0;
+                std::vector<double> tmpRecv(sendReduceD.size(), 0.0);
+                customReduce(sendReduceD.data(), tmpRecv.data(), static_cast<int>(sendReduceD.size()), root, MPI_COMM_WORLD);
+                if (worldRank == root)
+                    std::memcpy(recvReduceD.data(), tmpRecv.data(), tmpRecv.size() * sizeof(double));
+            }
+            else if (opName == "scatter") {
+                customScatter(sendBuffer.data(), recvBuffer.data(), chunk, 0, MPI_COMM_WORLD);
+            }
+            else if (opName == "gather") {
+                customGather(sendBuffer.data(), recvBuffer.data(), chunk, 0, MPI_COMM_WORLD);
+            }
+            else if (opName == "allgather") {
+                customAllGather(sendBuffer.data() + static_cast<size_t>(worldRank) * static_cast<size_t>(chunk), recvBuffer.data(), chunk, MPI_COMM_WORLD);
+            }
+            else if (opName == "alltoall") {
+                customAllToAll(sendBuffer.data(), recvBuffer.data(), chunk, MPI_COMM_WORLD);
+            }
         }
-    }
-    MPI_Barrier(MPI_COMM_WORLD);
-    double endCustom = MPI_Wtime();
-    double customTime = (endCustom - startCustom) / static_cast<double>(numIterations);
+        MPI_Barrier(MPI_COMM_WORLD);
+        return MPI_Wtime() - startCustom;
+    });
+    const double customTime = customStats.median / static_cast<double>(numIterations);
 
     // measure MPI builtin
-    MPI_Barrier(MPI_COMM_WORLD);
-    double startMpi = MPI_Wtime();
-    for (int it = 0; it < numIterations; ++it) {
-        if (opName == "bcast") {
-            int root = 0;
-            if (worldRank == root)
-                std::memcpy(recvBuffer.data(), sendBuffer.data(), static_cast<size_t>(messageSizeBytes));
-            MPI_Bcast(recvBuffer.data(), messageSizeBytes, MPI_BYTE, root, MPI_COMM_WORLD);
-        }
-        else if (opName == "reduce") {
-            int root = 0;
-            std::vector<double> tmpRecv(sendReduceD.size(), 0.0);
-            MPI_Reduce(sendReduceD.data(), tmpRecv.data(), static_cast<int>(sendReduceD.size()), MPI_DOUBLE, MPI_SUM, root, MPI_COMM_WORLD);
-            if (worldRank == root)
-                std::memcpy(recvReduceD.data(), tmpRecv.data(), tmpRecv.size() * sizeof(double));
-        }
-        else if (opName == "scatter") {
-            int root = 0;
-            MPI_Scatter((worldRank == root ? sendBuffer.data() : nullptr), chunk, MPI_BYTE,
-                recvBuffer.data(), chunk, MPI_BYTE, root, MPI_COMM_WORLD);
-        }
-        else if (opName == "gather") {
-            int root = 0;
-            MPI_Gather(sendBuffer.data(), chunk, MPI_BYTE,
-                (worldRank == root ? recvBuffer.data() : nullptr), chunk, MPI_BYTE, root, MPI_COMM_WORLD);
-        }
-        else if (opName == "allgather") {
-            MPI_Allgather(sendBuffer.data() + static_cast<size_t>(worldRank) * static_cast<size_t>(chunk), chunk, MPI_BYTE,
-                recvBuffer.data(), chunk, MPI_BYTE, MPI_COMM_WORLD);
-        }
-        else if (opName == "alltoall") {
-            MPI_Alltoall(sendBuffer.data(), chunk, MPI_BYTE,
-                recvBuffer.data(), chunk, MPI_BYTE, MPI_COMM_WORLD);
+    const BenchStats mpiStats = runBenchmarkMpi(benchConfig, MPI_COMM_WORLD, [&]() {
+        MPI_Barrier(MPI_COMM_WORLD);
+        double startMpi = MPI_Wtime();
+        for (int it = 0; it < numIterations; ++it) {
+            if (opName == "bcast") {
+                int root = 0;
+                if (worldRank == root)
+                    std::memcpy(recvBuffer.data(), sendBuffer.data(), static_cast<size_t>(messageSizeBytes));
+                MPI_Bcast(recvBuffer.data(), messageSizeBytes, MPI_BYTE, root, MPI_COMM_WORLD);
+            }
+            else if (opName == "reduce") {
+                int root = 0;
+                std::vector<double> tmpRecv(sendReduceD.size(), 0.0);
+                MPI_Reduce(sendReduceD.data(), tmpRecv.data(), static_cast<int>(sendReduceD.size()), MPI_DOUBLE, MPI_SUM, root, MPI_COMM_WORLD);
+                if (worldRank == root)
+                    std::memcpy(recvReduceD.data(), tmpRecv.data(), tmpRecv.size() * sizeof(double));
+            }
+            else if (opName == "scatter") {
+                int root = 0;
+                MPI_Scatter((worldRank == root ? sendBuffer.data() : nullptr), chunk, MPI_BYTE,
+                    recvBuffer.data(), chunk, MPI_BYTE, root, MPI_COMM_WORLD);
+            }
+            else if (opName == "gather") {
+                int root = 0;
+                MPI_Gather(sendBuffer.data(), chunk, MPI_BYTE,
+                    (worldRank == root ? recvBuffer.data() : nullptr), chunk, MPI_BYTE, root, MPI_COMM_WORLD);
+            }
+            else if (opName == "allgather") {
+                MPI_Allgather(sendBuffer.data() + static_cast<size_t>(worldRank) * static_cast<size_t>(chunk), chunk, MPI_BYTE,
+                    recvBuffer.data(), chunk, MPI_BYTE, MPI_COMM_WORLD);
+            }
+            else if (opName == "alltoall") {
+                MPI_Alltoall(sendBuffer.data(), chunk, MPI_BYTE,
+                    recvBuffer.data(), chunk, MPI_BYTE, MPI_COMM_WORLD);
+            }
         }
-    }
-    MPI_Barrier(MPI_COMM_WORLD);
-    double endMpi = MPI_Wtime();
-    double mpiTime = (endMpi - startMpi) / static_cast<double>(numIterations);
+        MPI_Barrier(MPI_COMM_WORLD);
+        return MPI_Wtime() - startMpi;
+    });
+    const double mpiTime = mpiStats.median / static_cast<double>(numIterations);
 
     unsigned long long checksum = 0ULL;
     if (opName == "bcast") {
@@ -419,9 +402,11 @@ int main(int argc, char** argv) {
     }
 
     if (worldRank == 0) {
-        std::cout << "MPI_9," << opName << "," << messageSizeBytes << "," << worldSize << ","
-            << std::fixed << std::setprecision(9) << customTime << ","
-            << std::fixed << std::setprecision(9) << mpiTime << "," << checksum << std::endl;
+        BenchRow row;
+        row.add("testType", "MPI_9").add("opName", opName).add("messageSizeBytes", messageSizeBytes).add("numProcesses", worldSize)
+            .addFixed("customTime", customTime, 9).addFixed("mpiTime", mpiTime, 9).add("checksum", checksum)
+            .addStats(customStats, "custom").addStats(mpiStats, "mpi");
+        row.print(std::cout, benchConfig);
     }
 
     MPI_Finalize();
@@ -1,18 +1,28 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <limits>
 #include <string>
 #include <algorithm>
 #include <omp.h>
 
-// Usage: OpenMP_1 <problemSize> <mode> [seed]
-// mode: reduction | no_reduction
+#include "BenchHarness.hpp"
+#include "CounterRng.hpp"
+#include "MappedDataset.hpp"
+#include "NumaAllocator.hpp"
+#include "SimdMin.hpp"
+
+// Usage: OpenMP_1 <problemSize> <mode> [seed] [datasetPath]
+// mode: reduction | no_reduction | simd | stream
+// simd: explicit SSE4.1/AVX2/AVX-512 kernel picked by CPUID; SIMD_ISA=<level> caps it
+// stream: dataset written once to datasetPath (default ../results/OpenMP_1_dataset.bin),
+//         then memory-mapped and streamed by page-aligned per-thread ranges
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// NUMA_POLICY (env): master | first_touch | interleave | bind (NUMA_BIND_NODE, default 0)
 
 int main(int argc, char** argv) {
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <problemSize> <mode> [seed]\n";
+        std::cerr << "Usage: " << argv[0] << " <problemSize> <mode> [seed] [datasetPath]\n";
         return 1;
     }
 
@@ -20,64 +30,123 @@ int main(int argc, char** argv) {
     const std::string mode = argv[2];
     const unsigned int seed = (argc >= 4) ? static_cast<unsigned int>(std::stoul(argv[3])) : 12345u;
 
-    std::vector<int> dataVector;
-    dataVector.resize(problemSize);
-    std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-    std::uniform_int_distribution<int> distribution(0, 1000000000);
+    const std::string datasetPath = (argc >= 5) ? argv[4] : "../results/OpenMP_1_dataset.bin";
+    const bool streamMode = (mode == "stream");
 
-    for (std::size_t i = 0; i < problemSize; ++i) {
-        dataVector[i] = distribution(generator);
+    if (mode != "reduction" && mode != "no_reduction" && mode != "simd" && !streamMode) {
+        std::cerr << "Unknown mode: " << mode << "\n";
+        return 2;
     }
 
-    // Warm-up
-    {
-        volatile long long warmUpSum = 0;
-        const std::size_t warmUpLimit = std::min<std::size_t>(problemSize, static_cast<std::size_t>(1000));
-        for (std::size_t i = 0; i < warmUpLimit; ++i) {
-            warmUpSum += dataVector[i];
+    const NumaPolicy numaPolicy = numaPolicyFromEnv();
+    const int numaBindNode = numaBindNodeFromEnv();
+    NumaVector<int> dataVector(NumaAllocator<int>(numaPolicy, numaBindNode));
+
+    MappedFile mappedFile;
+    const int* mappedData = nullptr;
+
+    if (streamMode) {
+        const bool datasetReady = ensureDatasetFile<int, 1>(datasetPath, problemSize, seed,
+            [&](std::size_t begin, std::size_t count, const std::array<int*, 1>& chunks) {
+                parallelFillUniformInt(chunks[0], begin, count, seed, 0, 0, 1000000000);
+            });
+        if (!datasetReady || !mappedFile.open(datasetPath)) {
+            std::cerr << "Failed to prepare mapped dataset: " << datasetPath << "\n";
+            return 3;
         }
-        (void)warmUpSum;
+        const DatasetHeader header = makeDatasetHeader(problemSize, sizeof(int), 1, seed);
+        mappedData = reinterpret_cast<const int*>(mappedFile.data() + datasetArrayOffset(header, 0));
+        mappedFile.adviseSequential();
+    }
+    else {
+        dataVector.resize(problemSize);
+        initializeWithPolicy(numaPolicy, problemSize, [&](std::size_t begin, std::size_t end) {
+            fillUniformInt(dataVector.data() + begin, begin, end - begin, seed, 0, 0, 1000000000);
+        });
     }
 
     const int numThreads = omp_get_max_threads();
+    const SimdLevel simdLevel = selectSimdLevel();
+    const MinKernelFunction<int> minKernel = selectMinKernel<int>(simdLevel);
+    const std::string modeReported = (mode == "simd" || streamMode) ? mode + "_" + simdLevelName(simdLevel) : mode;
+    const BenchConfig benchConfig = benchConfigFromEnv();
     int globalMin = std::numeric_limits<int>::max();
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+    const BenchStats stats = runBenchmark(benchConfig, [&]() {
+        globalMin = std::numeric_limits<int>::max();
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-    if (mode == "reduction") {
-        #pragma omp parallel for reduction(min: globalMin)
-        for (std::size_t i = 0; i < problemSize; ++i) {
-            if (dataVector[i] < globalMin)
-                globalMin = dataVector[i];
+        if (mode == "reduction") {
+            #pragma omp parallel for reduction(min: globalMin)
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                if (dataVector[i] < globalMin)
+                    globalMin = dataVector[i];
+            }
         }
-    }
-    else if (mode == "no_reduction") {
-        #pragma omp parallel
-        {
-            int localMin = std::numeric_limits<int>::max();
+        else if (mode == "no_reduction") {
+            #pragma omp parallel
+            {
+                int localMin = std::numeric_limits<int>::max();
 
-            #pragma omp for
-            for (std::size_t i = 0; i < problemSize; ++i) {
-                if (dataVector[i] < localMin)
-                    localMin = dataVector[i];
+                #pragma omp for
+                for (std::size_t i = 0; i < problemSize; ++i) {
+                    if (dataVector[i] < localMin)
+                        localMin = dataVector[i];
+                }
+
+                #pragma omp critical
+                {
+                    if (localMin < globalMin)
+                        globalMin = localMin;
+                }
             }
+        }
+        else if (mode == "simd") {
+            // Each thread scans one contiguous static block with the vector kernel;
+            // the per-thread minima are folded by the reduction afterwards.
+            #pragma omp parallel reduction(min: globalMin)
+            {
+                std::size_t begin = 0;
+                std::size_t end = 0;
+                staticBlockRange(problemSize, static_cast<std::size_t>(omp_get_thread_num()),
+                    static_cast<std::size_t>(omp_get_num_threads()), begin, end);
 
-            #pragma omp critical
+                const int localMin = minKernel(dataVector.data() + begin, end - begin);
+                if (localMin < globalMin)
+                    globalMin = localMin;
+            }
+        }
+        else if (streamMode) {
+            // Page-aligned contiguous range per thread, consumed window by window
+            // with readahead on the next window.
+            const std::size_t granularity = datasetAlignment / sizeof(int);
+            #pragma omp parallel reduction(min: globalMin)
             {
+                std::size_t begin = 0;
+                std::size_t end = 0;
+                alignedThreadRange(problemSize, granularity, static_cast<std::size_t>(omp_get_thread_num()),
+                    static_cast<std::size_t>(omp_get_num_threads()), begin, end);
+
+                int localMin = std::numeric_limits<int>::max();
+                streamMappedWindows<int, 1>({ mappedData }, begin, end, [&](std::size_t windowBegin, std::size_t windowEnd) {
+                    const int windowMin = minKernel(mappedData + windowBegin, windowEnd - windowBegin);
+                    if (windowMin < localMin)
+                        localMin = windowMin;
+                });
                 if (localMin < globalMin)
                     globalMin = localMin;
             }
         }
-    }
-    else {
-        std::cerr << "Unknown mode: " << mode << "\n";
-        return 2;
-    }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double timeSeconds = std::chrono::duration<double>(endTime - startTime).count();
+        auto endTime = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(endTime - startTime).count();
+    });
 
-    std::cout << problemSize << "," << numThreads << "," << mode << "," << timeSeconds << "," << globalMin << std::endl;
+    BenchRow row;
+    row.add("problemSize", problemSize).add("numThreads", numThreads).add("mode", modeReported)
+        .add("timeSeconds", stats.median).add("minValue", globalMin).add("numaPolicy", numaPolicyName(numaPolicy))
+        .addStats(stats);
+    row.print(std::cout, benchConfig);
 
     return 0;
 }
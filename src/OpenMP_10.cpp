@@ -0,0 +1,184 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <algorithm>
+#include <omp.h>
+
+#include "BenchHarness.hpp"
+#include "CounterRng.hpp"
+#include "NumaAllocator.hpp"
+#include "RowMinIndex.hpp"
+#include "SimdMin.hpp"
+
+// Usage: OpenMP_10 <matrixSize> <mode> [batchSize] [numBatches] [hotFraction] [seed]
+// Replays a stream of numBatches batches of batchSize cell updates (defaults
+// 1024 and 64) against the OpenMP_4 matrix and answers the max of row minima
+// after every batch.
+// mode: incremental | rescan
+// incremental: RowMinIndex (RowMinIndex.hpp) - per-row min cache and a
+//              tournament tree, rows rescanned only when their min is raised
+// rescan:      updates written in stream order, then a full parallel scan as
+//              in OpenMP_4's reduction mode
+// hotFraction: share of updates that overwrite the current min of their row
+//              (default 0.1), the case that forces a row rescan; the others
+//              hit uniform random cells. New values are uniform like the matrix.
+// The stream is generated before timing and is the same for both modes.
+// timeSeconds: replay of the whole stream; updatesPerSecond follows from it.
+// batchP50Seconds / batchP99Seconds: time from handing over a batch to the
+// answer, over the batches of the last run. answerChecksum is the sum of the
+// per-batch answers and must match between modes. rescannedRows counts the
+// full row scans of the last run (numBatches * matrixSize for rescan).
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// NUMA_POLICY (env): master | first_touch | interleave | bind (NUMA_BIND_NODE, default 0)
+// HUGE_PAGES (env): off | thp | 2m | 1g, page size of the matrix mapping, see NumaAllocator.hpp
+// SIMD_ISA (env): caps the row-min kernel's ISA (scalar | sse41 | avx2 | avx512),
+//                 see SimdMin.hpp; the isa column names the one used
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <matrixSize> <mode> [batchSize] [numBatches] [hotFraction] [seed]\n";
+        return 1;
+    }
+
+    const std::size_t matrixSize = static_cast<std::size_t>(std::stoull(argv[1]));
+    const std::string mode = argv[2];
+    const std::size_t batchSize = (argc >= 4) ? static_cast<std::size_t>(std::stoull(argv[3])) : 1024;
+    const std::size_t numBatches = (argc >= 5) ? static_cast<std::size_t>(std::stoull(argv[4])) : 64;
+    const double hotFraction = (argc >= 6) ? std::stod(argv[5]) : 0.1;
+    const unsigned int seed = (argc >= 7) ? static_cast<unsigned int>(std::stoul(argv[6])) : 12345u;
+
+    if (matrixSize == 0 || matrixSize > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+        std::cerr << "matrixSize must be > 0 and fit in an int\n";
+        return 2;
+    }
+    if (batchSize == 0 || numBatches == 0) {
+        std::cerr << "batchSize and numBatches must be > 0\n";
+        return 2;
+    }
+    if (hotFraction < 0.0 || hotFraction > 1.0) {
+        std::cerr << "hotFraction must be in [0, 1]\n";
+        return 2;
+    }
+    if (mode != "incremental" && mode != "rescan") {
+        std::cerr << "Unknown mode: " << mode << " (use incremental|rescan)\n";
+        return 3;
+    }
+
+    const NumaPolicy numaPolicy = numaPolicyFromEnv();
+    const int numaBindNode = numaBindNodeFromEnv();
+    const HugePages hugePages = hugePagesFromEnv();
+    NumaVector<double> initialData(NumaAllocator<double>(numaPolicy, numaBindNode, hugePages));
+    NumaVector<double> matrixData(NumaAllocator<double>(numaPolicy, numaBindNode, hugePages));
+    initialData.resize(matrixSize * matrixSize);
+    matrixData.resize(matrixSize * matrixSize);
+    initializeWithPolicy(numaPolicy, matrixSize, [&](std::size_t rowBegin, std::size_t rowEnd) {
+        fillUniformReal(initialData.data() + rowBegin * matrixSize, rowBegin * matrixSize,
+            (rowEnd - rowBegin) * matrixSize, seed, 0, 0.0, 1.0e6);
+        std::fill(matrixData.data() + rowBegin * matrixSize, matrixData.data() + rowEnd * matrixSize, 0.0);
+    });
+
+    const std::size_t totalUpdates = batchSize * numBatches;
+    const int numThreadsReported = omp_get_max_threads();
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    std::vector<double> batchSeconds(numBatches);
+    double answerChecksum = 0.0;
+    std::size_t rescannedRows = 0;
+
+    const SimdLevel simdLevel = selectSimdLevel();
+    const BenchStats stats = withMinKernel<double>(simdLevel, [&](auto kernel) {
+        using Kernel = decltype(kernel);
+
+        // Restores the initial matrix, each thread its own first-touch block.
+        auto resetMatrix = [&]() {
+            initializeWithPolicy(numaPolicy, matrixSize, [&](std::size_t rowBegin, std::size_t rowEnd) {
+                std::copy(initialData.data() + rowBegin * matrixSize, initialData.data() + rowEnd * matrixSize,
+                    matrixData.data() + rowBegin * matrixSize);
+            });
+        };
+
+        // The stream: hot updates need the row's current argmin, so it is
+        // built batch by batch against an index that applies each batch.
+        std::vector<CellUpdate> stream(totalUpdates);
+        {
+            std::vector<int> rows(totalUpdates);
+            std::vector<int> columns(totalUpdates);
+            std::vector<double> values(totalUpdates);
+            std::vector<double> hotDraws(totalUpdates);
+            const int lastIndex = static_cast<int>(matrixSize - 1);
+            parallelFillUniformInt(rows.data(), 0, totalUpdates, seed, 1, 0, lastIndex);
+            parallelFillUniformInt(columns.data(), 0, totalUpdates, seed, 2, 0, lastIndex);
+            parallelFillUniformReal(values.data(), 0, totalUpdates, seed, 3, 0.0, 1.0e6);
+            parallelFillUniformReal(hotDraws.data(), 0, totalUpdates, seed, 4, 0.0, 1.0);
+
+            resetMatrix();
+            RowMinIndex shadow(matrixData.data(), matrixSize);
+            shadow.rebuild<Kernel>();
+            for (std::size_t b = 0; b < numBatches; ++b) {
+                CellUpdate* batch = stream.data() + b * batchSize;
+                for (std::size_t k = 0; k < batchSize; ++k) {
+                    const std::size_t u = b * batchSize + k;
+                    const std::size_t row = static_cast<std::size_t>(rows[u]);
+                    const std::size_t column = (hotDraws[u] < hotFraction) ? shadow.rowArgMin(row) : static_cast<std::size_t>(columns[u]);
+                    batch[k] = CellUpdate { static_cast<std::uint32_t>(row), static_cast<std::uint32_t>(column), values[u] };
+                }
+                shadow.applyBatch<Kernel>(batch, batchSize);
+            }
+        }
+
+        RowMinIndex index(matrixData.data(), matrixSize);
+        return runBenchmark(benchConfig, [&]() {
+            resetMatrix();
+            if (mode == "incremental")
+                index.rebuild<Kernel>();
+            answerChecksum = 0.0;
+            rescannedRows = 0;
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            for (std::size_t b = 0; b < numBatches; ++b) {
+                const CellUpdate* batch = stream.data() + b * batchSize;
+                auto batchStart = std::chrono::high_resolution_clock::now();
+                double answer = std::numeric_limits<double>::lowest();
+
+                if (mode == "incremental") {
+                    index.applyBatch<Kernel>(batch, batchSize);
+                    answer = index.maxOfRowMins();
+                    rescannedRows += index.lastRescannedRows;
+                }
+                else {
+                    for (std::size_t k = 0; k < batchSize; ++k)
+                        matrixData[batch[k].row * matrixSize + batch[k].column] = batch[k].value;
+                    #pragma omp parallel for reduction(max:answer)
+                    for (std::size_t i = 0; i < matrixSize; ++i) {
+                        const double localMin = Kernel::run(matrixData.data() + i * matrixSize, matrixSize);
+                        if (localMin > answer)
+                            answer = localMin;
+                    }
+                    rescannedRows += matrixSize;
+                }
+
+                auto batchEnd = std::chrono::high_resolution_clock::now();
+                batchSeconds[b] = std::chrono::duration<double>(batchEnd - batchStart).count();
+                answerChecksum += answer;
+            }
+            auto endTime = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double>(endTime - startTime).count();
+        });
+    });
+
+    std::sort(batchSeconds.begin(), batchSeconds.end());
+    const double updatesPerSecond = (stats.median > 0.0) ? static_cast<double>(totalUpdates) / stats.median : 0.0;
+
+    BenchRow row;
+    row.add("matrixSize", matrixSize).add("numThreads", numThreadsReported).add("mode", mode)
+        .add("batchSize", batchSize).add("numBatches", numBatches).add("hotFraction", hotFraction)
+        .add("timeSeconds", stats.median).add("updatesPerSecond", updatesPerSecond)
+        .add("batchP50Seconds", benchPercentile(batchSeconds, 0.5)).add("batchP99Seconds", benchPercentile(batchSeconds, 0.99))
+        .add("rescannedRows", rescannedRows).add("answerChecksum", answerChecksum)
+        .add("numaPolicy", numaPolicyName(numaPolicy)).add("isa", simdLevelName(simdLevel)).add("hugePages", hugePagesName(hugePages))
+        .addStats(stats);
+    row.print(std::cout, benchConfig);
+
+    return 0;
+}
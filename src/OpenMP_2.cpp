@@ -1,17 +1,29 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <string>
 #include <algorithm>
+#include <iomanip>
 #include <omp.h>
 
-// Usage: OpenMP_2 <problemSize> <mode> [seed]
-// mode: reduction | no_reduction
+#include "BenchHarness.hpp"
+#include "CounterRng.hpp"
+#include "MappedDataset.hpp"
+#include "NumaAllocator.hpp"
+#include "PairwiseDot.hpp"
+
+// Usage: OpenMP_2 <problemSize> <mode> [seed] [datasetPath]
+// mode: reduction | no_reduction | pairwise | stream
+// pairwise: fixed-size blocks summed with vector FMA accumulators and folded by
+//           a fixed pairwise tree; bit-identical for any OMP_NUM_THREADS
+// stream: pairwise kernel over a dataset written once to datasetPath
+//         (default ../results/OpenMP_2_dataset.bin) and memory-mapped
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// NUMA_POLICY (env): master | first_touch | interleave | bind (NUMA_BIND_NODE, default 0)
 
 int main(int argc, char** argv) {
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <problemSize> <mode> [seed]\n";
+        std::cerr << "Usage: " << argv[0] << " <problemSize> <mode> [seed] [datasetPath]\n";
         return 1;
     }
 
@@ -19,61 +31,118 @@ int main(int argc, char** argv) {
     const std::string mode = argv[2];
     const unsigned int seed = (argc >= 4) ? static_cast<unsigned int>(std::stoul(argv[3])) : 12345u;
 
-    std::vector<double> vectorA(problemSize);
-    std::vector<double> vectorB(problemSize);
-
-    std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    const std::string datasetPath = (argc >= 5) ? argv[4] : "../results/OpenMP_2_dataset.bin";
+    const bool streamMode = (mode == "stream");
 
-    for (std::size_t i = 0; i < problemSize; ++i) {
-        vectorA[i] = distribution(generator);
-        vectorB[i] = distribution(generator);
+    if (mode != "reduction" && mode != "no_reduction" && mode != "pairwise" && !streamMode) {
+        std::cerr << "Unknown mode: " << mode << "\n";
+        return 2;
     }
 
-    // Warm-up
-    {
-        volatile double warmUpSum = 0.0;
-        const std::size_t warmUpLimit = std::min<std::size_t>(problemSize, static_cast<std::size_t>(1000));
-        for (std::size_t i = 0; i < warmUpLimit; ++i) {
-            warmUpSum += vectorA[i] * vectorB[i];
+    const NumaPolicy numaPolicy = numaPolicyFromEnv();
+    const int numaBindNode = numaBindNodeFromEnv();
+    NumaVector<double> vectorA(NumaAllocator<double>(numaPolicy, numaBindNode));
+    NumaVector<double> vectorB(NumaAllocator<double>(numaPolicy, numaBindNode));
+
+    MappedFile mappedFile;
+    const double* mappedA = nullptr;
+    const double* mappedB = nullptr;
+
+    if (streamMode) {
+        const bool datasetReady = ensureDatasetFile<double, 2>(datasetPath, problemSize, seed,
+            [&](std::size_t begin, std::size_t count, const std::array<double*, 2>& chunks) {
+                parallelFillUniformReal(chunks[0], begin, count, seed, 0, 0.0, 1.0);
+                parallelFillUniformReal(chunks[1], begin, count, seed, 1, 0.0, 1.0);
+            });
+        if (!datasetReady || !mappedFile.open(datasetPath)) {
+            std::cerr << "Failed to prepare mapped dataset: " << datasetPath << "\n";
+            return 3;
         }
-        (void)warmUpSum;
+        const DatasetHeader header = makeDatasetHeader(problemSize, sizeof(double), 2, seed);
+        mappedA = reinterpret_cast<const double*>(mappedFile.data() + datasetArrayOffset(header, 0));
+        mappedB = reinterpret_cast<const double*>(mappedFile.data() + datasetArrayOffset(header, 1));
+        mappedFile.adviseSequential();
+    }
+    else {
+        vectorA.resize(problemSize);
+        vectorB.resize(problemSize);
+        initializeWithPolicy(numaPolicy, problemSize, [&](std::size_t begin, std::size_t end) {
+            fillUniformReal(vectorA.data() + begin, begin, end - begin, seed, 0, 0.0, 1.0);
+            fillUniformReal(vectorB.data() + begin, begin, end - begin, seed, 1, 0.0, 1.0);
+        });
     }
 
     const int numThreads = omp_get_max_threads();
+    const DotBlockKernel dotKernel = selectDotBlockKernel(selectSimdLevel());
+    const std::string modeReported = (mode == "pairwise" || streamMode) ? mode + "_" + dotBlockKernelName(dotKernel) : mode;
+    const std::size_t numBlocks = (problemSize + dotBlockSize - 1) / dotBlockSize;
+    std::vector<double> blockSums((mode == "pairwise" || streamMode) ? numBlocks : 0);
+    const BenchConfig benchConfig = benchConfigFromEnv();
     double globalSum = 0.0;
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+    const BenchStats stats = runBenchmark(benchConfig, [&]() {
+        globalSum = 0.0;
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-    if (mode == "reduction") {
-        #pragma omp parallel for reduction(+:globalSum)
-        for (std::size_t i = 0; i < problemSize; ++i) {
-            globalSum += vectorA[i] * vectorB[i];
-        }
-    }
-    else if (mode == "no_reduction") {
-        #pragma omp parallel
-        {
-            double localSum = 0.0;
-            #pragma omp for
+        if (mode == "reduction") {
+            #pragma omp parallel for reduction(+:globalSum)
             for (std::size_t i = 0; i < problemSize; ++i) {
-                localSum += vectorA[i] * vectorB[i];
+                globalSum += vectorA[i] * vectorB[i];
             }
+        }
+        else if (mode == "no_reduction") {
+            #pragma omp parallel
+            {
+                double localSum = 0.0;
+                #pragma omp for
+                for (std::size_t i = 0; i < problemSize; ++i) {
+                    localSum += vectorA[i] * vectorB[i];
+                }
 
-            #pragma omp critical
+                #pragma omp critical
+                {
+                    globalSum += localSum;
+                }
+            }
+        }
+        else if (mode == "pairwise") {
+            #pragma omp parallel for schedule(static)
+            for (std::size_t block = 0; block < numBlocks; ++block) {
+                const std::size_t begin = block * dotBlockSize;
+                const std::size_t count = std::min(dotBlockSize, problemSize - begin);
+                blockSums[block] = dotKernel(vectorA.data() + begin, vectorB.data() + begin, count);
+            }
+            globalSum = pairwiseSum(blockSums.data(), numBlocks);
+        }
+        else if (streamMode) {
+            // Same block partition and pairwise tree as "pairwise", so the result
+            // matches it bit for bit; threads own page-aligned runs of whole blocks.
+            const std::size_t granularity = std::max(dotBlockSize, datasetAlignment / sizeof(double));
+            #pragma omp parallel
             {
-                globalSum += localSum;
+                std::size_t begin = 0;
+                std::size_t end = 0;
+                alignedThreadRange(problemSize, granularity, static_cast<std::size_t>(omp_get_thread_num()),
+                    static_cast<std::size_t>(omp_get_num_threads()), begin, end);
+
+                streamMappedWindows<double, 2>({ mappedA, mappedB }, begin, end, [&](std::size_t windowBegin, std::size_t windowEnd) {
+                    for (std::size_t blockBegin = windowBegin; blockBegin < windowEnd; blockBegin += dotBlockSize) {
+                        const std::size_t count = std::min(dotBlockSize, windowEnd - blockBegin);
+                        blockSums[blockBegin / dotBlockSize] = dotKernel(mappedA + blockBegin, mappedB + blockBegin, count);
+                    }
+                });
             }
+            globalSum = pairwiseSum(blockSums.data(), numBlocks);
         }
-    }
-    else {
-        std::cerr << "Unknown mode: " << mode << "\n";
-        return 2;
-    }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double timeSeconds = std::chrono::duration<double>(endTime - startTime).count();
+        auto endTime = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(endTime - startTime).count();
+    });
 
-    std::cout << problemSize << "," << numThreads << "," << mode << "," << timeSeconds << "," << globalSum << std::endl;
+    BenchRow row;
+    row.add("problemSize", problemSize).add("numThreads", numThreads).add("mode", modeReported)
+        .add("timeSeconds", stats.median).add("scalarProduct", globalSum, 17).add("numaPolicy", numaPolicyName(numaPolicy))
+        .addStats(stats);
+    row.print(std::cout, benchConfig);
     return 0;
 }
@@ -5,87 +5,279 @@
 #include <omp.h>
 #include <cstdint>
 #include <algorithm>
+#include <iomanip>
 
-// Usage: OpenMP_3 <numIntervals> <mode> <a> <b>
-// mode: reduction | no_reduction
+#include "BenchHarness.hpp"
+#include "SimdMath.hpp"
 
-// The simplest function. It can be replaced/expanded if necessary.
-static inline double integrandFunction(double x) {
-    return std::sin(x);
-}
+// Usage: OpenMP_3 <numIntervals|tolerance> <mode> <a> <b> [integrand]
+// mode: reduction | no_reduction | simd | adaptive
+// simd: blocks of simdBlockSize points split across threads, each block an
+//       "omp simd" reduction over the integrand's branch-free evaluation
+//       (SimdMath.hpp instead of libm)
+// adaptive: G7-K15 with recursive bisection as OpenMP tasks; the first argument
+//           is the absolute error tolerance instead of numIntervals
+// integrand: sin | peak | cusp | damped (default sin)
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
 
-int main(int argc, char** argv) {
-    if (argc < 5) {
-        std::cerr << "Usage: " << argv[0] << " <numIntervals> <mode> <a> <b>\n";
-        return 1;
+// Integrands are stateless functors, so every mode is instantiated for each
+// one at compile time. operator() uses libm; simd() is the same function in a
+// form the vectorizer accepts.
+struct SinIntegrand {
+    double operator()(double x) const {
+        return std::sin(x);
     }
 
-    const std::int64_t numIntervals = static_cast<std::int64_t>(std::stoll(argv[1]));
-    const std::string mode = argv[2];
-    const double lowerBound = std::stod(argv[3]);
-    const double upperBound = std::stod(argv[4]);
+    double simd(double x) const {
+        return simdSin(x);
+    }
+};
 
-    if (numIntervals <= 0) {
-        std::cerr << "numIntervals must be > 0\n";
-        return 2;
+// Narrow Lorentzian peak at x = 1 (width 1e-3).
+struct PeakIntegrand {
+    double operator()(double x) const {
+        const double d = x - 1.0;
+        return 1.0 / (1.0e-6 + d * d);
     }
-    if (upperBound <= lowerBound) {
-        std::cerr << "upperBound must be > lowerBound\n";
-        return 3;
+
+    double simd(double x) const {
+        return (*this)(x);
     }
+};
 
-    // Warm-up
-    {
-        double warmUpSum = 0.0;
-        double warmUpH = (upperBound - lowerBound) / static_cast<double>(numIntervals);
-        const int warmUpSteps = static_cast<int>(std::min<std::int64_t>(numIntervals, static_cast<std::int64_t>(1000)));
-        for (int i = 0; i < warmUpSteps; ++i) {
-            double x = lowerBound + static_cast<double>(i) * warmUpH;
-            warmUpSum += integrandFunction(x);
-        }
-        (void)warmUpSum;
+// sqrt|x - 1|: continuous with an infinite derivative at x = 1. sqrt is a
+// single instruction, but it only vectorizes with -fno-math-errno.
+struct CuspIntegrand {
+    double operator()(double x) const {
+        return std::sqrt(std::abs(x - 1.0));
+    }
+
+    double simd(double x) const {
+        return (*this)(x);
+    }
+};
+
+// exp(-x) * cos(10x): a decaying oscillation that needs two transcendentals.
+struct DampedIntegrand {
+    double operator()(double x) const {
+        return std::exp(-x) * std::cos(10.0 * x);
+    }
+
+    double simd(double x) const {
+        return simdExp(-x) * simdCos(10.0 * x);
+    }
+};
+
+static const std::int64_t simdBlockSize = 4096;
+
+struct QuadratureEstimate {
+    double value;
+    double error;
+};
+
+struct AdaptiveResult {
+    double value;
+    std::int64_t evaluations;
+};
+
+// Kronrod 15-point rule with the embedded Gauss 7-point rule (QUADPACK qk15).
+template <typename Integrand>
+static QuadratureEstimate gaussKronrod15(const Integrand& integrand, double a, double b) {
+    static const double kronrodNodes[8] = {
+        0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+        0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+        0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+        0.207784955007898467600689403773245, 0.000000000000000000000000000000000
+    };
+    static const double kronrodWeights[8] = {
+        0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+        0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+        0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+        0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+    };
+    static const double gaussWeights[4] = {
+        0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+        0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+    };
+
+    const double center = 0.5 * (a + b);
+    const double halfLength = 0.5 * (b - a);
+
+    const double centerValue = integrand(center);
+    double kronrodSum = centerValue * kronrodWeights[7];
+    double gaussSum = centerValue * gaussWeights[3];
+    for (int k = 0; k < 7; ++k) {
+        const double offset = halfLength * kronrodNodes[k];
+        const double pairSum = integrand(center - offset) + integrand(center + offset);
+        kronrodSum += kronrodWeights[k] * pairSum;
+        if (k % 2 == 1)
+            gaussSum += gaussWeights[k / 2] * pairSum;
     }
 
+    return QuadratureEstimate { kronrodSum * halfLength, std::abs((kronrodSum - gaussSum) * halfLength) };
+}
+
+static const int adaptiveMaxDepth = 60;
+static const int adaptiveTaskDepth = 24;
+
+// Accepts [a, b] once its error estimate is within its share of the tolerance
+// (the share halves with every bisection); otherwise both halves are refined,
+// the left one as a task. Partial sums are combined in tree order, so the
+// value does not depend on the thread count.
+template <typename Integrand>
+static AdaptiveResult integrateAdaptive(const Integrand& integrand, double a, double b, double tolerance,
+    const QuadratureEstimate& estimate, int depth) {
+    const double mid = 0.5 * (a + b);
+    if (estimate.error <= tolerance || depth >= adaptiveMaxDepth || mid <= a || mid >= b)
+        return AdaptiveResult { estimate.value, 0 };
+
+    AdaptiveResult leftResult {};
+    AdaptiveResult rightResult {};
+    const QuadratureEstimate leftEstimate = gaussKronrod15(integrand, a, mid);
+    const QuadratureEstimate rightEstimate = gaussKronrod15(integrand, mid, b);
+
+    #pragma omp task default(none) shared(integrand, leftResult, leftEstimate) firstprivate(a, mid, tolerance, depth) if(depth < adaptiveTaskDepth)
+    leftResult = integrateAdaptive(integrand, a, mid, 0.5 * tolerance, leftEstimate, depth + 1);
+
+    rightResult = integrateAdaptive(integrand, mid, b, 0.5 * tolerance, rightEstimate, depth + 1);
+
+    #pragma omp taskwait
+
+    return AdaptiveResult { leftResult.value + rightResult.value, 30 + leftResult.evaluations + rightResult.evaluations };
+}
+
+template <typename Integrand>
+static int runIntegration(const Integrand& integrand, const std::string& mode, const std::string& integrandName,
+    std::int64_t numIntervals, double tolerance, double lowerBound, double upperBound) {
     const int numThreadsReported = omp_get_max_threads();
-    double integralResult = 0.0;
     const double stepSize = (upperBound - lowerBound) / static_cast<double>(numIntervals);
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    double integralResult = 0.0;
+    std::int64_t evaluations = numIntervals;
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+    const BenchStats stats = runBenchmark(benchConfig, [&]() {
+        integralResult = 0.0;
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-    if (mode == "reduction") {
-        #pragma omp parallel for reduction(+:integralResult)
-        for (std::int64_t i = 0; i < numIntervals; ++i) {
-            double x = lowerBound + static_cast<double>(i) * stepSize;
-            integralResult += integrandFunction(x);
-        }
-        integralResult *= stepSize;
-    }
-    else if (mode == "no_reduction") {
-        #pragma omp parallel
-        {
-            double localSum = 0.0;
-            #pragma omp for
+        if (mode == "reduction") {
+            #pragma omp parallel for reduction(+:integralResult)
             for (std::int64_t i = 0; i < numIntervals; ++i) {
                 double x = lowerBound + static_cast<double>(i) * stepSize;
-                localSum += integrandFunction(x);
+                integralResult += integrand(x);
             }
+            integralResult *= stepSize;
+        }
+        else if (mode == "simd") {
+            // Blocks keep the vector loop on an int index: int64 -> double
+            // conversion has no vector instruction below AVX-512DQ. blockBase + j
+            // is exact, so every x is bit-identical to the reduction mode.
+            const std::int64_t blockCount = (numIntervals + simdBlockSize - 1) / simdBlockSize;
+            #pragma omp parallel for reduction(+:integralResult)
+            for (std::int64_t block = 0; block < blockCount; ++block) {
+                const std::int64_t blockBegin = block * simdBlockSize;
+                const double blockBase = static_cast<double>(blockBegin);
+                const int blockLength = static_cast<int>(std::min(simdBlockSize, numIntervals - blockBegin));
+                double blockSum = 0.0;
+#if defined(PT_HAS_OMP_SIMD)
+                #pragma omp simd reduction(+:blockSum)
+#endif
+                for (int j = 0; j < blockLength; ++j) {
+                    const double x = lowerBound + (blockBase + static_cast<double>(j)) * stepSize;
+                    blockSum += integrand.simd(x);
+                }
+                integralResult += blockSum;
+            }
+            integralResult *= stepSize;
+        }
+        else if (mode == "no_reduction") {
+            #pragma omp parallel
+            {
+                double localSum = 0.0;
+                #pragma omp for
+                for (std::int64_t i = 0; i < numIntervals; ++i) {
+                    double x = lowerBound + static_cast<double>(i) * stepSize;
+                    localSum += integrand(x);
+                }
 
-            #pragma omp critical
+                #pragma omp critical
+                {
+                    integralResult += localSum;
+                }
+            }
+            integralResult *= stepSize;
+        }
+        else if (mode == "adaptive") {
+            AdaptiveResult adaptiveResult {};
+            #pragma omp parallel
             {
-                integralResult += localSum;
+                #pragma omp single
+                {
+                    const QuadratureEstimate wholeEstimate = gaussKronrod15(integrand, lowerBound, upperBound);
+                    adaptiveResult = integrateAdaptive(integrand, lowerBound, upperBound, tolerance, wholeEstimate, 0);
+                    adaptiveResult.evaluations += 15;
+                }
             }
+            integralResult = adaptiveResult.value;
+            evaluations = adaptiveResult.evaluations;
         }
-        integralResult *= stepSize;
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(endTime - startTime).count();
+    });
+
+    BenchRow row;
+    if (mode == "adaptive")
+        row.add("numIntervals", tolerance);
+    else
+        row.add("numIntervals", numIntervals);
+    row.add("numThreads", numThreadsReported).add("mode", mode).add("integrand", integrandName)
+        .add("timeSeconds", stats.median).add("evaluations", evaluations).add("integralValue", integralResult, 17)
+        .addStats(stats);
+    row.print(std::cout, benchConfig);
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <numIntervals|tolerance> <mode> <a> <b> [integrand]\n";
+        return 1;
+    }
+
+    const std::string mode = argv[2];
+    const bool adaptiveMode = (mode == "adaptive");
+    const std::int64_t numIntervals = adaptiveMode ? 1 : static_cast<std::int64_t>(std::stoll(argv[1]));
+    const double tolerance = adaptiveMode ? std::stod(argv[1]) : 0.0;
+    const double lowerBound = std::stod(argv[3]);
+    const double upperBound = std::stod(argv[4]);
+    const std::string integrandName = (argc >= 6) ? argv[5] : "sin";
+
+    if (numIntervals <= 0) {
+        std::cerr << "numIntervals must be > 0\n";
+        return 2;
+    }
+    if (adaptiveMode && !(tolerance > 0.0)) {
+        std::cerr << "tolerance must be > 0\n";
+        return 2;
     }
-    else {
+    if (upperBound <= lowerBound) {
+        std::cerr << "upperBound must be > lowerBound\n";
+        return 3;
+    }
+    if (mode != "reduction" && mode != "no_reduction" && mode != "simd" && !adaptiveMode) {
         std::cerr << "Unknown mode: " << mode << "\n";
         return 4;
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double timeSeconds = std::chrono::duration<double>(endTime - startTime).count();
+    if (integrandName == "sin")
+        return runIntegration(SinIntegrand {}, mode, integrandName, numIntervals, tolerance, lowerBound, upperBound);
+    if (integrandName == "peak")
+        return runIntegration(PeakIntegrand {}, mode, integrandName, numIntervals, tolerance, lowerBound, upperBound);
+    if (integrandName == "cusp")
+        return runIntegration(CuspIntegrand {}, mode, integrandName, numIntervals, tolerance, lowerBound, upperBound);
+    if (integrandName == "damped")
+        return runIntegration(DampedIntegrand {}, mode, integrandName, numIntervals, tolerance, lowerBound, upperBound);
 
-    std::cout << numIntervals << "," << numThreadsReported << "," << mode << "," << timeSeconds << "," << integralResult << std::endl;
-
-    return 0;
+    std::cerr << "Unknown integrand: " << integrandName << " (use sin|peak|cusp|damped)\n";
+    return 5;
 }
@@ -1,14 +1,30 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <limits>
 #include <string>
 #include <algorithm>
 #include <omp.h>
 
+#include "BenchHarness.hpp"
+#include "CounterRng.hpp"
+#include "NumaAllocator.hpp"
+#include "PrunedRowMins.hpp"
+#include "SimdMin.hpp"
+
 // Usage: OpenMP_4 <matrixSize> <mode> [seed]
-// mode: reduction | no_reduction
+// mode: reduction | no_reduction | pruned | pruned_sampled
+// pruned: branch and bound, a row is dropped once its running min falls below
+//         the best row min so far (see PrunedRowMins.hpp)
+// pruned_sampled: pruned, with rows ordered by the min of a few sampled elements
+// elementsTouched: matrix elements read by the last run (samples included)
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// NUMA_POLICY (env): master | first_touch | interleave | bind (NUMA_BIND_NODE, default 0)
+// HUGE_PAGES (env): off | thp | 2m | 1g, page size of the matrix mapping, see
+//                   NumaAllocator.hpp; pageKiB and hugeFraction report what the
+//                   kernel backed it with after initialisation
+// SIMD_ISA (env): caps the row-min kernel's ISA (scalar | sse41 | avx2 | avx512),
+//                 see SimdMin.hpp; the isa column names the one used
 
 int main(int argc, char** argv) {
     if (argc < 3) {
@@ -24,83 +40,80 @@ int main(int argc, char** argv) {
         std::cerr << "matrixSize must be > 0\n";
         return 2;
     }
+    if (mode != "reduction" && mode != "no_reduction" && mode != "pruned" && mode != "pruned_sampled") {
+        std::cerr << "Unknown mode: " << mode << "\n";
+        return 3;
+    }
 
-    std::vector<double> matrixData;
+    const NumaPolicy numaPolicy = numaPolicyFromEnv();
+    const int numaBindNode = numaBindNodeFromEnv();
+    const HugePages hugePages = hugePagesFromEnv();
+    NumaVector<double> matrixData(NumaAllocator<double>(numaPolicy, numaBindNode, hugePages));
     matrixData.resize(matrixSize * matrixSize);
 
-    std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-    std::uniform_real_distribution<double> distribution(0.0, 1.0e6);
-
-    for (std::size_t i = 0; i < matrixSize; ++i) {
-        const std::size_t rowOffset = i * matrixSize;
-        for (std::size_t j = 0; j < matrixSize; ++j) {
-            matrixData[rowOffset + j] = distribution(generator);
-        }
-    }
-
-    // Warm-up
-    {
-        volatile double warmUpSum = 0.0;
-        const std::size_t warmSteps = std::min<std::size_t>(matrixSize, static_cast<std::size_t>(10));
-        const std::size_t warmCols = std::min<std::size_t>(matrixSize, static_cast<std::size_t>(10));
-        for (std::size_t i = 0; i < warmSteps; ++i) {
-            const std::size_t rowOffset = i * matrixSize;
-            for (std::size_t j = 0; j < warmCols; ++j) {
-                warmUpSum += matrixData[rowOffset + j];
-            }
-        }
-        (void)warmUpSum;
-    }
+    initializeWithPolicy(numaPolicy, matrixSize, [&](std::size_t rowBegin, std::size_t rowEnd) {
+        fillUniformReal(matrixData.data() + rowBegin * matrixSize, rowBegin * matrixSize,
+            (rowEnd - rowBegin) * matrixSize, seed, 0, 0.0, 1.0e6);
+    });
+    const PageBacking backing = pageBacking(matrixData.data());
 
     const int numThreadsReported = omp_get_max_threads();
+    const BenchConfig benchConfig = benchConfigFromEnv();
     double globalMaxOfRowMins = std::numeric_limits<double>::lowest();
+    std::size_t elementsTouched = 0;
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+    const SimdLevel simdLevel = selectSimdLevel();
+    const BenchStats stats = withMinKernel<double>(simdLevel, [&](auto kernel) {
+        using Kernel = decltype(kernel);
+        return runBenchmark(benchConfig, [&]() {
+            globalMaxOfRowMins = std::numeric_limits<double>::lowest();
+            elementsTouched = matrixSize * matrixSize;
+            auto startTime = std::chrono::high_resolution_clock::now();
 
-    if (mode == "reduction") {
-        #pragma omp parallel for reduction(max:globalMaxOfRowMins)
-        for (std::size_t i = 0; i < matrixSize; ++i) {
-            double localMin = std::numeric_limits<double>::max();
-            const std::size_t rowOffset = i * matrixSize;
-            for (std::size_t j = 0; j < matrixSize; ++j) {
-                double val = matrixData[rowOffset + j];
-                if (val < localMin)
-                    localMin = val;
-            }
-            if (localMin > globalMaxOfRowMins)
-                globalMaxOfRowMins = localMin;
-        }
-    }
-    else if (mode == "no_reduction") {
-        #pragma omp parallel
-        {
-            #pragma omp for
-            for (std::size_t i = 0; i < matrixSize; ++i) {
-                double localMin = std::numeric_limits<double>::max();
-                const std::size_t rowOffset = i * matrixSize;
-                for (std::size_t j = 0; j < matrixSize; ++j) {
-                    double val = matrixData[rowOffset + j];
-                    if (val < localMin)
-                        localMin = val;
-                }
-
-                #pragma omp critical
-                {
+            if (mode == "reduction") {
+                #pragma omp parallel for reduction(max:globalMaxOfRowMins)
+                for (std::size_t i = 0; i < matrixSize; ++i) {
+                    const double localMin = Kernel::run(matrixData.data() + i * matrixSize, matrixSize);
                     if (localMin > globalMaxOfRowMins)
                         globalMaxOfRowMins = localMin;
                 }
             }
-        }
-    }
-    else {
-        std::cerr << "Unknown mode: " << mode << "\n";
-        return 3;
-    }
+            else if (mode == "no_reduction") {
+                #pragma omp parallel
+                {
+                    #pragma omp for
+                    for (std::size_t i = 0; i < matrixSize; ++i) {
+                        const double localMin = Kernel::run(matrixData.data() + i * matrixSize, matrixSize);
+
+                        #pragma omp critical
+                        {
+                            if (localMin > globalMaxOfRowMins)
+                                globalMaxOfRowMins = localMin;
+                        }
+                    }
+                }
+            }
+            else if (mode == "pruned" || mode == "pruned_sampled") {
+                elementsTouched = 0;
+                std::vector<std::size_t> rowOrder;
+                if (mode == "pruned_sampled")
+                    rowOrder = sampledRowOrder(matrixData.data(), matrixSize, matrixSize, elementsTouched);
+                globalMaxOfRowMins = prunedMaxOfRowMins<Kernel>(matrixData.data(), matrixSize, matrixSize,
+                    rowOrder.empty() ? nullptr : &rowOrder, elementsTouched);
+            }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double timeSeconds = std::chrono::duration<double>(endTime - startTime).count();
+            auto endTime = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double>(endTime - startTime).count();
+        });
+    });
 
-    std::cout << matrixSize << "," << numThreadsReported << "," << mode << "," << timeSeconds << "," << globalMaxOfRowMins << std::endl;
+    BenchRow row;
+    row.add("matrixSize", matrixSize).add("numThreads", numThreadsReported).add("mode", mode)
+        .add("timeSeconds", stats.median).add("maxOfRowMins", globalMaxOfRowMins).add("numaPolicy", numaPolicyName(numaPolicy))
+        .add("isa", simdLevelName(simdLevel)).add("elementsTouched", elementsTouched)
+        .add("hugePages", hugePagesName(hugePages)).add("pageKiB", backing.pageKiB).add("hugeFraction", backing.hugeFraction)
+        .addStats(stats);
+    row.print(std::cout, benchConfig);
 
     return 0;
 }
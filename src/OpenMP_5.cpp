@@ -1,28 +1,231 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <limits>
 #include <string>
 #include <algorithm>
 #include <omp.h>
 #include <cstdint>
+#include <sstream>
+
+#include "BenchHarness.hpp"
+#include "MatrixStorage.hpp"
+#include "NumaAllocator.hpp"
+#include "Partition.hpp"
+#include "ScheduleTuner.hpp"
+#include "SimdMin.hpp"
 
 // Usage:
-// OpenMP_5 <matrixSize> <mode> <matrixType> <schedule> <chunk> [bandwidth] [seed]
+// OpenMP_5 <matrixSize> <mode> <matrixType> <schedule> <chunk> [bandwidth] [seed] [storage]
 // matrixType: banded | triangular | full
-// schedule: static | dynamic | guided
+// schedule: static | dynamic | guided | balanced | tuned
+// balanced: one contiguous block of rows per thread, cut so that every block
+//           holds the same number of stored values (chunk is ignored)
+// tuned: schedule kind and chunk picked online on the first TUNE_FRACTION of
+//        the rows and cached on disk per loop signature, see ScheduleTuner.hpp
+//        (chunk is ignored); tunedSchedule, tuneSource (explored | cache |
+//        fallback, when the budget is too small to explore) and
+//        exploreSeconds report the pick
 // chunk: integer chunk size for scheduling (used with omp_set_schedule)
 // bandwidth: for banded matrix (half-bandwidth); optional, default = 5
 // mode: reduction | no_reduction
+// storage: compact (default): band storage for banded, row-packed for triangular,
+//          dense for full | dense: n x n array, scanning only the in-shape
+//          part of each row (as the original loops did) | padded: n x n array,
+//          scanning every row over all n cells including the infinity padding
+//          | csr: compressed sparse rows, see MatrixStorage.hpp; the storage
+//          column names the format used
+// SIMD_ISA (env): caps the row-min kernel's ISA (scalar | sse41 | avx2 | avx512),
+//                 see SimdMin.hpp; the isa column names the one used
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// NUMA_POLICY (env): master | first_touch | interleave | bind (NUMA_BIND_NODE, default 0)
+// HUGE_PAGES (env): off | thp | 2m | 1g, page size of the matrix storage, see
+//                   NumaAllocator.hpp; pageKiB and hugeFraction report what the
+//                   kernel backed it with after initialisation
 //
 // Example:
-// OpenMP_5 2000 reduction banded dynamic 8 10 12345
+// OpenMP_5 2000 reduction banded dynamic 8 10 12345 compact
+
+// Runs the timed row-min loops over one storage format and prints the row. The
+// loops are instantiated per storage format and kernel ISA, so the only choice
+// left inside them is the schedule. Every thread times its own share of the
+// loop (up to the closing barrier); imbalance is the slowest thread's time over
+// the mean, and threadSeconds lists each thread's mean over the measured runs.
+// Both cover the team that actually ran, which OMP_DYNAMIC or a thread limit
+// can make smaller than numThreads.
+template <typename Storage>
+static int runRowMins(const Storage& matrix, const std::string& storageName, const std::string& mode,
+    const std::string& matrixType, std::size_t matrixSize, std::size_t bandwidth,
+    const std::string& scheduleType, int chunkSize, NumaPolicy numaPolicy, HugePages hugePages, SimdLevel simdLevel) {
+    const int numThreadsReported = omp_get_max_threads();
+    const std::size_t maxTeamSize = static_cast<std::size_t>(numThreadsReported);
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    const PageBacking backing = pageBacking(matrix.row(0).begin());
+    double globalMaxOfRowMins = std::numeric_limits<double>::lowest();
+
+    // balanced: one contiguous block of rows per thread with equal stored
+    // values, cut from the prefix sum of row lengths for the size of the team
+    // that actually runs the region, once per team size. tuned ranks its
+    // candidates by stored values per second from the same prefix sum.
+    const bool balanced = (scheduleType == "balanced");
+    const bool tuned = (scheduleType == "tuned");
+    std::vector<std::size_t> workPrefix;
+    std::vector<std::vector<std::size_t>> balancedBoundsByTeam(maxTeamSize + 1);
+    if (balanced || tuned) {
+        workPrefix.assign(matrixSize + 1, 0);
+        for (std::size_t i = 0; i < matrixSize; ++i)
+            workPrefix[i + 1] = workPrefix[i] + matrix.row(i).size();
+    }
+    auto prepareBalancedBounds = [&](std::size_t team) {
+        if (balancedBoundsByTeam[team].empty())
+            balancedBoundsByTeam[team] = balancedBlockBounds(workPrefix, team);
+    };
+
+    PerThreadSeconds perThreadSeconds;
+
+    // tuned: the runtime schedule is picked by ScheduleTuner, keyed by
+    // everything that changes the per-row work.
+    std::ostringstream signature;
+    signature << "OpenMP_5 n=" << matrixSize << " matrixType=" << matrixType << " bandwidth=" << bandwidth
+        << " storage=" << storageName << " mode=" << mode << " isa=" << simdLevelName(simdLevel) << " threads=" << numThreadsReported;
+    ScheduleTuner tuner(signature.str());
+    double exploreSeconds = 0.0;
+
+    const BenchStats stats = withMinKernel<double>(simdLevel, [&](auto kernel) {
+        using Kernel = decltype(kernel);
+        return runBenchmark(benchConfig, [&]() {
+            globalMaxOfRowMins = std::numeric_limits<double>::lowest();
+            std::vector<double> threadSeconds(maxTeamSize, 0.0);
+            std::size_t runTeamSize = 0;
+            auto startTime = std::chrono::high_resolution_clock::now();
+
+            // Rows [rowBegin, rowEnd) as one parallel region; the balanced
+            // schedule always covers all rows.
+            auto runRows = [&](std::size_t rowBegin, std::size_t rowEnd) {
+                double sliceMax = std::numeric_limits<double>::lowest();
+                if (mode == "reduction") {
+                    #pragma omp parallel reduction(max:sliceMax) num_threads(numThreadsReported)
+                    {
+                        const std::size_t threadId = static_cast<std::size_t>(omp_get_thread_num());
+                        const std::size_t team = static_cast<std::size_t>(omp_get_num_threads());
+                        if (threadId == 0)
+                            runTeamSize = std::max(runTeamSize, team);
+                        if (balanced) {
+                            #pragma omp single
+                            prepareBalancedBounds(team);
+                        }
+                        const double threadStart = omp_get_wtime();
+                        if (balanced) {
+                            const std::vector<std::size_t>& bounds = balancedBoundsByTeam[team];
+                            for (std::size_t i = bounds[threadId]; i < bounds[threadId + 1]; ++i) {
+                                const RowView rowView = matrix.row(i);
+                                const double localMin = Kernel::run(rowView.begin(), rowView.size());
+                                if (localMin > sliceMax)
+                                    sliceMax = localMin;
+                            }
+                        }
+                        else {
+                            #pragma omp for schedule(runtime) nowait
+                            for (std::size_t i = rowBegin; i < rowEnd; ++i) {
+                                const RowView rowView = matrix.row(i);
+                                const double localMin = Kernel::run(rowView.begin(), rowView.size());
+                                if (localMin > sliceMax)
+                                    sliceMax = localMin;
+                            }
+                        }
+                        threadSeconds[threadId] += omp_get_wtime() - threadStart;
+                    }
+                }
+                else if (mode == "no_reduction") {
+                    #pragma omp parallel num_threads(numThreadsReported)
+                    {
+                        const std::size_t threadId = static_cast<std::size_t>(omp_get_thread_num());
+                        const std::size_t team = static_cast<std::size_t>(omp_get_num_threads());
+                        if (threadId == 0)
+                            runTeamSize = std::max(runTeamSize, team);
+                        if (balanced) {
+                            #pragma omp single
+                            prepareBalancedBounds(team);
+                        }
+                        const double threadStart = omp_get_wtime();
+                        if (balanced) {
+                            const std::vector<std::size_t>& bounds = balancedBoundsByTeam[team];
+                            for (std::size_t i = bounds[threadId]; i < bounds[threadId + 1]; ++i) {
+                                const RowView rowView = matrix.row(i);
+                                const double localMin = Kernel::run(rowView.begin(), rowView.size());
+
+                                #pragma omp critical
+                                {
+                                    if (localMin > sliceMax)
+                                        sliceMax = localMin;
+                                }
+                            }
+                        }
+                        else {
+                            #pragma omp for schedule(runtime) nowait
+                            for (std::size_t i = rowBegin; i < rowEnd; ++i) {
+                                const RowView rowView = matrix.row(i);
+                                const double localMin = Kernel::run(rowView.begin(), rowView.size());
+
+                                #pragma omp critical
+                                {
+                                    if (localMin > sliceMax)
+                                        sliceMax = localMin;
+                                }
+                            }
+                        }
+                        threadSeconds[threadId] += omp_get_wtime() - threadStart;
+                    }
+                }
+                globalMaxOfRowMins = std::max(globalMaxOfRowMins, sliceMax);
+            };
+
+            if (tuned) {
+                tuner.run(matrixSize, runRows, &workPrefix);
+                exploreSeconds = std::max(exploreSeconds, tuner.exploreSeconds);
+            }
+            else {
+                runRows(0, matrixSize);
+            }
+
+            auto endTime = std::chrono::high_resolution_clock::now();
+            threadSeconds.resize(runTeamSize);
+            perThreadSeconds.record(threadSeconds);
+            return std::chrono::duration<double>(endTime - startTime).count();
+        }, &perThreadSeconds);
+    });
+
+    BenchRow row;
+    row.add("matrixSize", matrixSize)
+        .add("numThreads", numThreadsReported)
+        .add("mode", mode)
+        .add("matrixType", matrixType)
+        .add("bandwidth", bandwidth)
+        .add("schedule", scheduleType)
+        .add("chunk", chunkSize)
+        .add("timeSeconds", stats.median)
+        .add("maxOfRowMins", globalMaxOfRowMins)
+        .add("numaPolicy", numaPolicyName(numaPolicy))
+        .add("storage", storageName)
+        .add("isa", simdLevelName(simdLevel))
+        .add("imbalance", perThreadSeconds.imbalance())
+        .add("threadSeconds", perThreadSeconds.joined())
+        .add("hugePages", hugePagesName(hugePages))
+        .add("pageKiB", backing.pageKiB)
+        .add("hugeFraction", backing.hugeFraction)
+        .add("tunedSchedule", tuned ? tuner.winnerName() : std::string("none"))
+        .add("tuneSource", tuned ? tuner.sourceName() : "none")
+        .add("exploreSeconds", exploreSeconds)
+        .addStats(stats);
+    row.print(std::cout, benchConfig);
+
+    return 0;
+}
 
 int main(int argc, char** argv) {
     if (argc < 6) {
         std::cerr << "Usage: " << argv[0]
-            << " <matrixSize> <mode> <matrixType> <schedule> <chunk> [bandwidth] [seed]\n";
+            << " <matrixSize> <mode> <matrixType> <schedule> <chunk> [bandwidth] [seed] [storage]\n";
         return 1;
     }
 
@@ -33,6 +236,7 @@ int main(int argc, char** argv) {
     const int chunkSize = std::stoi(argv[5]);
     std::size_t bandwidth = (argc >= 7) ? static_cast<std::size_t>(std::max(0, std::stoi(argv[6]))) : static_cast<std::size_t>(5);
     const unsigned int seed = (argc >= 8) ? static_cast<unsigned int>(std::stoul(argv[7])) : 12345u;
+    const std::string storageType = (argc >= 9) ? argv[8] : "compact"; // compact | dense | padded | csr
 
     if (matrixSize == 0) {
         std::cerr << "matrixSize must be > 0\n";
@@ -42,6 +246,18 @@ int main(int argc, char** argv) {
         std::cerr << "chunk must be > 0\n";
         return 3;
     }
+    if (mode != "reduction" && mode != "no_reduction") {
+        std::cerr << "Unknown mode: " << mode << " (use reduction|no_reduction)\n";
+        return 6;
+    }
+    if (matrixType != "banded" && matrixType != "triangular" && matrixType != "full") {
+        std::cerr << "Unknown matrixType: " << matrixType << " (use banded|triangular|full)\n";
+        return 5;
+    }
+    if (storageType != "compact" && storageType != "dense" && storageType != "padded" && storageType != "csr") {
+        std::cerr << "Unknown storage: " << storageType << " (use compact|dense|padded|csr)\n";
+        return 7;
+    }
     if (bandwidth > (matrixSize == 0 ? 0 : matrixSize - 1))
         bandwidth = (matrixSize == 0) ? 0 : matrixSize - 1;
 
@@ -55,166 +271,38 @@ int main(int argc, char** argv) {
     else if (scheduleType == "guided") {
         ompScheduleKind = omp_sched_guided;
     }
-    else {
-        std::cerr << "Unknown schedule: " << scheduleType << " (use static|dynamic|guided)\n";
+    else if (scheduleType != "balanced" && scheduleType != "tuned") {
+        std::cerr << "Unknown schedule: " << scheduleType << " (use static|dynamic|guided|balanced|tuned)\n";
         return 4;
     }
 
-    std::vector<double> matrixData;
-    matrixData.resize(matrixSize * matrixSize);
-
-    std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-    std::uniform_real_distribution<double> distribution(0.0, 1.0e6);
-
-    if (matrixType == "banded") {
-        for (std::size_t i = 0; i < matrixSize; ++i) {
-            std::size_t rowOffset = i * matrixSize;
-            // initialize row with infinities
-            for (std::size_t j = 0; j < matrixSize; ++j) {
-                matrixData[rowOffset + j] = std::numeric_limits<double>::infinity();
-            }
-            const std::size_t jlo = (i > bandwidth) ? (i - bandwidth) : 0;
-            const std::size_t jhi = std::min(matrixSize - 1, i + bandwidth);
-            for (std::size_t j = jlo; j <= jhi; ++j) {
-                matrixData[rowOffset + j] = distribution(generator);
-            }
-        }
-    }
-    else if (matrixType == "triangular") {
-        for (std::size_t i = 0; i < matrixSize; ++i) {
-            std::size_t rowOffset = i * matrixSize;
-            for (std::size_t j = 0; j < matrixSize; ++j) {
-                if (j <= i) {
-                    matrixData[rowOffset + j] = distribution(generator);
-                }
-                else {
-                    matrixData[rowOffset + j] = std::numeric_limits<double>::infinity();
-                }
-            }
-        }
-    }
-    else { // full
-        for (std::size_t i = 0; i < matrixSize; ++i) {
-            std::size_t rowOffset = i * matrixSize;
-            for (std::size_t j = 0; j < matrixSize; ++j) {
-                matrixData[rowOffset + j] = distribution(generator);
-            }
-        }
-    }
-
-    // Warm-up
-    {
-        volatile double warmUpSum = 0.0;
-        const std::size_t warmRows = std::min<std::size_t>(matrixSize, static_cast<std::size_t>(10));
-        const std::size_t warmCols = std::min<std::size_t>(matrixSize, static_cast<std::size_t>(10));
-        for (std::size_t i = 0; i < warmRows; ++i) {
-            std::size_t rowOffset = i * matrixSize;
-            for (std::size_t j = 0; j < warmCols; ++j) {
-                warmUpSum += matrixData[rowOffset + j];
-            }
-        }
-        (void)warmUpSum;
-    }
+    const NumaPolicy numaPolicy = numaPolicyFromEnv();
+    const int numaBindNode = numaBindNodeFromEnv();
+    const HugePages hugePages = hugePagesFromEnv();
+    const bool isBanded = (matrixType == "banded");
+    const bool isTriangular = (matrixType == "triangular");
+    const MatrixShape shape { isBanded ? MatrixShapeKind::banded : (isTriangular ? MatrixShapeKind::lowerTriangular : MatrixShapeKind::full),
+        matrixSize, bandwidth };
 
     omp_set_schedule(ompScheduleKind, chunkSize);
+    const SimdLevel simdLevel = selectSimdLevel();
 
-    const int numThreadsReported = omp_get_max_threads();
-    double globalMaxOfRowMins = std::numeric_limits<double>::lowest();
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    if (mode == "reduction") {
-        #pragma omp parallel for reduction(max:globalMaxOfRowMins) schedule(runtime)
-        for (std::size_t i = 0; i < matrixSize; ++i) {
-            double localMin = std::numeric_limits<double>::infinity();
-            const std::size_t rowOffset = i * matrixSize;
-
-            if (matrixType == "banded") {
-                const std::size_t jlo = (i > bandwidth) ? (i - bandwidth) : 0;
-                const std::size_t jhi = std::min(matrixSize - 1, i + bandwidth);
-                for (std::size_t j = jlo; j <= jhi; ++j) {
-                    double val = matrixData[rowOffset + j];
-                    if (val < localMin)
-                        localMin = val;
-                }
-            }
-            else if (matrixType == "triangular") {
-                for (std::size_t j = 0; j <= i; ++j) {
-                    double val = matrixData[rowOffset + j];
-                    if (val < localMin)
-                        localMin = val;
-                }
-            }
-            else { // full
-                for (std::size_t j = 0; j < matrixSize; ++j) {
-                    double val = matrixData[rowOffset + j];
-                    if (val < localMin)
-                        localMin = val;
-                }
-            }
-
-            if (localMin > globalMaxOfRowMins)
-                globalMaxOfRowMins = localMin;
-        }
+    if (storageType == "csr") {
+        const CsrStorage matrix(shape, seed, numaPolicy, numaBindNode, hugePages);
+        return runRowMins(matrix, "csr", mode, matrixType, matrixSize, bandwidth, scheduleType, chunkSize, numaPolicy, hugePages, simdLevel);
     }
-    else if (mode == "no_reduction") {
-        #pragma omp parallel
-        {
-            #pragma omp for schedule(runtime)
-            for (std::size_t i = 0; i < matrixSize; ++i) {
-                double localMin = std::numeric_limits<double>::infinity();
-                const std::size_t rowOffset = i * matrixSize;
-
-                if (matrixType == "banded") {
-                    const std::size_t jlo = (i > bandwidth) ? (i - bandwidth) : 0;
-                    const std::size_t jhi = std::min(matrixSize - 1, i + bandwidth);
-                    for (std::size_t j = jlo; j <= jhi; ++j) {
-                        double val = matrixData[rowOffset + j];
-                        if (val < localMin)
-                            localMin = val;
-                    }
-                }
-                else if (matrixType == "triangular") {
-                    for (std::size_t j = 0; j <= i; ++j) {
-                        double val = matrixData[rowOffset + j];
-                        if (val < localMin)
-                            localMin = val;
-                    }
-                }
-                else {
-                    for (std::size_t j = 0; j < matrixSize; ++j) {
-                        double val = matrixData[rowOffset + j];
-                        if (val < localMin)
-                            localMin = val;
-                    }
-                }
-
-                #pragma omp critical
-                {
-                    if (localMin > globalMaxOfRowMins)
-                        globalMaxOfRowMins = localMin;
-                }
-            }
-        }
+    if (storageType == "compact" && isBanded) {
+        const BandStorage matrix(shape, seed, numaPolicy, numaBindNode, hugePages);
+        return runRowMins(matrix, "band", mode, matrixType, matrixSize, bandwidth, scheduleType, chunkSize, numaPolicy, hugePages, simdLevel);
     }
-    else {
-        std::cerr << "Unknown mode: " << mode << " (use reduction|no_reduction)\n";
-        return 6;
+    if (storageType == "compact" && isTriangular) {
+        const PackedLowerStorage matrix(shape, seed, numaPolicy, numaBindNode, hugePages);
+        return runRowMins(matrix, "packed", mode, matrixType, matrixSize, bandwidth, scheduleType, chunkSize, numaPolicy, hugePages, simdLevel);
     }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double timeSeconds = std::chrono::duration<double>(endTime - startTime).count();
-
-    std::cout << matrixSize << ","
-        << numThreadsReported << ","
-        << mode << ","
-        << matrixType << ","
-        << bandwidth << ","
-        << scheduleType << ","
-        << chunkSize << ","
-        << timeSeconds << ","
-        << globalMaxOfRowMins
-        << std::endl;
-
-    return 0;
+    if (storageType == "padded") {
+        const DenseStorage matrix(shape, seed, numaPolicy, numaBindNode, hugePages, true);
+        return runRowMins(matrix, "padded", mode, matrixType, matrixSize, bandwidth, scheduleType, chunkSize, numaPolicy, hugePages, simdLevel);
+    }
+    const DenseStorage matrix(shape, seed, numaPolicy, numaBindNode, hugePages);
+    return runRowMins(matrix, "dense", mode, matrixType, matrixSize, bandwidth, scheduleType, chunkSize, numaPolicy, hugePages, simdLevel);
 }
@@ -1,24 +1,76 @@
 #include <iostream>
 #include <chrono>
-#include <random>
 #include <cmath>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <omp.h>
 
+#include "Accumulators.hpp"
+#include "BenchHarness.hpp"
+#include "ScheduleTuner.hpp"
+#include "WorkStealing.hpp"
+#include "WorkloadModel.hpp"
+
 // Usage:
-// OpenMP_6 <problemSize> <schedule> <chunk> <heavyProbability> <lightWork> <heavyWork> [seed]
-// schedule: static | dynamic | guided
+// OpenMP_6 <problemSize> <schedule> <chunk> <heavyProbability> <lightWork> <heavyWork> [seed] [distribution]
+// schedule: static | dynamic | guided | steal | tuned | tasks | lpt
+// tasks: blocks of chunk iterations as "omp taskloop" tasks (grainsize = chunk
+//        iterations); blocks whose cost is above the mean block cost go out
+//        with priority(1), so set OMP_MAX_TASK_PRIORITY >= 1 for that to count
+// lpt: longest processing time first - the blocks sorted by cost, largest
+//      first, and handed out in that order by a dynamic loop with chunk 1
+//      (the task queue does not promise an order within one priority)
+// Block costs come from the workload model (distribution below), i.e. the
+// prediction is exact.
+// tuned: the OpenMP schedule kind and chunk are picked online on the first
+//        TUNE_FRACTION of the iterations and cached on disk per problem size,
+//        work mix and thread count, see ScheduleTuner.hpp (chunk is ignored);
+//        tunedSchedule and tuneSource (explored | cache | fallback, when the
+//        budget is too small to explore) report the pick and exploreSeconds
+//        the time the exploring run spent on it
+// steal: std::thread workers with Chase-Lev work-stealing deques, starting
+//        from a static split and stealing half of a victim's remaining range,
+//        see WorkStealing.hpp; workers = OMP_NUM_THREADS, chunk = smallest range
 // chunk: integer chunk size for scheduling
 // heavyProbability: double in [0,1], probability that an iteration is "heavy"
 // lightWork: number of inner micro-iterations for "light" iteration (e.g. 10)
 // heavyWork: number of inner micro-iterations for "heavy" iteration (e.g. 1000)
 // seed: optional RNG seed (unsigned int)
+// distribution: bernoulli (default) | pareto | clustered | linear, see
+//               WorkloadModel.hpp; the per-iteration costs are computed from the
+//               seed before timing, so every schedule and thread count runs the
+//               same work; pareto needs lightWork >= 1
+// totalWork: inner micro-iterations of the whole loop
+// makespanBound: max(totalWork / numThreads, costliest iteration), the least
+//                work any schedule leaves on its busiest thread
+// makespanEfficiency: makespanBound converted to seconds with the measured
+//                     seconds per unit (sum of workerSeconds / totalWork), over
+//                     timeSeconds; 1 means no schedule can do better
+// steals: successful steals per run (0 for the OpenMP schedules)
+// workerSeconds: ';'-separated time each thread spent in its iterations, mean
+//                over the measured runs
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
 //
 // Example:
 // OpenMP_6 1000000 dynamic 10 0.1 10 1000 12345
 
+// One iteration of the irregular workload; trig work that is not easily optimized away.
+static double iterationValue(std::size_t i, int innerLoops) {
+    double localValue = 0.0;
+    for (int k = 0; k < innerLoops; ++k) {
+        double x = static_cast<double>(i) * 1e-6 + static_cast<double>(k) * 1e-3;
+        localValue += std::sin(x) * std::cos(x + 0.123) + std::sqrt(std::fmod(x + 1.234, 100.0));
+    }
+    return localValue;
+}
+
+// Per-worker partial sum of the steal schedule, one cache line each.
+struct alignas(cacheLineSize) WorkerSum {
+    double value = 0.0;
+};
+
 int main(int argc, char** argv) {
     if (argc < 7) {
         std::cerr << "Usage: " << argv[0]
@@ -33,6 +85,7 @@ int main(int argc, char** argv) {
     const int lightWork = std::stoi(argv[5]);
     const int heavyWork = std::stoi(argv[6]);
     const unsigned int seed = (argc >= 8) ? static_cast<unsigned int>(std::stoul(argv[7])) : 123456u;
+    const std::string distributionName = (argc >= 9) ? argv[8] : "bernoulli";
 
     if (problemSize == 0 || chunkSize <= 0 || lightWork < 0 || heavyWork < 0) {
         std::cerr << "Invalid numeric argument(s)\n";
@@ -42,6 +95,19 @@ int main(int argc, char** argv) {
         std::cerr << "heavyProbability must be in [0,1]\n";
         return 3;
     }
+    WorkloadParams workload;
+    if (!parseWorkloadDistribution(distributionName, workload.distribution)) {
+        std::cerr << "Unknown distribution: " << distributionName << " (use bernoulli|pareto|clustered|linear)\n";
+        return 5;
+    }
+    if (workload.distribution == WorkloadDistribution::pareto && lightWork < 1) {
+        std::cerr << "pareto needs lightWork >= 1 (it is the scale of the distribution)\n";
+        return 6;
+    }
+    workload.heavyProbability = heavyProbability;
+    workload.lightWork = lightWork;
+    workload.heavyWork = heavyWork;
+    workload.seed = seed;
 
     omp_sched_t ompScheduleKind = omp_sched_static;
     if (scheduleType == "static") {
@@ -53,58 +119,164 @@ int main(int argc, char** argv) {
     else if (scheduleType == "guided") {
         ompScheduleKind = omp_sched_guided;
     }
-    else {
-        std::cerr << "Unknown schedule: " << scheduleType << " (use static|dynamic|guided)\n";
+    else if (scheduleType != "steal" && scheduleType != "tuned" && scheduleType != "tasks" && scheduleType != "lpt") {
+        std::cerr << "Unknown schedule: " << scheduleType << " (use static|dynamic|guided|steal|tuned|tasks|lpt)\n";
         return 4;
     }
 
     omp_set_schedule(ompScheduleKind, chunkSize);
 
     const int numThreadsReported = omp_get_max_threads();
-    volatile double warmUp = 0.0;
-
-    // Warm-up
-    {
-        const std::size_t warmIterations = std::min<std::size_t>(problemSize, static_cast<std::size_t>(100));
-        for (std::size_t i = 0; i < warmIterations; ++i) {
-            const int innerLimit = std::min(10, lightWork);
-            for (int k = 0; k < innerLimit; ++k) {
-                warmUp += std::sin(static_cast<double>(i + k));
-            }
-        }
-        (void)warmUp;
+    const std::size_t teamSize = static_cast<std::size_t>(numThreadsReported);
+
+    const std::vector<int> innerLoops = buildWorkload(workload, problemSize);
+    double totalWork = 0.0;
+    for (int cost : innerLoops)
+        totalWork += cost;
+    const double makespanBound = makespanLowerBound(innerLoops, teamSize);
+
+    // tuned: candidates are ranked by inner loops per second; the + 1 per
+    // iteration keeps the loop overhead of zero-cost iterations in the count.
+    std::vector<std::size_t> workPrefix;
+    if (scheduleType == "tuned") {
+        workPrefix.assign(problemSize + 1, 0);
+        for (std::size_t i = 0; i < problemSize; ++i)
+            workPrefix[i + 1] = workPrefix[i] + static_cast<std::size_t>(innerLoops[i]) + 1;
     }
 
+    // tasks / lpt: blocks of chunk iterations with their predicted cost.
+    const std::size_t blockSize = static_cast<std::size_t>(chunkSize);
+    const std::size_t blockCount = (problemSize + blockSize - 1) / blockSize;
+    std::vector<double> blockCosts(blockCount, 0.0);
+    for (std::size_t i = 0; i < problemSize; ++i)
+        blockCosts[i / blockSize] += innerLoops[i];
+    std::vector<std::size_t> heavyBlocks;
+    std::vector<std::size_t> lightBlocks;
+    for (std::size_t b = 0; b < blockCount; ++b)
+        (blockCosts[b] > totalWork / static_cast<double>(blockCount) ? heavyBlocks : lightBlocks).push_back(b);
+    std::vector<std::size_t> blocksByCost(blockCount);
+    for (std::size_t b = 0; b < blockCount; ++b)
+        blocksByCost[b] = b;
+    std::stable_sort(blocksByCost.begin(), blocksByCost.end(), [&](std::size_t a, std::size_t b) {
+        return blockCosts[a] > blockCosts[b];
+    });
+    if (scheduleType == "tasks" && omp_get_max_task_priority() < 1)
+        std::cerr << "OMP_MAX_TASK_PRIORITY is 0; the priority of heavy blocks is ignored\n";
+
+    const BenchConfig benchConfig = benchConfigFromEnv();
     double globalSum = 0.0;
+    std::size_t steals = 0;
+    PerThreadSeconds perWorkerSeconds;
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+    std::ostringstream signature;
+    signature << "OpenMP_6 n=" << problemSize << " distribution=" << distributionName << " heavyProbability=" << heavyProbability << " lightWork=" << lightWork
+        << " heavyWork=" << heavyWork << " threads=" << numThreadsReported;
+    ScheduleTuner tuner(signature.str());
+    double exploreSeconds = 0.0;
 
-    #pragma omp parallel default(none) shared(problemSize, heavyProbability, lightWork, heavyWork, seed) reduction(+:globalSum)
-    {
-        const int threadId = omp_get_thread_num();
-        std::mt19937_64 localRng(static_cast<unsigned long long>(seed) + static_cast<unsigned long long>(threadId) * 6969ull);
-        std::uniform_real_distribution<double> dist(0.0, 1.0);
+    const BenchStats stats = runBenchmark(benchConfig, [&]() {
+        globalSum = 0.0;
+        std::vector<double> workerSeconds(teamSize, 0.0);
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-        #pragma omp for schedule(runtime)
-        for (std::size_t i = 0; i < problemSize; ++i) {
-            double r = dist(localRng);
-            const int innerLoops = (r < heavyProbability) ? heavyWork : lightWork;
+        if (scheduleType == "steal") {
+            std::vector<WorkerSum> workerSums(teamSize);
+            const WorkStealingStats stealStats = runWorkStealing(problemSize, teamSize, static_cast<std::size_t>(chunkSize),
+                [&](std::size_t begin, std::size_t end, std::size_t worker) {
+                    double rangeSum = 0.0;
+                    for (std::size_t i = begin; i < end; ++i)
+                        rangeSum += iterationValue(i, innerLoops[i]);
+                    workerSums[worker].value += rangeSum;
+                });
+            for (const WorkerSum& workerSum : workerSums)
+                globalSum += workerSum.value;
+            workerSeconds = stealStats.busySeconds;
+            steals = 0;
+            for (std::size_t count : stealStats.steals)
+                steals += count;
+        }
+        else if (scheduleType == "tasks" || scheduleType == "lpt") {
+            // Runs block b on the calling thread and books its sum and time there.
+            std::vector<WorkerSum> threadSums(teamSize);
+            auto runBlock = [&](std::size_t b) {
+                const std::size_t threadId = static_cast<std::size_t>(omp_get_thread_num());
+                const double blockStart = omp_get_wtime();
+                const std::size_t end = std::min(problemSize, (b + 1) * blockSize);
+                double blockSum = 0.0;
+                for (std::size_t i = b * blockSize; i < end; ++i)
+                    blockSum += iterationValue(i, innerLoops[i]);
+                threadSums[threadId].value += blockSum;
+                workerSeconds[threadId] += omp_get_wtime() - blockStart;
+            };
 
-            double localValue = 0.0;
-            // use simple trig-work which is not easily optimized away
-            for (int k = 0; k < innerLoops; ++k) {
-                double x = static_cast<double>(i) * 1e-6 + static_cast<double>(k) * 1e-3;
-                localValue += std::sin(x) * std::cos(x + 0.123) + std::sqrt(std::fmod(x + 1.234, 100.0));
+            if (scheduleType == "tasks") {
+                #pragma omp parallel num_threads(numThreadsReported)
+                #pragma omp single
+                {
+                    #pragma omp taskloop grainsize(1) priority(1) nogroup
+                    for (std::size_t k = 0; k < heavyBlocks.size(); ++k)
+                        runBlock(heavyBlocks[k]);
+                    #pragma omp taskloop grainsize(1) nogroup
+                    for (std::size_t k = 0; k < lightBlocks.size(); ++k)
+                        runBlock(lightBlocks[k]);
+                }
             }
-            globalSum += localValue;
+            else {
+                #pragma omp parallel for schedule(dynamic, 1) num_threads(numThreadsReported)
+                for (std::size_t k = 0; k < blockCount; ++k)
+                    runBlock(blocksByCost[k]);
+            }
+            for (const WorkerSum& threadSum : threadSums)
+                globalSum += threadSum.value;
+            steals = 0;
         }
-    }
+        else {
+            auto runSlice = [&](std::size_t begin, std::size_t end) {
+                double sliceSum = 0.0;
+                #pragma omp parallel reduction(+:sliceSum) num_threads(numThreadsReported)
+                {
+                    const std::size_t threadId = static_cast<std::size_t>(omp_get_thread_num());
+                    const double threadStart = omp_get_wtime();
+                    #pragma omp for schedule(runtime) nowait
+                    for (std::size_t i = begin; i < end; ++i) {
+                        sliceSum += iterationValue(i, innerLoops[i]);
+                    }
+                    workerSeconds[threadId] += omp_get_wtime() - threadStart;
+                }
+                globalSum += sliceSum;
+            };
+            if (scheduleType == "tuned") {
+                tuner.run(problemSize, runSlice, &workPrefix);
+                exploreSeconds = std::max(exploreSeconds, tuner.exploreSeconds);
+            }
+            else {
+                runSlice(0, problemSize);
+            }
+            steals = 0;
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        perWorkerSeconds.record(workerSeconds);
+        return std::chrono::duration<double>(endTime - startTime).count();
+    }, &perWorkerSeconds);
+
+    double busySeconds = 0.0;
+    for (double seconds : perWorkerSeconds.means())
+        busySeconds += seconds;
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double timeSeconds = std::chrono::duration<double>(endTime - startTime).count();
+    const double secondsPerUnit = (totalWork > 0.0) ? busySeconds / totalWork : 0.0;
+    const double makespanEfficiency = (stats.median > 0.0) ? makespanBound * secondsPerUnit / stats.median : 0.0;
 
-    std::cout << problemSize << "," << numThreadsReported << "," << scheduleType << "," << chunkSize
-        << "," << timeSeconds << "," << globalSum << std::endl;
+    const bool tuned = (scheduleType == "tuned");
+    BenchRow row;
+    row.add("problemSize", problemSize).add("numThreads", numThreadsReported).add("schedule", scheduleType).add("chunk", chunkSize)
+        .add("timeSeconds", stats.median).add("resultSum", globalSum).add("steals", steals).add("workerSeconds", perWorkerSeconds.joined())
+        .add("tunedSchedule", tuned ? tuner.winnerName() : std::string("none"))
+        .add("tuneSource", tuned ? tuner.sourceName() : "none").add("exploreSeconds", exploreSeconds)
+        .add("distribution", distributionName).add("totalWork", totalWork).add("makespanBound", makespanBound)
+        .add("makespanEfficiency", makespanEfficiency)
+        .addStats(stats);
+    row.print(std::cout, benchConfig);
 
     return 0;
 }
@@ -1,100 +1,159 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <string>
 #include <omp.h>
 #include <limits>
 #include <algorithm>
 
-// Usage: OpenMP_7 <problemSize> <mode> [seed]
-// mode: reduction | atomic | critical | lock
+#include "Accumulators.hpp"
+#include "BenchHarness.hpp"
+#include "CounterRng.hpp"
+#include "NumaAllocator.hpp"
+
+// Usage: OpenMP_7 <problemSize> <mode> [seed] [stripes]
+// mode: reduction | atomic | critical | lock | padded | false_sharing | cas | sharded | combining
+// padded:        per-thread slots, one cache line each (Accumulators.hpp)
+// false_sharing: the same slots packed into shared cache lines
+// cas:           one shared value updated with a compare-and-swap loop
+// sharded:       <stripes> padded CAS cells (default 4), thread t -> stripe t % stripes
+// combining:     software combining tree
+// Every mode adds one product per element; updatesPerSecond = problemSize / timeSeconds.
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// NUMA_POLICY (env): master | first_touch | interleave | bind (NUMA_BIND_NODE, default 0)
 
 int main(int argc, char** argv) {
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <problemSize> <mode> [seed]\n";
+        std::cerr << "Usage: " << argv[0] << " <problemSize> <mode> [seed] [stripes]\n";
         return 1;
     }
 
     const std::size_t problemSize = static_cast<std::size_t>(std::stoull(argv[1]));
     const std::string mode = argv[2];
     const unsigned int seed = (argc >= 4) ? static_cast<unsigned int>(std::stoul(argv[3])) : 123456u;
+    const int stripeCount = (argc >= 5) ? std::stoi(argv[4]) : 4;
 
     if (problemSize == 0) {
         std::cerr << "problemSize must be > 0\n";
         return 2;
     }
-
-    std::vector<double> vectorA(problemSize);
-    std::vector<double> vectorB(problemSize);
-
-    std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-    std::uniform_real_distribution<double> distribution(0.0, 1.0);
-    for (std::size_t i = 0; i < problemSize; ++i) {
-        vectorA[i] = distribution(generator);
-        vectorB[i] = distribution(generator);
+    if (stripeCount <= 0) {
+        std::cerr << "stripes must be > 0\n";
+        return 2;
     }
-
-    // Warm-up
-    {
-        volatile double warmSum = 0.0;
-        const std::size_t warmCount = std::min<std::size_t>(problemSize, static_cast<std::size_t>(1000));
-        for (std::size_t i = 0; i < warmCount; ++i) {
-            warmSum += vectorA[i] * vectorB[i];
-        }
-        (void)warmSum;
+    const std::vector<std::string> modeNames = { "reduction", "atomic", "critical", "lock", "padded", "false_sharing", "cas", "sharded", "combining" };
+    if (std::find(modeNames.begin(), modeNames.end(), mode) == modeNames.end()) {
+        std::cerr << "Unknown mode: " << mode << " (use reduction|atomic|critical|lock|padded|false_sharing|cas|sharded|combining)\n";
+        return 4;
     }
 
+    const NumaPolicy numaPolicy = numaPolicyFromEnv();
+    const int numaBindNode = numaBindNodeFromEnv();
+    NumaVector<double> vectorA(NumaAllocator<double>(numaPolicy, numaBindNode));
+    NumaVector<double> vectorB(NumaAllocator<double>(numaPolicy, numaBindNode));
+    vectorA.resize(problemSize);
+    vectorB.resize(problemSize);
+
+    initializeWithPolicy(numaPolicy, problemSize, [&](std::size_t begin, std::size_t end) {
+        fillUniformReal(vectorA.data() + begin, begin, end - begin, seed, 0, 0.0, 1.0);
+        fillUniformReal(vectorB.data() + begin, begin, end - begin, seed, 1, 0.0, 1.0);
+    });
+
     const int numThreadsReported = omp_get_max_threads();
+    const BenchConfig benchConfig = benchConfigFromEnv();
     double globalSum = 0.0;
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+    const BenchStats stats = runBenchmark(benchConfig, [&]() {
+        globalSum = 0.0;
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-    if (mode == "reduction") {
-        #pragma omp parallel for reduction(+:globalSum)
-        for (std::size_t i = 0; i < problemSize; ++i) {
-            globalSum += vectorA[i] * vectorB[i];
+        if (mode == "reduction") {
+            #pragma omp parallel for reduction(+:globalSum)
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                globalSum += vectorA[i] * vectorB[i];
+            }
         }
-    }
-    else if (mode == "atomic") {
-        #pragma omp parallel for
-        for (std::size_t i = 0; i < problemSize; ++i) {
-            double localValue = vectorA[i] * vectorB[i];
-            #pragma omp atomic
-            globalSum += localValue;
+        else if (mode == "atomic") {
+            #pragma omp parallel for
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                double localValue = vectorA[i] * vectorB[i];
+                #pragma omp atomic
+                globalSum += localValue;
+            }
         }
-    }
-    else if (mode == "critical") {
-        #pragma omp parallel for
-        for (std::size_t i = 0; i < problemSize; ++i) {
-            double localValue = vectorA[i] * vectorB[i];
-            #pragma omp critical
-            {
+        else if (mode == "critical") {
+            #pragma omp parallel for
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                double localValue = vectorA[i] * vectorB[i];
+                #pragma omp critical
+                {
+                    globalSum += localValue;
+                }
+            }
+        }
+        else if (mode == "lock") {
+            omp_lock_t globalLock;
+            omp_init_lock(&globalLock);
+            #pragma omp parallel for
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                double localValue = vectorA[i] * vectorB[i];
+                omp_set_lock(&globalLock);
                 globalSum += localValue;
+                omp_unset_lock(&globalLock);
             }
+            omp_destroy_lock(&globalLock);
         }
-    }
-    else if (mode == "lock") {
-        omp_lock_t globalLock;
-        omp_init_lock(&globalLock);
-        #pragma omp parallel for
-        for (std::size_t i = 0; i < problemSize; ++i) {
-            double localValue = vectorA[i] * vectorB[i];
-            omp_set_lock(&globalLock);
-            globalSum += localValue;
-            omp_unset_lock(&globalLock);
+        else if (mode == "padded") {
+            PaddedSlotAccumulator accumulator(numThreadsReported);
+            #pragma omp parallel for
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                accumulator.add(vectorA[i] * vectorB[i]);
+            }
+            globalSum = accumulator.total();
+        }
+        else if (mode == "false_sharing") {
+            FalseSharingAccumulator accumulator(numThreadsReported);
+            #pragma omp parallel for
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                accumulator.add(vectorA[i] * vectorB[i]);
+            }
+            globalSum = accumulator.total();
+        }
+        else if (mode == "cas") {
+            CasAccumulator accumulator;
+            #pragma omp parallel for
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                accumulator.add(vectorA[i] * vectorB[i]);
+            }
+            globalSum = accumulator.total();
+        }
+        else if (mode == "sharded") {
+            ShardedAccumulator accumulator(stripeCount);
+            #pragma omp parallel for
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                accumulator.add(vectorA[i] * vectorB[i]);
+            }
+            globalSum = accumulator.total();
+        }
+        else if (mode == "combining") {
+            CombiningTreeAccumulator accumulator(numThreadsReported);
+            #pragma omp parallel for
+            for (std::size_t i = 0; i < problemSize; ++i) {
+                accumulator.add(vectorA[i] * vectorB[i]);
+            }
+            globalSum = accumulator.total();
         }
-        omp_destroy_lock(&globalLock);
-    }
-    else {
-        std::cerr << "Unknown mode: " << mode << " (use reduction|atomic|critical|lock)\n";
-        return 4;
-    }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double timeSeconds = std::chrono::duration<double>(endTime - startTime).count();
+        auto endTime = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(endTime - startTime).count();
+    });
+    const double updatesPerSecond = static_cast<double>(problemSize) / stats.median;
 
-    std::cout << problemSize << "," << numThreadsReported << "," << mode << "," << timeSeconds << "," << globalSum << std::endl;
+    BenchRow row;
+    row.add("problemSize", problemSize).add("numThreads", numThreadsReported).add("mode", mode).add("timeSeconds", stats.median)
+        .add("globalSum", globalSum).add("updatesPerSecond", updatesPerSecond).add("numaPolicy", numaPolicyName(numaPolicy))
+        .addStats(stats);
+    row.print(std::cout, benchConfig);
 
     return 0;
 }
@@ -1,16 +1,73 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <string>
-#include <thread>
-#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 #include <omp.h>
 
+#include "BenchHarness.hpp"
+#include "Accumulators.hpp"
+#include "AsyncFileReader.hpp"
+#include "CounterRng.hpp"
+#include "MappedDataset.hpp"
+#include "NumaAllocator.hpp"
+#include "PairwiseDot.hpp"
+#include "Pipeline.hpp"
+#include "SpscRing.hpp"
+
 // Usage:
-// OpenMP_8 <numVectors> <vectorSize> <mode> [seed]
-// mode: sections | sequential
+// OpenMP_8 <numVectors> <vectorSize> <mode> [seed] [ringCapacity] [readers] [reduction]
+// mode: sections | sequential | pipeline | async | mmap
+// sections: one reader section feeds one compute section through an SpscRing
+//           (SpscRing.hpp) of ringCapacity vector pairs (default 4); both
+//           sides spin briefly and then sleep when the ring is full or empty
+// pipeline: runPipeline (Pipeline.hpp) - readers threads (default 1), each
+//           with its own file handle, feed the other OMP_NUM_THREADS - readers
+//           threads through MPMC queues of max(ringCapacity, 2 * threads)
+//           buffer slots; workers use the SIMD dot kernel of PairwiseDot.hpp
+// async:    AsyncFileReader (AsyncFileReader.hpp) - one thread keeps
+//           IO_QUEUE_DEPTH reads of IO_BLOCK_KIB in flight (io_uring, or a
+//           pread thread pool) into a page-aligned pool of vector-pair
+//           slots and computes each vector with the SIMD dot kernel, in
+//           order, as soon as all of its blocks have arrived. Reads cover
+//           the whole pages around each vector pair, so they stay valid
+//           under IO_DIRECT=1 (O_DIRECT, page cache bypassed).
+// mmap:     MappedFile (MappedDataset.hpp) - the file is mapped once per run
+//           and the header checked in place; an omp parallel for over the
+//           vectors runs the SIMD dot kernel on the mapped pages, with no
+//           copies and no reader thread. Per-vector sums are added in order.
+//           MMAP_PREFETCH (env) picks the hint: none | sequential (default,
+//           madvise MADV_SEQUENTIAL) | willneed (MADV_WILLNEED on the whole
+//           file) | populate (MAP_POPULATE, pre-faulted at map time).
+// reduction: ordered | unordered (pipeline only, default ordered)
+//   ordered:   one sum per vector, added in vector order after the pipeline,
+//              so totalSum does not depend on the thread count
+//   unordered: per-worker partial sums in completion order
+// producerSlotWaitSeconds / consumerSlotWaitSeconds: time the readers waited
+// for a free slot and the consumers for a filled one, summed over threads,
+// per vector, in the last run; ringSleeps counts the waits that ended asleep
+// (all 0 for sequential). readers / workers: threads per stage (1 / 1 for
+// sections, 0 / 1 for sequential); isa: the pipeline dot kernel (scalar loop
+// otherwise). ioBackend / queueDepth / blockKiB / direct: the async read
+// path actually used ("ifstream" or "mmap", 0, 0, 0 for the other modes);
+// readGBs is the input file size over timeSeconds. mmapPrefetch: the hint
+// used ("none" for the other modes).
+// Every mode is measured twice. The cold runs come first, each after the
+// file has been dropped from the page cache (fdatasync + posix_fadvise
+// DONTNEED); coldSeconds is their median and coldResidentFraction the share
+// of the file still cached after the last drop (mincore; -1 where it cannot
+// be measured, and evicting is not possible there either). Then the warm
+// runs, with the file cached, give timeSeconds, the other columns and the
+// BenchStats columns.
+// IO_BACKEND, IO_QUEUE_DEPTH, IO_BLOCK_KIB, IO_DIRECT (env): async mode only,
+//   see AsyncFileReader.hpp
+// SIMD_ISA (env): caps the pipeline dot kernel's ISA, see CpuFeatures.hpp
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// Every run re-reads the input file; all runs but the cold ones find it in the page cache.
 
 struct InputHeader {
     unsigned long long numVectors;
@@ -19,7 +76,7 @@ struct InputHeader {
 
 int main(int argc, char** argv) {
     if (argc < 4) {
-        std::cerr << "Usage: " << argv[0] << " <numVectors> <vectorSize> <mode> [seed]\n";
+        std::cerr << "Usage: " << argv[0] << " <numVectors> <vectorSize> <mode> [seed] [ringCapacity] [readers] [reduction]\n";
         return 1;
     }
 
@@ -27,11 +84,22 @@ int main(int argc, char** argv) {
     const std::size_t vectorSize = static_cast<std::size_t>(std::stoull(argv[2]));
     const std::string mode = argv[3];
     const unsigned int seed = (argc >= 5) ? static_cast<unsigned int>(std::stoul(argv[4])) : 123456u;
+    const std::size_t ringCapacity = (argc >= 6) ? static_cast<std::size_t>(std::stoull(argv[5])) : 4;
+    const std::size_t requestedReaders = (argc >= 7) ? static_cast<std::size_t>(std::stoull(argv[6])) : 1;
+    const std::string reduction = (argc >= 8) ? argv[7] : "ordered";
 
-    if (numVectors == 0 || vectorSize == 0) {
-        std::cerr << "numVectors and vectorSize must be > 0\n";
+    if (numVectors == 0 || vectorSize == 0 || ringCapacity == 0 || requestedReaders == 0) {
+        std::cerr << "numVectors, vectorSize, ringCapacity and readers must be > 0\n";
         return 2;
     }
+    if (mode != "sequential" && mode != "sections" && mode != "pipeline" && mode != "async" && mode != "mmap") {
+        std::cerr << "Unknown mode: " << mode << "\n";
+        return 6;
+    }
+    if (reduction != "ordered" && reduction != "unordered") {
+        std::cerr << "Unknown reduction: " << reduction << " (use ordered|unordered)\n";
+        return 6;
+    }
 
     const std::string inputFilePath = "../results/OpenMP_8_input.bin";
 
@@ -48,150 +116,345 @@ int main(int argc, char** argv) {
         };
         outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
-        std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-        std::uniform_real_distribution<double> distribution(0.0, 1.0);
-
         std::vector<double> bufferA(vectorSize);
         std::vector<double> bufferB(vectorSize);
 
         for (std::size_t v = 0; v < numVectors; ++v) {
-            for (std::size_t i = 0; i < vectorSize; ++i) {
-                bufferA[i] = distribution(generator);
-                bufferB[i] = distribution(generator);
-            }
+            parallelFillUniformReal(bufferA.data(), v * vectorSize, vectorSize, seed, 0, 0.0, 1.0);
+            parallelFillUniformReal(bufferB.data(), v * vectorSize, vectorSize, seed, 1, 0.0, 1.0);
             outFile.write(reinterpret_cast<const char*>(bufferA.data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
             outFile.write(reinterpret_cast<const char*>(bufferB.data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
         }
         outFile.close();
     }
 
-    double totalSum = 0.0;
     const int numThreadsReported = omp_get_max_threads();
-    auto timeStart = std::chrono::high_resolution_clock::now();
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    double totalSum = 0.0;
+    int exitCode = 0;
+    double producerSlotWaitSeconds = 0.0;
+    double consumerSlotWaitSeconds = 0.0;
+    std::uint64_t ringSleeps = 0;
+    std::size_t slotCount = ringCapacity;
+    std::size_t readers = 0;
+    std::size_t workers = 1;
+    const DotBlockKernel dotKernel = selectDotBlockKernel(selectSimdLevel());
+    const char* isa = "scalar";
 
-    if (mode == "sequential" || numThreadsReported < 2) {
-        std::ifstream inFile(inputFilePath, std::ios::binary);
-        if (!inFile) {
-            std::cerr << "Failed to open input file for reading\n";
-            return 4;
-        }
+    // Async mode: the aligned span around vector pair v, and a pool of slots
+    // large enough to keep queueDepth blocks in flight.
+    const AsyncIoConfig ioConfig = asyncIoConfigFromEnv();
+    const std::uint64_t pairBytes = 2 * static_cast<std::uint64_t>(vectorSize) * sizeof(double);
+    const std::uint64_t fileBytes = sizeof(InputHeader) + numVectors * pairBytes;
+    auto pairSpan = [&](std::size_t v, std::uint64_t& spanBegin, std::uint64_t& spanEnd) {
+        spanBegin = (sizeof(InputHeader) + v * pairBytes) / asyncIoAlignment * asyncIoAlignment;
+        spanEnd = (sizeof(InputHeader) + (v + 1) * pairBytes + asyncIoAlignment - 1) / asyncIoAlignment * asyncIoAlignment;
+    };
+    const std::size_t ioSlotBytes = static_cast<std::size_t>((pairBytes + asyncIoAlignment - 1) / asyncIoAlignment * asyncIoAlignment + asyncIoAlignment);
+    const std::size_t ioBlocksPerSlot = (ioSlotBytes + ioConfig.blockBytes - 1) / ioConfig.blockBytes;
+    const std::size_t ioSlots = std::max<std::size_t>(2, (ioConfig.queueDepth + ioBlocksPerSlot - 1) / ioBlocksPerSlot + 1);
+    unsigned char* ioPool = nullptr;
+    if (mode == "async")
+        ioPool = static_cast<unsigned char*>(numaAllocateBytes(ioSlots * ioSlotBytes, NumaPolicy::firstTouch, 0));
+    std::string ioBackend = "ifstream";
+    bool ioDirect = false;
 
-        InputHeader header;
-        inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
-        if (header.numVectors != static_cast<unsigned long long>(numVectors) || header.vectorSize != static_cast<unsigned long long>(vectorSize)) {
-            std::cerr << "Header mismatch\n";
-            return 5;
+    std::string mmapPrefetch = "sequential";
+    const char* requestedPrefetch = std::getenv("MMAP_PREFETCH");
+    if (requestedPrefetch != nullptr) {
+        mmapPrefetch = requestedPrefetch;
+        if (mmapPrefetch != "none" && mmapPrefetch != "sequential" && mmapPrefetch != "willneed" && mmapPrefetch != "populate") {
+            std::cerr << "Unknown MMAP_PREFETCH '" << mmapPrefetch << "' (use none|sequential|willneed|populate), using sequential\n";
+            mmapPrefetch = "sequential";
         }
+    }
+    std::vector<double> mappedVectorSums((mode == "mmap") ? numVectors : 0);
 
-        std::vector<double> vectorA(vectorSize);
-        std::vector<double> vectorB(vectorSize);
+    // A failed run sets exitCode; the remaining runs are skipped.
+    auto runOnce = [&]() {
+        if (exitCode != 0)
+            return 0.0;
+        totalSum = 0.0;
+        auto timeStart = std::chrono::high_resolution_clock::now();
 
-        for (std::size_t v = 0; v < numVectors; ++v) {
-            inFile.read(reinterpret_cast<char*>(vectorA.data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
-            inFile.read(reinterpret_cast<char*>(vectorB.data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
-            double localSum = 0.0;
-            for (std::size_t i = 0; i < vectorSize; ++i) {
-                localSum += vectorA[i] * vectorB[i];
+        if (mode == "sequential" || (mode == "sections" && numThreadsReported < 2)) {
+            std::ifstream inFile(inputFilePath, std::ios::binary);
+            if (!inFile) {
+                std::cerr << "Failed to open input file for reading\n";
+                exitCode = 4;
+                return 0.0;
+            }
+
+            InputHeader header;
+            inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (header.numVectors != static_cast<unsigned long long>(numVectors) || header.vectorSize != static_cast<unsigned long long>(vectorSize)) {
+                std::cerr << "Header mismatch\n";
+                exitCode = 5;
+                return 0.0;
             }
-            totalSum += localSum;
+
+            std::vector<double> vectorA(vectorSize);
+            std::vector<double> vectorB(vectorSize);
+
+            for (std::size_t v = 0; v < numVectors; ++v) {
+                inFile.read(reinterpret_cast<char*>(vectorA.data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
+                inFile.read(reinterpret_cast<char*>(vectorB.data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
+                double localSum = 0.0;
+                for (std::size_t i = 0; i < vectorSize; ++i) {
+                    localSum += vectorA[i] * vectorB[i];
+                }
+                totalSum += localSum;
+            }
+            inFile.close();
         }
-        inFile.close();
-    }
-    else if (mode == "sections") {
-        const std::size_t bufferCapacity = 4;
-        std::vector<std::vector<double>> bufferA(bufferCapacity, std::vector<double>(vectorSize));
-        std::vector<std::vector<double>> bufferB(bufferCapacity, std::vector<double>(vectorSize));
-
-        std::atomic<std::size_t> countSlots(0);
-        std::atomic<bool> finishedReading(false);
-        std::size_t headIdx = 0;
-        std::size_t tailIdx = 0;
-        omp_lock_t bufferLock;
-        omp_init_lock(&bufferLock);
-
-        omp_lock_t sumLock;
-        omp_init_lock(&sumLock);
-
-        #pragma omp parallel default(none) shared(inputFilePath, numVectors, vectorSize, bufferCapacity, bufferA, bufferB, countSlots, finishedReading, headIdx, tailIdx, bufferLock, sumLock, std::cout, std::cerr) reduction(+:totalSum)
-        {
-            #pragma omp sections
+        else if (mode == "sections") {
+            // Each slot holds one (A, B) pair; the reader fills it in place and
+            // the consumer reads it in place.
+            std::vector<std::vector<double>> bufferA(ringCapacity, std::vector<double>(vectorSize));
+            std::vector<std::vector<double>> bufferB(ringCapacity, std::vector<double>(vectorSize));
+            SpscRing ring(ringCapacity);
+
+            #pragma omp parallel default(none) shared(inputFilePath, numVectors, vectorSize, bufferA, bufferB, ring, exitCode, std::cerr) reduction(+:totalSum)
             {
-                #pragma omp section
+                #pragma omp sections
                 {
-                    std::ifstream inFile(inputFilePath, std::ios::binary);
-                    if (!inFile) {
-                        #pragma omp critical
-                        {
-                            std::cerr << "Reader: failed to open input file: " << inputFilePath << "\n";
+                    #pragma omp section
+                    {
+                        std::ifstream inFile(inputFilePath, std::ios::binary);
+                        InputHeader header {};
+                        if (inFile)
+                            inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+                        if (!inFile || header.numVectors != static_cast<unsigned long long>(numVectors) || header.vectorSize != static_cast<unsigned long long>(vectorSize)) {
+                            #pragma omp critical
+                            {
+                                std::cerr << "Reader: failed to open input file or header mismatch: " << inputFilePath << "\n";
+                                exitCode = 4;
+                            }
+                        }
+                        else {
+                            for (std::size_t v = 0; v < numVectors; ++v) {
+                                const std::size_t slot = ring.acquireWrite();
+                                inFile.read(reinterpret_cast<char*>(bufferA[slot].data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
+                                inFile.read(reinterpret_cast<char*>(bufferB[slot].data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
+                                ring.publish();
+                            }
+                            inFile.close();
                         }
-                        finishedReading.store(true);
+                        ring.close();
                     }
-                    else {
-                        InputHeader header;
-                        inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
-                        for (std::size_t v = 0; v < numVectors; ++v) {
-                            while (countSlots.load(std::memory_order_acquire) == bufferCapacity) {
-                                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                    #pragma omp section
+                    {
+                        std::size_t slot = 0;
+                        while (ring.acquireRead(slot)) {
+                            const double* inA = bufferA[slot].data();
+                            const double* inB = bufferB[slot].data();
+                            double localSum = 0.0;
+                            for (std::size_t i = 0; i < vectorSize; ++i) {
+                                localSum += inA[i] * inB[i];
                             }
+                            ring.release();
 
-                            omp_set_lock(&bufferLock);
-                            std::vector<double>& outA = bufferA[tailIdx];
-                            std::vector<double>& outB = bufferB[tailIdx];
-                            inFile.read(reinterpret_cast<char*>(outA.data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
-                            inFile.read(reinterpret_cast<char*>(outB.data()), static_cast<std::streamsize>(vectorSize * sizeof(double)));
-                            tailIdx = (tailIdx + 1) % bufferCapacity;
-                            countSlots.fetch_add(1, std::memory_order_release);
-                            omp_unset_lock(&bufferLock);
+                            totalSum += localSum;
                         }
-                        inFile.close();
-                        finishedReading.store(true);
                     }
                 }
+            }
+            producerSlotWaitSeconds = ring.producerWaitSeconds() / static_cast<double>(numVectors);
+            consumerSlotWaitSeconds = ring.consumerWaitSeconds() / static_cast<double>(numVectors);
+            ringSleeps = ring.sleeps();
+            readers = 1;
+        }
+        else if (mode == "pipeline") {
+            slotCount = std::max(ringCapacity, 2 * static_cast<std::size_t>(numThreadsReported));
+            std::vector<std::vector<double>> bufferA(slotCount, std::vector<double>(vectorSize));
+            std::vector<std::vector<double>> bufferB(slotCount, std::vector<double>(vectorSize));
+            std::vector<std::ifstream> readerFiles(static_cast<std::size_t>(numThreadsReported));
+            std::vector<double> vectorSums(numVectors);
+            PaddedSlotAccumulator workerSums(numThreadsReported);
+            const bool ordered = (reduction == "ordered");
+            const std::streamsize vectorBytes = static_cast<std::streamsize>(vectorSize * sizeof(double));
 
-                #pragma omp section
-                {
-                    std::vector<double> localA(vectorSize);
-                    std::vector<double> localB(vectorSize);
-
-                    while (!finishedReading.load(std::memory_order_acquire) || countSlots.load(std::memory_order_acquire) > 0) {
-                        while (countSlots.load(std::memory_order_acquire) == 0) {
-                            if (finishedReading.load(std::memory_order_acquire))
-                                break;
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                        }
-                        if (countSlots.load(std::memory_order_acquire) == 0 && finishedReading.load(std::memory_order_acquire)) {
-                            break;
-                        }
-
-                        omp_set_lock(&bufferLock);
-                        std::swap(localA, bufferA[headIdx]);
-                        std::swap(localB, bufferB[headIdx]);
-                        headIdx = (headIdx + 1) % bufferCapacity;
-                        countSlots.fetch_sub(1, std::memory_order_release);
-                        omp_unset_lock(&bufferLock);
+            auto readVector = [&](std::size_t v, std::size_t slot, std::size_t reader) {
+                std::ifstream& inFile = readerFiles[reader];
+                if (!inFile.is_open()) {
+                    inFile.open(inputFilePath, std::ios::binary);
+                    InputHeader header {};
+                    if (inFile)
+                        inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+                    if (!inFile || header.numVectors != static_cast<unsigned long long>(numVectors) || header.vectorSize != static_cast<unsigned long long>(vectorSize))
+                        return false;
+                }
+                inFile.seekg(static_cast<std::streamoff>(sizeof(InputHeader)) + static_cast<std::streamoff>(v) * 2 * vectorBytes);
+                inFile.read(reinterpret_cast<char*>(bufferA[slot].data()), vectorBytes);
+                inFile.read(reinterpret_cast<char*>(bufferB[slot].data()), vectorBytes);
+                return static_cast<bool>(inFile);
+            };
+            auto dotVector = [&](std::size_t v, std::size_t slot, std::size_t) {
+                const double sum = dotKernel(bufferA[slot].data(), bufferB[slot].data(), vectorSize);
+                if (ordered)
+                    vectorSums[v] = sum;
+                else
+                    workerSums.add(sum);
+            };
 
-                        double localSum = 0.0;
-                        for (std::size_t i = 0; i < vectorSize; ++i) {
-                            localSum += localA[i] * localB[i];
-                        }
+            const PipelineStats pipelineStats = runPipeline(numVectors, requestedReaders, slotCount, readVector, dotVector);
+            if (pipelineStats.failed) {
+                std::cerr << "Reader: failed to read input file or header mismatch: " << inputFilePath << "\n";
+                exitCode = 4;
+                return 0.0;
+            }
+            if (ordered) {
+                for (double sum : vectorSums)
+                    totalSum += sum;
+            }
+            else {
+                totalSum = workerSums.total();
+            }
+            producerSlotWaitSeconds = pipelineStats.readerWaitSeconds / static_cast<double>(numVectors);
+            consumerSlotWaitSeconds = pipelineStats.workerWaitSeconds / static_cast<double>(numVectors);
+            ringSleeps = pipelineStats.sleeps;
+            readers = pipelineStats.readers;
+            workers = pipelineStats.workers;
+            isa = dotBlockKernelName(dotKernel);
+        }
+        else if (mode == "async") {
+            AsyncFileReader reader;
+            IoCompletion completion {};
+            bool headerValid = reader.open(inputFilePath, ioConfig, ioPool, ioSlots * ioSlotBytes)
+                && reader.submit(ioPool, asyncIoAlignment, 0, 0) && reader.waitOne(completion)
+                && completion.result >= static_cast<long long>(sizeof(InputHeader));
+            if (headerValid) {
+                InputHeader header {};
+                std::memcpy(&header, ioPool, sizeof(header));
+                headerValid = (header.numVectors == static_cast<unsigned long long>(numVectors) && header.vectorSize == static_cast<unsigned long long>(vectorSize));
+            }
+            if (!headerValid) {
+                std::cerr << "Async reader: failed to open input file or header mismatch: " << inputFilePath << "\n";
+                exitCode = 4;
+                return 0.0;
+            }
+            ioBackend = ioBackendName(reader.backend());
+            ioDirect = reader.direct();
 
-                        totalSum += localSum;
+            // Tags are (vector << 24) | block index within the vector's span.
+            std::vector<std::size_t> blocksLeft(ioSlots, 0);
+            std::size_t fillVector = 0;
+            std::size_t fillBlock = 0;
+            std::size_t consumed = 0;
+            bool ioFailed = false;
+            while (consumed < numVectors && !ioFailed) {
+                while (fillVector < numVectors && fillVector - consumed < ioSlots && reader.canSubmit()) {
+                    std::uint64_t spanBegin = 0;
+                    std::uint64_t spanEnd = 0;
+                    pairSpan(fillVector, spanBegin, spanEnd);
+                    const std::size_t spanBlocks = static_cast<std::size_t>((spanEnd - spanBegin + ioConfig.blockBytes - 1) / ioConfig.blockBytes);
+                    unsigned char* slotBase = ioPool + (fillVector % ioSlots) * ioSlotBytes;
+                    if (fillBlock == 0)
+                        blocksLeft[fillVector % ioSlots] = spanBlocks;
+                    const std::uint64_t blockOffset = fillBlock * ioConfig.blockBytes;
+                    const std::size_t length = static_cast<std::size_t>(std::min<std::uint64_t>(ioConfig.blockBytes, spanEnd - spanBegin - blockOffset));
+                    reader.submit(slotBase + blockOffset, length, spanBegin + blockOffset, (static_cast<std::uint64_t>(fillVector) << 24) | fillBlock);
+                    if (++fillBlock == spanBlocks) {
+                        ++fillVector;
+                        fillBlock = 0;
                     }
                 }
+
+                if (!reader.waitOne(completion)) {
+                    ioFailed = true;
+                    break;
+                }
+                const std::size_t v = static_cast<std::size_t>(completion.tag >> 24);
+                std::uint64_t spanBegin = 0;
+                std::uint64_t spanEnd = 0;
+                pairSpan(v, spanBegin, spanEnd);
+                const std::uint64_t blockOffset = spanBegin + (completion.tag & 0xffffffu) * ioConfig.blockBytes;
+                // Only the file's last block may come back short.
+                const std::uint64_t needed = std::min<std::uint64_t>(std::min<std::uint64_t>(ioConfig.blockBytes, spanEnd - blockOffset), fileBytes - blockOffset);
+                if (completion.result < static_cast<long long>(needed)) {
+                    ioFailed = true;
+                    break;
+                }
+                --blocksLeft[v % ioSlots];
+
+                while (consumed < fillVector && blocksLeft[consumed % ioSlots] == 0) {
+                    pairSpan(consumed, spanBegin, spanEnd);
+                    const unsigned char* slotBase = ioPool + (consumed % ioSlots) * ioSlotBytes;
+                    const double* inA = reinterpret_cast<const double*>(slotBase + (sizeof(InputHeader) + consumed * pairBytes - spanBegin));
+                    totalSum += dotKernel(inA, inA + vectorSize, vectorSize);
+                    ++consumed;
+                }
             }
+            if (ioFailed) {
+                std::cerr << "Async reader: read failed: " << inputFilePath << "\n";
+                exitCode = 4;
+                return 0.0;
+            }
+            readers = 1;
+            isa = dotBlockKernelName(dotKernel);
         }
-        omp_destroy_lock(&bufferLock);
-        omp_destroy_lock(&sumLock);
-    }
-    else {
-        std::cerr << "Unknown mode: " << mode << "\n";
-        return 6;
-    }
+        else if (mode == "mmap") {
+            MappedFile mapped;
+            InputHeader header {};
+            const bool mappedValid = mapped.open(inputFilePath, mmapPrefetch == "populate") && mapped.size() >= fileBytes;
+            if (mappedValid)
+                std::memcpy(&header, mapped.data(), sizeof(header));
+            if (!mappedValid || header.numVectors != static_cast<unsigned long long>(numVectors) || header.vectorSize != static_cast<unsigned long long>(vectorSize)) {
+                std::cerr << "Failed to map input file or header mismatch: " << inputFilePath << "\n";
+                exitCode = 4;
+                return 0.0;
+            }
+            if (mmapPrefetch == "sequential")
+                mapped.adviseSequential();
+            else if (mmapPrefetch == "willneed")
+                MappedFile::prefetch(mapped.data(), mapped.size());
+
+            const unsigned char* pairs = mapped.data() + sizeof(InputHeader);
+            #pragma omp parallel for schedule(static)
+            for (std::size_t v = 0; v < numVectors; ++v) {
+                const double* inA = reinterpret_cast<const double*>(pairs + v * pairBytes);
+                mappedVectorSums[v] = dotKernel(inA, inA + vectorSize, vectorSize);
+            }
+            for (double sum : mappedVectorSums)
+                totalSum += sum;
+            ioBackend = "mmap";
+            readers = 0;
+            workers = static_cast<std::size_t>(numThreadsReported);
+            isa = dotBlockKernelName(dotKernel);
+        }
+
+        auto timeEnd = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(timeEnd - timeStart).count();
+    };
 
-    auto timeEnd = std::chrono::high_resolution_clock::now();
-    double timeSeconds = std::chrono::duration<double>(timeEnd - timeStart).count();
+    BenchConfig coldConfig = benchConfig;
+    coldConfig.warmUpRuns = 0;
+    double coldResidentFraction = -1.0;
+    const BenchStats coldStats = runBenchmark(coldConfig, [&]() {
+        evictFileCache(inputFilePath);
+        coldResidentFraction = fileCacheResidency(inputFilePath);
+        return runOnce();
+    });
+    const BenchStats stats = runBenchmark(benchConfig, runOnce);
+    if (ioPool != nullptr)
+        numaFreeBytes(ioPool, ioSlots * ioSlotBytes);
+    if (exitCode != 0)
+        return exitCode;
 
-    std::cout << numVectors << "," << vectorSize << "," << numThreadsReported << "," << mode << "," << timeSeconds << "," << totalSum << std::endl;
+    const bool asyncMode = (mode == "async");
+    BenchRow row;
+    row.add("numVectors", numVectors).add("vectorSize", vectorSize).add("numThreads", numThreadsReported).add("mode", mode)
+        .add("timeSeconds", stats.median).add("totalSum", totalSum).add("ringCapacity", slotCount)
+        .add("producerSlotWaitSeconds", producerSlotWaitSeconds).add("consumerSlotWaitSeconds", consumerSlotWaitSeconds)
+        .add("ringSleeps", ringSleeps).add("readers", readers).add("workers", workers)
+        .add("reduction", (mode == "pipeline") ? reduction : std::string("ordered")).add("isa", isa)
+        .add("ioBackend", ioBackend).add("queueDepth", asyncMode ? ioConfig.queueDepth : 0)
+        .add("blockKiB", asyncMode ? ioConfig.blockBytes / 1024 : 0).add("direct", ioDirect ? 1 : 0)
+        .add("readGBs", (stats.median > 0.0) ? static_cast<double>(fileBytes) / stats.median / 1e9 : 0.0)
+        .add("mmapPrefetch", (mode == "mmap") ? mmapPrefetch : std::string("none"))
+        .add("coldSeconds", coldStats.median).add("coldResidentFraction", coldResidentFraction).addStats(stats);
+    row.print(std::cout, benchConfig);
 
     return 0;
 }
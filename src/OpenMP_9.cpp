@@ -1,19 +1,43 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <limits>
 #include <string>
 #include <omp.h>
 #include <algorithm>
 
-// Usage: OpenMP_9 <matrixSize> <mode> [innerThreads] [seed]
-// mode: outer | inner | nested
-// innerThreads: integer, only used for nested mode (default 1)
+#include "BenchHarness.hpp"
+#include "CounterRng.hpp"
+#include "NumaAllocator.hpp"
+#include "Partition.hpp"
+#include "PrunedRowMins.hpp"
+#include "SimdMin.hpp"
+
+// Usage: OpenMP_9 <matrixSize> <mode> [innerThreads] [seed] [rowGrain]
+// mode: outer | inner | nested | tiled | taskloop | pruned | pruned_sampled
+// innerThreads: nested: threads of each inner team; tiled, taskloop: column
+//               blocks per row (default 1)
+// tiled: one parallel region over tiles of rowGrain rows x one column block
+//        (static), then a second loop that takes each row's min over its
+//        column blocks and the max over rows
+// taskloop: the same two steps as taskloops with grainsize(rowGrain) from a
+//           single thread
+// pruned: branch and bound, a row is dropped once its running min falls below
+//         the best row min so far (see PrunedRowMins.hpp)
+// pruned_sampled: pruned, with rows ordered by the min of a few sampled elements
+// rowGrain: rows per tile / task (default 16)
+// elementsTouched: matrix elements read by the last run (samples included)
+// BENCH_* (env): warm-up, repetitions and output format, see BenchHarness.hpp
+// NUMA_POLICY (env): master | first_touch | interleave | bind (NUMA_BIND_NODE, default 0)
+// HUGE_PAGES (env): off | thp | 2m | 1g, page size of the matrix mapping, see
+//                   NumaAllocator.hpp; pageKiB and hugeFraction report what the
+//                   kernel backed it with after initialisation
+// SIMD_ISA (env): caps the row-min kernel's ISA (scalar | sse41 | avx2 | avx512),
+//                 see SimdMin.hpp; the isa column names the one used
 
 int main(int argc, char** argv) {
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <matrixSize> <mode> [innerThreads] [seed]\n";
+        std::cerr << "Usage: " << argv[0] << " <matrixSize> <mode> [innerThreads] [seed] [rowGrain]\n";
         return 1;
     }
 
@@ -21,43 +45,30 @@ int main(int argc, char** argv) {
     const std::string mode = argv[2];
     const int innerThreads = (argc >= 4) ? std::max(1, std::stoi(argv[3])) : 1;
     const unsigned int seed = (argc >= 5) ? static_cast<unsigned int>(std::stoul(argv[4])) : 12345u;
+    const std::size_t rowGrain = (argc >= 6) ? static_cast<std::size_t>(std::max(1, std::stoi(argv[5]))) : 16;
 
     if (matrixSize == 0) {
         std::cerr << "matrixSize must be > 0\n";
         return 2;
     }
-    if (mode != "outer" && mode != "inner" && mode != "nested") {
-        std::cerr << "Unknown mode: " << mode << " (use outer|inner|nested)\n";
+    if (mode != "outer" && mode != "inner" && mode != "nested" && mode != "tiled" && mode != "taskloop"
+        && mode != "pruned" && mode != "pruned_sampled") {
+        std::cerr << "Unknown mode: " << mode << " (use outer|inner|nested|tiled|taskloop|pruned|pruned_sampled)\n";
         return 3;
     }
 
-    std::vector<double> matrixData(matrixSize * matrixSize);
-    std::mt19937_64 generator(static_cast<unsigned long long>(seed));
-    std::uniform_real_distribution<double> distribution(0.0, 1.0e6);
-
-    for (std::size_t i = 0; i < matrixSize; ++i) {
-        const std::size_t rowOffset = i * matrixSize;
-        for (std::size_t j = 0; j < matrixSize; ++j) {
-            matrixData[rowOffset + j] = distribution(generator);
-        }
-    }
-
-    // Warm-up
-    {
-        volatile double warmUpSum = 0.0;
-        const std::size_t warmSteps = std::min<std::size_t>(matrixSize, static_cast<std::size_t>(8));
-        const std::size_t warmCols = std::min<std::size_t>(matrixSize, static_cast<std::size_t>(8));
-        for (std::size_t i = 0; i < warmSteps; ++i) {
-            const std::size_t rowOffset = i * matrixSize;
-            for (std::size_t j = 0; j < warmCols; ++j) {
-                warmUpSum += matrixData[rowOffset + j];
-            }
-        }
-        (void)warmUpSum;
-    }
+    const NumaPolicy numaPolicy = numaPolicyFromEnv();
+    const int numaBindNode = numaBindNodeFromEnv();
+    const HugePages hugePages = hugePagesFromEnv();
+    NumaVector<double> matrixData(NumaAllocator<double>(numaPolicy, numaBindNode, hugePages));
+    matrixData.resize(matrixSize * matrixSize);
+    initializeWithPolicy(numaPolicy, matrixSize, [&](std::size_t rowBegin, std::size_t rowEnd) {
+        fillUniformReal(matrixData.data() + rowBegin * matrixSize, rowBegin * matrixSize,
+            (rowEnd - rowBegin) * matrixSize, seed, 0, 0.0, 1.0e6);
+    });
+    const PageBacking backing = pageBacking(matrixData.data());
 
     const int numThreadsReported = omp_get_max_threads();
-    double globalMaxOfRowMins = std::numeric_limits<double>::lowest();
 
     if (mode == "nested") {
         omp_set_max_active_levels(2);
@@ -66,69 +77,157 @@ int main(int argc, char** argv) {
         omp_set_max_active_levels(1);
     }
 
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    if (mode == "outer") {
-        #pragma omp parallel for reduction(max:globalMaxOfRowMins) schedule(dynamic)
-        for (std::size_t i = 0; i < matrixSize; ++i) {
-            double localMin = std::numeric_limits<double>::max();
-            const std::size_t rowOffset = i * matrixSize;
-            for (std::size_t j = 0; j < matrixSize; ++j) {
-                double val = matrixData[rowOffset + j];
-                if (val < localMin)
-                    localMin = val;
+    // Row mins of every column block (block-major), written by the first step
+    // of tiled and taskloop and merged by the second.
+    const std::size_t columnBlocks = std::min(matrixSize, static_cast<std::size_t>(innerThreads));
+    std::vector<double> partialMins;
+    if (mode == "tiled" || mode == "taskloop")
+        partialMins.resize(columnBlocks * matrixSize);
+
+    const BenchConfig benchConfig = benchConfigFromEnv();
+    double globalMaxOfRowMins = std::numeric_limits<double>::lowest();
+    std::size_t elementsTouched = 0;
+
+    const SimdLevel simdLevel = selectSimdLevel();
+    const BenchStats stats = withMinKernel<double>(simdLevel, [&](auto kernel) {
+        using Kernel = decltype(kernel);
+        return runBenchmark(benchConfig, [&]() {
+            globalMaxOfRowMins = std::numeric_limits<double>::lowest();
+            elementsTouched = matrixSize * matrixSize;
+            auto startTime = std::chrono::high_resolution_clock::now();
+
+            if (mode == "outer") {
+                #pragma omp parallel for reduction(max:globalMaxOfRowMins) schedule(dynamic)
+                for (std::size_t i = 0; i < matrixSize; ++i) {
+                    const double localMin = Kernel::run(matrixData.data() + i * matrixSize, matrixSize);
+                    if (localMin > globalMaxOfRowMins)
+                        globalMaxOfRowMins = localMin;
+                }
             }
-            if (localMin > globalMaxOfRowMins)
-                globalMaxOfRowMins = localMin;
-        }
-    }
-    else if (mode == "inner") {
-        for (std::size_t i = 0; i < matrixSize; ++i) {
-            double localMin = std::numeric_limits<double>::max();
-            const std::size_t rowOffset = i * matrixSize;
-
-            #pragma omp parallel for reduction(min:localMin) schedule(static)
-            for (std::size_t j = 0; j < matrixSize; ++j) {
-                double val = matrixData[rowOffset + j];
-                if (val < localMin)
-                    localMin = val;
+            else if (mode == "inner") {
+                for (std::size_t i = 0; i < matrixSize; ++i) {
+                    double localMin = std::numeric_limits<double>::max();
+                    const double* rowData = matrixData.data() + i * matrixSize;
+
+                    // The static split of the columns, each block through the vector kernel.
+                    #pragma omp parallel reduction(min:localMin)
+                    {
+                        std::size_t begin = 0;
+                        std::size_t end = 0;
+                        staticBlockRange(matrixSize, static_cast<std::size_t>(omp_get_thread_num()),
+                            static_cast<std::size_t>(omp_get_num_threads()), begin, end);
+                        const double blockMin = Kernel::run(rowData + begin, end - begin);
+                        if (blockMin < localMin)
+                            localMin = blockMin;
+                    }
+
+                    #pragma omp critical
+                    {
+                        if (localMin > globalMaxOfRowMins)
+                            globalMaxOfRowMins = localMin;
+                    }
+                }
             }
-
-            #pragma omp critical
-            {
-                if (localMin > globalMaxOfRowMins)
-                    globalMaxOfRowMins = localMin;
+            else if (mode == "nested") {
+                #pragma omp parallel
+                {
+                    #pragma omp for schedule(dynamic)
+                    for (std::size_t i = 0; i < matrixSize; ++i) {
+                        double localMin = std::numeric_limits<double>::max();
+                        const double* rowData = matrixData.data() + i * matrixSize;
+
+                        #pragma omp parallel reduction(min:localMin) num_threads(innerThreads)
+                        {
+                            std::size_t begin = 0;
+                            std::size_t end = 0;
+                            staticBlockRange(matrixSize, static_cast<std::size_t>(omp_get_thread_num()),
+                                static_cast<std::size_t>(omp_get_num_threads()), begin, end);
+                            const double blockMin = Kernel::run(rowData + begin, end - begin);
+                            if (blockMin < localMin)
+                                localMin = blockMin;
+                        }
+
+                        #pragma omp critical
+                        {
+                            if (localMin > globalMaxOfRowMins)
+                                globalMaxOfRowMins = localMin;
+                        }
+                    }
+                }
             }
-        }
-    }
-    else { // nested
-        #pragma omp parallel
-        {
-            #pragma omp for schedule(dynamic)
-            for (std::size_t i = 0; i < matrixSize; ++i) {
-                double localMin = std::numeric_limits<double>::max();
-                const std::size_t rowOffset = i * matrixSize;
-
-                #pragma omp parallel for reduction(min:localMin) schedule(static) num_threads(innerThreads)
-                for (std::size_t j = 0; j < matrixSize; ++j) {
-                    double val = matrixData[rowOffset + j];
-                    if (val < localMin)
-                        localMin = val;
+            else if (mode == "tiled") {
+                const std::size_t rowTiles = (matrixSize + rowGrain - 1) / rowGrain;
+                #pragma omp parallel
+                {
+                    #pragma omp for collapse(2) schedule(static)
+                    for (std::size_t tile = 0; tile < rowTiles; ++tile) {
+                        for (std::size_t block = 0; block < columnBlocks; ++block) {
+                            std::size_t columnBegin = 0;
+                            std::size_t columnEnd = 0;
+                            staticBlockRange(matrixSize, block, columnBlocks, columnBegin, columnEnd);
+                            const std::size_t rowEnd = std::min(matrixSize, (tile + 1) * rowGrain);
+                            for (std::size_t i = tile * rowGrain; i < rowEnd; ++i)
+                                partialMins[block * matrixSize + i] = Kernel::run(matrixData.data() + i * matrixSize + columnBegin, columnEnd - columnBegin);
+                        }
+                    }
+
+                    #pragma omp for schedule(static) reduction(max:globalMaxOfRowMins)
+                    for (std::size_t i = 0; i < matrixSize; ++i) {
+                        double localMin = partialMins[i];
+                        for (std::size_t block = 1; block < columnBlocks; ++block)
+                            localMin = std::min(localMin, partialMins[block * matrixSize + i]);
+                        if (localMin > globalMaxOfRowMins)
+                            globalMaxOfRowMins = localMin;
+                    }
                 }
-
-                #pragma omp critical
+            }
+            else if (mode == "taskloop") {
+                #pragma omp parallel
                 {
-                    if (localMin > globalMaxOfRowMins)
-                        globalMaxOfRowMins = localMin;
+                    #pragma omp single
+                    {
+                        #pragma omp taskloop collapse(2) grainsize(rowGrain)
+                        for (std::size_t block = 0; block < columnBlocks; ++block) {
+                            for (std::size_t i = 0; i < matrixSize; ++i) {
+                                std::size_t columnBegin = 0;
+                                std::size_t columnEnd = 0;
+                                staticBlockRange(matrixSize, block, columnBlocks, columnBegin, columnEnd);
+                                partialMins[block * matrixSize + i] = Kernel::run(matrixData.data() + i * matrixSize + columnBegin, columnEnd - columnBegin);
+                            }
+                        }
+
+                        #pragma omp taskloop grainsize(rowGrain) reduction(max:globalMaxOfRowMins)
+                        for (std::size_t i = 0; i < matrixSize; ++i) {
+                            double localMin = partialMins[i];
+                            for (std::size_t block = 1; block < columnBlocks; ++block)
+                                localMin = std::min(localMin, partialMins[block * matrixSize + i]);
+                            if (localMin > globalMaxOfRowMins)
+                                globalMaxOfRowMins = localMin;
+                        }
+                    }
                 }
             }
-        }
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double timeSeconds = std::chrono::duration<double>(endTime - startTime).count();
+            else if (mode == "pruned" || mode == "pruned_sampled") {
+                elementsTouched = 0;
+                std::vector<std::size_t> rowOrder;
+                if (mode == "pruned_sampled")
+                    rowOrder = sampledRowOrder(matrixData.data(), matrixSize, matrixSize, elementsTouched);
+                globalMaxOfRowMins = prunedMaxOfRowMins<Kernel>(matrixData.data(), matrixSize, matrixSize,
+                    rowOrder.empty() ? nullptr : &rowOrder, elementsTouched);
+            }
 
-    std::cout << matrixSize << "," << numThreadsReported << "," << mode << "," << innerThreads << "," << timeSeconds << "," << globalMaxOfRowMins << std::endl;
+            auto endTime = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double>(endTime - startTime).count();
+        });
+    });
+
+    BenchRow row;
+    row.add("matrixSize", matrixSize).add("numThreads", numThreadsReported).add("mode", mode).add("innerThreads", innerThreads)
+        .add("timeSeconds", stats.median).add("maxOfRowMins", globalMaxOfRowMins).add("numaPolicy", numaPolicyName(numaPolicy))
+        .add("isa", simdLevelName(simdLevel)).add("rowGrain", rowGrain).add("elementsTouched", elementsTouched)
+        .add("hugePages", hugePagesName(hugePages)).add("pageKiB", backing.pageKiB).add("hugeFraction", backing.hugeFraction)
+        .addStats(stats);
+    row.print(std::cout, benchConfig);
 
     return 0;
 }